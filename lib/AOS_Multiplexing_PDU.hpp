@@ -58,6 +58,11 @@ public:
 	/// @param bufLen The amount of data to copy.
 	AOS_Multiplexing_PDU(const size_t bufLen, const ACE_UINT8* buffer = 0):
 		NetworkData(bufLen, buffer) { }
+
+	/// Allocate without zeroing; the caller must write the header and the entire Packet Zone.
+	/// @param bufLen The size of the M_PDU.
+	AOS_Multiplexing_PDU(const size_t bufLen, const NoFill):
+		NetworkData(bufLen, noFill) { }
 		
 	/// Copy constructor.
 	AOS_Multiplexing_PDU(const NetworkData* other, const bool doDeepCopy = true, 
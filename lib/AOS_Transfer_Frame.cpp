@@ -57,8 +57,10 @@ AOS_Transfer_Frame::AOS_Transfer_Frame(
 	const bool hasHeaderErrorControl /* = false */,
 	const unsigned inSduLen /* = 0 */,
 	const bool hasOperationalControl /* = false */,
-	const bool hasFrameErrorControl /* = false */):
-	NetworkData(bufLen, frameBuf),
+	const bool hasFrameErrorControl /* = false */,
+	const size_t headroom /* = 0 */,
+	const size_t tailroom /* = 0 */):
+	NetworkData(bufLen, frameBuf, headroom, tailroom),
 	_inSduLen(inSduLen),
 	_hasHeaderErrorControl(hasHeaderErrorControl),
 	_hasOperationalControl(hasOperationalControl),
@@ -97,8 +99,9 @@ void AOS_Transfer_Frame::initialize(
 
 	size_t required_size = getNonDataLength() + dataLen + getInSduLen();
 
-	if ( getBufferSize() != required_size ) clearBuffer(required_size);
-	else clearBuffer();
+	// Work on the unit rather than the buffer so any reserved headroom is kept.
+	if ( getUnitLength() != required_size ) clearUnit(required_size);
+	else clearUnit();
 
 	setInitialized_(true);
 
@@ -0,0 +1,270 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   AsmCorrelator.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "AsmCorrelator.hpp"
+
+#include <cstring>
+
+// POPCNT and AVX2 are chosen at run time, so they need per-function target attributes.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) ) && \
+	( __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) || defined(__clang__) )
+#define ASM_X86_TARGETS 1
+#include <immintrin.h>
+#endif
+
+namespace nasaCE {
+
+#ifdef ASM_X86_TARGETS
+/// Which optional instructions the CPU has, checked once at load time.
+struct CpuTargets {
+	bool popcnt;
+	bool avx2;
+
+	CpuTargets() {
+		__builtin_cpu_init();
+		popcnt = __builtin_cpu_supports("popcnt");
+		avx2 = __builtin_cpu_supports("avx2");
+	}
+};
+
+static const CpuTargets cpuTargets;
+
+/// Whether realign() uses AVX2; see AsmCorrelator::setUseAVX2().
+static bool useAVX2 = cpuTargets.avx2;
+#endif
+
+/// Read eight octets as a big-endian word.
+static inline ACE_UINT64 loadBE64(const ACE_UINT8* p) {
+	ACE_UINT64 word = 0;
+	for ( int i = 0; i < 8; ++i ) word = (word << 8) | p[i];
+	return word;
+}
+
+/// Write a word as eight big-endian octets.
+static inline void storeBE64(ACE_UINT8* p, ACE_UINT64 word) {
+	for ( int i = 7; i >= 0; --i ) {
+		p[i] = word & 0xff;
+		word >>= 8;
+	}
+}
+
+AsmCorrelator::AsmCorrelator():
+	_pattern(0),
+	_mask(0),
+	_patternBits(0),
+	_allowedBitErrors(0),
+	_acceptInverted(false),
+	_reg(0),
+	_older(0),
+	_validBits(0) {
+}
+
+void AsmCorrelator::setPattern(const ACE_UINT8* pattern, const std::size_t len) {
+	const std::size_t usedLen = ( len < maxPatternLen )? len : maxPatternLen;
+
+	_pattern = 0;
+	for ( std::size_t i = 0; i < usedLen; ++i ) _pattern = (_pattern << 8) | pattern[i];
+
+	_patternBits = usedLen * 8;
+	_mask = ( _patternBits == 64 )? ~static_cast<ACE_UINT64>(0) :
+		( static_cast<ACE_UINT64>(1) << _patternBits ) - 1;
+
+	reset();
+}
+
+void AsmCorrelator::reset() {
+	_reg = 0;
+	_older = 0;
+	_validBits = 0;
+}
+
+inline bool AsmCorrelator::search_(const ACE_UINT8* buf, const std::size_t len, Match& match) {
+	for ( std::size_t i = 0; i < len; ++i ) {
+		_older = _reg >> 56;
+		_reg = (_reg << 8) | buf[i];
+		_validBits = ( _validBits + 8 > 72 )? 72 : _validBits + 8;
+
+		// Try the earliest possible end first: the marker ends tail bits before the
+		// end of this octet, so it occupies the 8 - tail leading bits of the octet.
+		for ( int tail = 7; tail >= 0; --tail ) {
+			if ( _validBits < _patternBits + tail ) continue;
+
+			const ACE_UINT64 candidate = ( ( tail == 0 )? _reg :
+				( _reg >> tail ) | ( static_cast<ACE_UINT64>(_older) << (64 - tail) ) ) & _mask;
+			const unsigned errs = __builtin_popcountll(candidate ^ _pattern);
+			const bool normal = ( errs <= _allowedBitErrors );
+
+			if ( normal || ( _acceptInverted && _patternBits - errs <= _allowedBitErrors ) ) {
+				match.endOctet = i;
+				match.shift = (8 - tail) % 8;
+				match.inverted = ! normal;
+				match.bitErrors = normal? errs : _patternBits - errs;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+#ifdef ASM_X86_TARGETS
+__attribute__((target("popcnt")))
+#endif
+bool AsmCorrelator::searchPopcnt_(const ACE_UINT8* buf, const std::size_t len, Match& match) {
+	return search_(buf, len, match);
+}
+
+bool AsmCorrelator::searchGeneric_(const ACE_UINT8* buf, const std::size_t len, Match& match) {
+	return search_(buf, len, match);
+}
+
+bool AsmCorrelator::search(const ACE_UINT8* buf, const std::size_t len, Match& match) {
+	if ( _patternBits == 0 ) return false;
+
+	#ifdef ASM_X86_TARGETS
+	if ( cpuTargets.popcnt ) return searchPopcnt_(buf, len, match);
+	#endif
+
+	return searchGeneric_(buf, len, match);
+}
+
+unsigned AsmCorrelator::bitErrorsAt(const ACE_UINT8* buf, const std::size_t len,
+	const std::size_t bitOffset, const bool inverted) const {
+
+	if ( _patternBits == 0 ) return 0;
+
+	const std::size_t first = bitOffset / 8;
+	const unsigned bit = bitOffset % 8;
+	ACE_UINT64 window = 0;
+
+	for ( std::size_t k = 0; k < 8; ++k ) window = (window << 8) | ( ( first + k < len )? buf[first + k] : 0 );
+	if ( bit ) window = (window << bit) | ( ( first + 8 < len )? buf[first + 8] >> (8 - bit) : 0 );
+
+	const unsigned errs = __builtin_popcountll(( window >> (64 - _patternBits) ) ^ _pattern);
+
+	return inverted? _patternBits - errs : errs;
+}
+
+unsigned AsmCorrelator::countBitErrors(const ACE_UINT8* a, const ACE_UINT8* b, const std::size_t len) {
+	unsigned errs = 0;
+	std::size_t i = 0;
+
+	for ( ; i + 8 <= len; i += 8 ) {
+		ACE_UINT64 wordA, wordB;
+		std::memcpy(&wordA, a + i, 8);
+		std::memcpy(&wordB, b + i, 8);
+		errs += __builtin_popcountll(wordA ^ wordB);
+	}
+
+	for ( ; i < len; ++i ) errs += __builtin_popcount(a[i] ^ b[i]);
+
+	return errs;
+}
+
+#ifdef ASM_X86_TARGETS
+/// @brief The funnel shift of realign() for 32 octets per iteration, with shift from 1 to 7.
+/// Each octet's predecessor is assembled in registers, so dst may be src.
+/// @return The number of octets done; the caller finishes the rest.
+__attribute__((target("avx2")))
+static std::size_t realignAVX2(ACE_UINT8* dst, const ACE_UINT8* src, const std::size_t len,
+	const unsigned shift, const bool invert, ACE_UINT8& carry) {
+
+	if ( len < 32 ) return 0;
+
+	const __m128i leftCount = _mm_cvtsi32_si128(shift);
+	const __m128i rightCount = _mm_cvtsi32_si128(8 - shift);
+	const __m256i highMask = _mm256_set1_epi8(static_cast<char>(0xff << shift));
+	const __m256i lowMask = _mm256_set1_epi8(static_cast<char>(0xff >> (8 - shift)));
+	const __m256i flip = _mm256_set1_epi8(invert? -1 : 0);
+	__m256i last = _mm256_insert_epi8(_mm256_setzero_si256(), static_cast<char>(carry), 31);
+	std::size_t i = 0;
+
+	for ( ; i + 32 <= len; i += 32 ) {
+		const __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+
+		// prev holds the octet before each one in cur: last[31], cur[0], ..., cur[30].
+		const __m256i prev = _mm256_alignr_epi8(cur, _mm256_permute2x128_si256(last, cur, 0x21), 15);
+
+		// There are no 8-bit shifts, so shift 16-bit lanes and mask off what crossed octets.
+		const __m256i high = _mm256_and_si256(_mm256_sll_epi16(prev, leftCount), highMask);
+		const __m256i low = _mm256_and_si256(_mm256_srl_epi16(cur, rightCount), lowMask);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+			_mm256_xor_si256(_mm256_or_si256(high, low), flip));
+		last = cur;
+	}
+
+	carry = static_cast<ACE_UINT8>(_mm256_extract_epi8(last, 31));
+	return i;
+}
+#endif
+
+bool AsmCorrelator::getUseAVX2() {
+	#ifdef ASM_X86_TARGETS
+	return useAVX2;
+	#else
+	return false;
+	#endif
+}
+
+void AsmCorrelator::setUseAVX2(const bool newVal) {
+	#ifdef ASM_X86_TARGETS
+	useAVX2 = newVal && cpuTargets.avx2;
+	#endif
+}
+
+void AsmCorrelator::realign(ACE_UINT8* dst, const ACE_UINT8* src, const std::size_t len,
+	const unsigned shift, const bool invert, ACE_UINT8& carry) {
+
+	if ( len == 0 ) return;
+
+	const ACE_UINT64 flip = invert? ~static_cast<ACE_UINT64>(0) : 0;
+	std::size_t i = 0;
+
+	// Every word and octet is read before its place in dst is written.
+	if ( shift == 0 ) {
+		carry = src[len - 1];
+
+		for ( ; i + 8 <= len; i += 8 ) {
+			ACE_UINT64 word;
+			std::memcpy(&word, src + i, 8);
+			word ^= flip;
+			std::memcpy(dst + i, &word, 8);
+		}
+
+		for ( ; i < len; ++i ) dst[i] = src[i] ^ static_cast<ACE_UINT8>(flip);
+
+		return;
+	}
+
+	#ifdef ASM_X86_TARGETS
+	if ( useAVX2 ) i = realignAVX2(dst, src, len, shift, invert, carry);
+	#endif
+
+	// Funnel shift: the low bits of the previous octet become the high bits of the output.
+	for ( ; i + 8 <= len; i += 8 ) {
+		const ACE_UINT64 word = loadBE64(src + i);
+		storeBE64(dst + i, ( ( static_cast<ACE_UINT64>(carry) << (56 + shift) ) |
+			( word >> (8 - shift) ) ) ^ flip);
+		carry = word & 0xff;
+	}
+
+	for ( ; i < len; ++i ) {
+		const ACE_UINT8 cur = src[i];
+		dst[i] = ( ( carry << shift ) | ( cur >> (8 - shift) ) ) ^ static_cast<ACE_UINT8>(flip);
+		carry = cur;
+	}
+}
+
+} // namespace nasaCE
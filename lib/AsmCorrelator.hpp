@@ -0,0 +1,166 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   AsmCorrelator.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _NASA_ASM_CORRELATOR_HPP_
+#define _NASA_ASM_CORRELATOR_HPP_
+
+#include <ace/Basic_Types.h>
+#include <cstddef>
+
+namespace nasaCE {
+
+//=============================================================================
+/**
+ * @class AsmCorrelator
+ * @brief Find a sync marker at any bit offset in a stream of octets.
+ *
+ * Each octet is shifted into a 64-bit register, then all eight bit positions
+ * the marker could end at within that octet are compared against it with a
+ * single popcount each. The same count also tests the complemented marker,
+ * as seen after a 180-degree phase ambiguity. The register carries over
+ * between calls, so a marker split across two buffers is still found.
+ *
+ * Only the first maxPatternLen octets of a longer marker are correlated;
+ * the caller checks the rest once the stream has been realigned.
+ */
+//=============================================================================
+class AsmCorrelator {
+public:
+	/// The most octets of the marker that are correlated.
+	static const std::size_t maxPatternLen = 8;
+
+	/// Where and how a marker was found.
+	struct Match {
+		/// Index in the searched buffer of the octet holding the last marker bit.
+		std::size_t endOctet;
+
+		/// The number of bits of that octet belonging to the marker, modulo 8.
+		/// Zero means the data after the marker is already octet-aligned.
+		unsigned shift;
+
+		/// True if the complement of the marker was found.
+		bool inverted;
+
+		/// The number of bits that differed from the marker (or its complement).
+		unsigned bitErrors;
+	};
+
+	/// Default constructor.
+	AsmCorrelator();
+
+	/// @brief Set the marker to look for, and forget the stream history.
+	/// @param pattern The marker octets.
+	/// @param len The full marker length; only the first maxPatternLen octets are used.
+	void setPattern(const ACE_UINT8* pattern, const std::size_t len);
+
+	/// The number of marker octets being correlated.
+	std::size_t getPatternLen() const { return _patternBits / 8; }
+
+	/// Set the most bit errors a candidate can have and still match.
+	void setAllowedBitErrors(const unsigned newVal) { _allowedBitErrors = newVal; }
+
+	/// Read-only accessor to _allowedBitErrors.
+	unsigned getAllowedBitErrors() const { return _allowedBitErrors; }
+
+	/// Set whether the complement of the marker is also accepted; off by default.
+	void setAcceptInverted(const bool newVal) { _acceptInverted = newVal; }
+
+	/// Read-only accessor to _acceptInverted.
+	bool getAcceptInverted() const { return _acceptInverted; }
+
+	/// Forget all previously searched bits; used when the stream is no longer contiguous.
+	void reset();
+
+	/// @brief Shift octets from buf into the register until a marker is complete.
+	/// Octets after match.endOctet have not been examined.
+	/// @param buf The octets to search.
+	/// @param len The number of octets in buf.
+	/// @param match Receives the location of the marker, if found.
+	/// @return True if a marker was found.
+	bool search(const ACE_UINT8* buf, const std::size_t len, Match& match);
+
+	/// @brief Compare the correlated part of the marker with the stream at one position.
+	/// The stream history used by search() is neither used nor changed.
+	/// @param buf The octets to look in.
+	/// @param len The number of octets in buf.
+	/// @param bitOffset Where the marker would start, counting from the first bit of buf.
+	/// Bits past the end of buf are taken to be zero.
+	/// @param inverted Compare with the complement of the marker instead.
+	/// @return The number of differing bits.
+	unsigned bitErrorsAt(const ACE_UINT8* buf, const std::size_t len, const std::size_t bitOffset,
+		const bool inverted) const;
+
+	/// @brief Count the bits that differ between two buffers.
+	/// @param a The first buffer.
+	/// @param b The second buffer.
+	/// @param len The number of octets to compare.
+	static unsigned countBitErrors(const ACE_UINT8* a, const ACE_UINT8* b, const std::size_t len);
+
+	/// @brief Copy octets, moving every bit earlier by shift places.
+	/// The first output octet begins with the low 8 - shift bits of carry.
+	/// Successive calls continue the same bit stream. Uses AVX2 if the CPU has it.
+	/// @param dst Receives len realigned octets; may be src itself, but no other overlap.
+	/// @param src The octets as received.
+	/// @param len The number of octets to read and to write.
+	/// @param shift 0 to 7; with 0, src is copied as-is and carry is not used.
+	/// @param invert If true, every output bit is complemented.
+	/// @param carry The octet before src on entry, the last octet of src on return.
+	static void realign(ACE_UINT8* dst, const ACE_UINT8* src, const std::size_t len,
+		const unsigned shift, const bool invert, ACE_UINT8& carry);
+
+	/// True if realign() is using AVX2. Initially true whenever the CPU has it.
+	static bool getUseAVX2();
+
+	/// @brief Allow or forbid AVX2 in realign(), e.g. to compare it with the portable code.
+	/// @param newVal Ignored if true but the CPU lacks AVX2.
+	static void setUseAVX2(const bool newVal);
+
+private:
+	/// The correlated part of the marker, right-justified.
+	ACE_UINT64 _pattern;
+
+	/// Selects the low _patternBits of a candidate.
+	ACE_UINT64 _mask;
+
+	/// The number of marker bits correlated.
+	unsigned _patternBits;
+
+	/// The most differing bits accepted.
+	unsigned _allowedBitErrors;
+
+	/// Whether to also match the complemented marker.
+	bool _acceptInverted;
+
+	/// The most recent 64 bits, with the newest in the low bit.
+	ACE_UINT64 _reg;
+
+	/// The 8 bits shifted out of _reg most recently.
+	ACE_UINT8 _older;
+
+	/// How many bits of _older and _reg hold real stream data, up to 72.
+	unsigned _validBits;
+
+	/// The correlation loop, compiled once per popcount implementation.
+	inline bool search_(const ACE_UINT8* buf, const std::size_t len, Match& match);
+
+	/// search_() built to use the POPCNT instruction.
+	bool searchPopcnt_(const ACE_UINT8* buf, const std::size_t len, Match& match);
+
+	/// search_() built for any CPU.
+	bool searchGeneric_(const ACE_UINT8* buf, const std::size_t len, Match& match);
+};
+
+} // namespace nasaCE
+
+#endif // _NASA_ASM_CORRELATOR_HPP_
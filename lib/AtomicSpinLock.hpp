@@ -0,0 +1,74 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   AtomicSpinLock.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _NASA_ATOMIC_SPIN_LOCK_HPP_
+#define _NASA_ATOMIC_SPIN_LOCK_HPP_
+
+#include <ace/Lock.h>
+#include <ace/OS_NS_Thread.h>
+
+namespace nasaCE {
+
+//=============================================================================
+/**
+ * @class AtomicSpinLock
+ * @brief An ACE_Lock implemented with a single atomic flag.
+ *
+ * Meant for critical sections only a few instructions long, such as
+ * adjusting a reference count, where a kernel-backed lock would cost far
+ * more than the work it protects. Never sleeps; yields the CPU if the
+ * flag has been held through a short spin.
+ */
+//=============================================================================
+class AtomicSpinLock: public ACE_Lock {
+public:
+	AtomicSpinLock(): flag_(0) { }
+
+	virtual ~AtomicSpinLock() { }
+
+	virtual int remove() { return 0; }
+
+	virtual int acquire() {
+		unsigned spins = 0;
+
+		while ( __sync_lock_test_and_set(&flag_, 1) ) {
+			while ( flag_ ) {
+				if ( ++spins > 1000 ) { ACE_OS::thr_yield(); spins = 0; }
+			}
+		}
+
+		return 0;
+	}
+
+	virtual int tryacquire() { return __sync_lock_test_and_set(&flag_, 1)? -1 : 0; }
+
+	virtual int release() { __sync_lock_release(&flag_); return 0; }
+
+	virtual int acquire_read() { return acquire(); }
+
+	virtual int acquire_write() { return acquire(); }
+
+	virtual int tryacquire_read() { return tryacquire(); }
+
+	virtual int tryacquire_write() { return tryacquire(); }
+
+	virtual int tryacquire_write_upgrade() { return 0; }
+
+private:
+	volatile int flag_;
+};
+
+} // namespace nasaCE
+
+#endif // _NASA_ATOMIC_SPIN_LOCK_HPP_
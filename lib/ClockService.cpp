@@ -0,0 +1,87 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   ClockService.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "ClockService.hpp"
+
+#include <time.h>
+
+// Fall back to the regular monotonic clock where the coarse one is unavailable.
+#ifndef CLOCK_MONOTONIC_COARSE
+#define CLOCK_MONOTONIC_COARSE CLOCK_MONOTONIC
+#endif
+
+namespace nasaCE {
+
+static inline ACE_INT64 readNsec_(const clockid_t clockId) {
+	timespec ts;
+	clock_gettime(clockId, &ts);
+	return static_cast<ACE_INT64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+ClockService::ClockService(): precision_(Precise), offsetNsec_(0), nextResyncNsec_(0), lastNsec_(0) {
+	resync();
+}
+
+ClockService* ClockService::instance() {
+	// Deliberately leaked: NetworkData time stamps may be taken during shutdown.
+	static ClockService* clock = new ClockService();
+	return clock;
+}
+
+std::string ClockService::getPrecisionStr() const {
+	return ( precision_ == Coarse )? "coarse" : "precise";
+}
+
+void ClockService::setPrecision(const std::string& newVal) {
+	if ( newVal == "precise" ) setPrecision(Precise);
+	else if ( newVal == "coarse" ) setPrecision(Coarse);
+	else throw BadValue(BadValue::msg("Clock precision", newVal));
+}
+
+void ClockService::resync() {
+	// Bracket the wall clock read with two monotonic reads and use the
+	// midpoint, which keeps the offset error to half of the read time.
+	const ACE_INT64 monoBefore = readNsec_(CLOCK_MONOTONIC);
+	const ACE_INT64 wall = readNsec_(CLOCK_REALTIME);
+	const ACE_INT64 monoAfter = readNsec_(CLOCK_MONOTONIC);
+	const ACE_INT64 mono = monoBefore + (monoAfter - monoBefore) / 2;
+
+	offsetNsec_ = wall - mono;
+	nextResyncNsec_ = monoAfter + resyncIntervalNsec;
+}
+
+ACE_INT64 ClockService::readClock_(const bool coarse) {
+	const ACE_INT64 mono = readNsec_(coarse? CLOCK_MONOTONIC_COARSE : CLOCK_MONOTONIC);
+	const ACE_INT64 dueAt = nextResyncNsec_;
+
+	// Only the thread that successfully pushes the deadline back does the resync.
+	if ( mono >= dueAt &&
+		__sync_bool_compare_and_swap(&nextResyncNsec_, dueAt, mono + resyncIntervalNsec) ) {
+		resync();
+	}
+
+	const ACE_INT64 nsec = mono + offsetNsec_;
+
+	// Keep the latest time returned, unless another thread has already returned a later one.
+	ACE_INT64 last = lastNsec_;
+	while ( nsec > last ) {
+		const ACE_INT64 seen = __sync_val_compare_and_swap(&lastNsec_, last, nsec);
+		if ( seen == last ) return nsec;
+		last = seen;
+	}
+
+	return last;
+}
+
+} // namespace nasaCE
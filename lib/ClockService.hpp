@@ -0,0 +1,115 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   ClockService.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _NASA_CLOCK_SERVICE_HPP_
+#define _NASA_CLOCK_SERVICE_HPP_
+
+#include "nd_error.hpp"
+#include <ace/Basic_Types.h>
+#include <ace/Time_Value.h>
+#include <string>
+
+namespace nasaCE {
+
+//=============================================================================
+/**
+ * @class ClockService
+ * @brief A process-wide source of time stamps that never goes backwards.
+ *
+ * Times are read from the monotonic clock, which the kernel serves from the
+ * vDSO without a system call, and shifted into the wall clock epoch so they
+ * can still be mixed with absolute ACE timeouts and deadlines. The offset
+ * between the two clocks is recomputed once per resync interval so that a
+ * stepped system clock is eventually followed. A resync can move the offset
+ * backwards, so every read is clamped to the latest time already returned;
+ * after the wall clock steps back, time stands still until it catches up.
+ *
+ * now() honors the configured precision and is meant for per-unit time
+ * stamps. preciseNow() always has nanosecond resolution and is meant for
+ * anything that schedules or sleeps.
+ */
+//=============================================================================
+class ClockService {
+public:
+	/// How now() trades resolution for cost.
+	enum Precision {
+		Precise, ///< Nanosecond resolution.
+		Coarse   ///< Resolution of the kernel tick (1-10 ms); cheapest possible read.
+	};
+
+	/// How often to recompute the wall clock offset, in nanoseconds.
+	static const ACE_INT64 resyncIntervalNsec = 1000000000LL;
+
+	/// @brief The process-wide clock.
+	/// Never destroyed, so it remains usable while static destructors run.
+	static ClockService* instance();
+
+	/// The current time, in the resolution chosen by setPrecision().
+	ACE_Time_Value now() { return nsecToTimeValue(nowNsec()); }
+
+	/// The current time in nanoseconds since the epoch, in the configured resolution.
+	ACE_INT64 nowNsec() { return readClock_(precision_ == Coarse); }
+
+	/// The current time with full resolution, regardless of the precision setting.
+	ACE_Time_Value preciseNow() { return nsecToTimeValue(preciseNowNsec()); }
+
+	/// The current time in nanoseconds since the epoch with full resolution.
+	ACE_INT64 preciseNowNsec() { return readClock_(false); }
+
+	/// Read-only accessor to precision_.
+	Precision getPrecision() const { return static_cast<Precision>(precision_); }
+
+	/// Write-only accessor to precision_.
+	void setPrecision(const Precision newVal) { precision_ = newVal; }
+
+	/// Return the name of the current precision, "precise" or "coarse".
+	std::string getPrecisionStr() const;
+
+	/// @brief Set the precision from its name.
+	/// @param newVal Either "precise" or "coarse".
+	/// @throw BadValue If the name is not recognized.
+	void setPrecision(const std::string& newVal);
+
+	/// Recompute the offset between the monotonic and wall clocks immediately.
+	void resync();
+
+	/// Convert nanoseconds to an ACE_Time_Value, dropping sub-microsecond digits.
+	static ACE_Time_Value nsecToTimeValue(const ACE_INT64 nsec) {
+		return ACE_Time_Value(static_cast<time_t>(nsec / 1000000000LL),
+			static_cast<suseconds_t>((nsec % 1000000000LL) / 1000));
+	}
+
+private:
+	ClockService();
+
+	/// One of the values from the Precision enum.
+	volatile int precision_;
+
+	/// Nanoseconds to add to the monotonic clock to get wall clock time.
+	volatile ACE_INT64 offsetNsec_;
+
+	/// The monotonic time, in nanoseconds, after which the offset is recomputed.
+	volatile ACE_INT64 nextResyncNsec_;
+
+	/// The latest time returned by readClock_(), in nanoseconds since the epoch.
+	volatile ACE_INT64 lastNsec_;
+
+	/// Read the monotonic clock and convert it to wall clock time, never earlier than the last read.
+	/// @param coarse Whether the cheaper, tick-resolution clock can be used.
+	ACE_INT64 readClock_(const bool coarse);
+};
+
+} // namespace nasaCE
+
+#endif // _NASA_CLOCK_SERVICE_HPP_
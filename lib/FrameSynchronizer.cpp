@@ -0,0 +1,94 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   FrameSynchronizer.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "FrameSynchronizer.hpp"
+#include "nd_macros.hpp"
+
+namespace nasaCE {
+
+FrameSynchronizer::FrameSynchronizer():
+	_checkThreshold(1),
+	_flywheelThreshold(2),
+	_state(Search),
+	_stateRunLength(0),
+	_searchCount(0),
+	_lockCount(0),
+	_lockLossCount(0),
+	_flywheelCount(0) {
+}
+
+void FrameSynchronizer::setMarker(const ACE_UINT8* marker, const std::size_t len) {
+	_marker.assign(marker, marker + len);
+	_correlator.setPattern(marker, len);
+	startSearch();
+}
+
+std::string FrameSynchronizer::getStateName() const {
+	switch (_state) {
+		case Search: return "SEARCH";
+		case Check: return "CHECK";
+		case Lock: return "LOCK";
+		case Flywheel: return "FLYWHEEL";
+	}
+
+	return "UNKNOWN";
+}
+
+void FrameSynchronizer::startSearch() {
+	_state = Search;
+	_stateRunLength = 0;
+	_correlator.reset();
+	++_searchCount;
+}
+
+void FrameSynchronizer::markerFound(const bool discovered) {
+	if ( discovered ) {
+		_state = Check;
+		_stateRunLength = 0;
+	}
+	else if ( _state == Check ) {
+		++_stateRunLength;
+	}
+	else {
+		_state = Lock;
+		_stateRunLength = 0;
+	}
+
+	if ( _state == Check && _stateRunLength >= _checkThreshold ) {
+		ND_DEBUG("Synchronizer locked.\n");
+		_state = Lock;
+		_stateRunLength = 0;
+		++_lockCount;
+	}
+}
+
+bool FrameSynchronizer::markerMissed() {
+	if ( _state == Lock || _state == Flywheel ) {
+		if ( _state == Lock ) _stateRunLength = 0;
+
+		if ( ++_stateRunLength <= _flywheelThreshold ) {
+			ND_DEBUG("Flywheeling past missed ASM %d of %d.\n", _stateRunLength, _flywheelThreshold);
+			_state = Flywheel;
+			++_flywheelCount;
+			return true;
+		}
+
+		ND_DEBUG("Lost lock after %d missed ASMs.\n", _stateRunLength);
+		++_lockLossCount;
+	}
+
+	return false;
+}
+
+} // namespace nasaCE
@@ -0,0 +1,158 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   FrameSynchronizer.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _NASA_FRAME_SYNCHRONIZER_HPP_
+#define _NASA_FRAME_SYNCHRONIZER_HPP_
+
+#include "AsmCorrelator.hpp"
+
+#include <ace/Basic_Types.h>
+#include <string>
+#include <vector>
+
+namespace nasaCE {
+
+//=============================================================================
+/**
+ * @class FrameSynchronizer
+ * @brief The marker and SEARCH/CHECK/LOCK/FLYWHEEL states of a frame synchronizer.
+ *
+ * In SEARCH the stream is correlated against the marker at every bit offset.
+ * A marker found that way moves to CHECK, and after checkThreshold more markers
+ * exactly where expected, to LOCK. In LOCK a missed marker moves to FLYWHEEL,
+ * where the frame is still extracted at its expected position; up to
+ * flywheelThreshold consecutive misses are tolerated before returning to SEARCH.
+ * A miss in CHECK returns to SEARCH at once.
+ *
+ * The owner reads the stream and tells the synchronizer what it found with
+ * markerFound() and markerMissed(); the synchronizer decides what state that
+ * leaves it in.
+ */
+//=============================================================================
+class FrameSynchronizer {
+public:
+	/// The synchronizer states.
+	enum State {
+		Search,		///< Correlating at every bit offset.
+		Check,		///< Found a marker, confirming it with the ones that follow.
+		Lock,		///< Markers are where expected.
+		Flywheel	///< Locked but missing markers; frames are still extracted.
+	};
+
+	/// Default constructor.
+	FrameSynchronizer();
+
+	/// @brief Set the marker to look for, and begin searching for it.
+	/// @param marker The marker octets.
+	/// @param len The number of octets in marker.
+	void setMarker(const ACE_UINT8* marker, const std::size_t len);
+
+	/// The marker, as given to setMarker().
+	const std::vector<ACE_UINT8>& getMarker() const { return _marker; }
+
+	/// The number of octets in the marker.
+	std::size_t getMarkerLen() const { return _marker.size(); }
+
+	/// The correlator used while searching, set up with the marker.
+	AsmCorrelator& getCorrelator() { return _correlator; }
+
+	/// Set the number of markers that must follow a discovered one before locking.
+	void setCheckThreshold(const int newVal) { _checkThreshold = newVal; }
+
+	/// Read-only accessor to _checkThreshold.
+	int getCheckThreshold() const { return _checkThreshold; }
+
+	/// Set the number of consecutive missed markers tolerated once locked.
+	void setFlywheelThreshold(const int newVal) { _flywheelThreshold = newVal; }
+
+	/// Read-only accessor to _flywheelThreshold.
+	int getFlywheelThreshold() const { return _flywheelThreshold; }
+
+	/// Read-only accessor to _state.
+	State getState() const { return _state; }
+
+	/// The name of the current state.
+	std::string getStateName() const;
+
+	/// Move to SEARCH and forget the correlator's stream history.
+	void startSearch();
+
+	/// @brief Advance the state after a complete marker was matched.
+	/// @param discovered True if it was found by a search rather than where expected.
+	void markerFound(const bool discovered);
+
+	/// @brief Advance the state after a marker was not where expected.
+	/// The owner calls startSearch() if it returns false.
+	/// @return True to flywheel past it, false to return to SEARCH.
+	bool markerMissed();
+
+	/// Write-only accessor to _searchCount.
+	void setSearchCount(const ACE_UINT64& newVal) { _searchCount = newVal; }
+
+	/// Read-only accessor to _searchCount.
+	ACE_UINT64 getSearchCount() const { return _searchCount; }
+
+	/// Write-only accessor to _lockCount.
+	void setLockCount(const ACE_UINT64& newVal) { _lockCount = newVal; }
+
+	/// Read-only accessor to _lockCount.
+	ACE_UINT64 getLockCount() const { return _lockCount; }
+
+	/// Write-only accessor to _lockLossCount.
+	void setLockLossCount(const ACE_UINT64& newVal) { _lockLossCount = newVal; }
+
+	/// Read-only accessor to _lockLossCount.
+	ACE_UINT64 getLockLossCount() const { return _lockLossCount; }
+
+	/// Write-only accessor to _flywheelCount.
+	void setFlywheelCount(const ACE_UINT64& newVal) { _flywheelCount = newVal; }
+
+	/// Read-only accessor to _flywheelCount.
+	ACE_UINT64 getFlywheelCount() const { return _flywheelCount; }
+
+private:
+	/// The marker to look for.
+	std::vector<ACE_UINT8> _marker;
+
+	/// Finds the marker at any bit offset while searching.
+	AsmCorrelator _correlator;
+
+	/// Markers that must follow a discovered one before locking.
+	int _checkThreshold;
+
+	/// Consecutive missed markers tolerated once locked.
+	int _flywheelThreshold;
+
+	/// The current state.
+	State _state;
+
+	/// Markers verified in CHECK, or consecutive misses in FLYWHEEL.
+	int _stateRunLength;
+
+	/// The number of times SEARCH was entered.
+	ACE_UINT64 _searchCount;
+
+	/// The number of times LOCK was entered from CHECK.
+	ACE_UINT64 _lockCount;
+
+	/// The number of times LOCK or FLYWHEEL fell back to SEARCH.
+	ACE_UINT64 _lockLossCount;
+
+	/// The number of missed markers passed over in FLYWHEEL.
+	ACE_UINT64 _flywheelCount;
+};
+
+} // namespace nasaCE
+
+#endif // _NASA_FRAME_SYNCHRONIZER_HPP_
@@ -19,7 +19,7 @@ namespace nasaCE {
 void HdlcFrame::setData(NetworkData* data, const bool resize) {
 	ACE_TRACE("HdlcFrame::setData");
 	
-	if (resize) { setBufferSize(nonDataLength() + data->getBufferSize()); }
+	if (resize) { setBufferSize(nonDataLength() + data->getUnitLength()); }
 	copyUnit(dataPtr(), data->ptrUnit(), data->getUnitLength());	
 }
 
@@ -33,7 +33,7 @@ void HdlcFrame::build(const ACE_UINT8 addressLen, const ACE_UINT16 address,
 	setAddressLength_(addressLen);
 	setControlLength_(controlLen);
 	setFCSLength_(fcsLen);
-	clearBuffer(nonDataLength() + data->getBufferSize());
+	clearBuffer(nonDataLength() + data->getUnitLength());
 	setInitialized_(true);
 
 	*startFlagPtr() = flagVal;
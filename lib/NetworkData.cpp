@@ -14,26 +14,55 @@
 
 #include "nd_macros.hpp"
 #include "NetworkData.hpp"
+#include "ClockService.hpp"
+#include "NetworkDataPool.hpp"
 #include "utils.hpp"
 
+#include "AtomicSpinLock.hpp"
+
 #include <ace/Lock.h>
-#include <ace/Lock_Adapter_T.h>
 #include <ace/Log_Msg.h>
-#include <ace/Thread_Semaphore.h>
 #include <iostream>
 #include <iomanip>
+#include <new>
 
 namespace nasaCE {
 
 // ACE_Lock* NetworkData::lockingStrategy = 0;
 
-NetworkData::NetworkData(): ACE_Message_Block(/* allocator*/ ), _isInitialized(false) {
+/// @brief The locking strategy for a data block that has been shared.
+/// Only guards ACE's reference count, so a spin lock is much cheaper than
+/// a semaphore. Blocks are hashed by address onto a fixed table of locks,
+/// so unrelated units rarely contend. release() lets go of each part of a
+/// chain separately, so a thread never holds two of these at once. Never
+/// destroyed, since blocks may be released after static destructors have run.
+static ACE_Lock* sharedBlockLock(const ACE_Data_Block* block) {
+	static const size_t lockCount = 64;
+
+	// Keep each lock on its own cache line.
+	struct PaddedLock {
+		AtomicSpinLock lock;
+		char pad[64 - sizeof(AtomicSpinLock) % 64];
+	};
+
+	static PaddedLock* locks = new PaddedLock[lockCount];
+
+	// Blocks come from the pool at least 16-byte aligned; fold in higher bits too.
+	const size_t addr = reinterpret_cast<size_t>(block);
+	return &locks[((addr >> 4) ^ (addr >> 12)) % lockCount].lock;
+}
+
+NetworkData::NetworkData(): ACE_Message_Block(0, MB_DATA, 0, 0, NetworkDataPool::instance(), 0,
+	ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY, ACE_Time_Value::zero, ACE_Time_Value::max_time,
+	NetworkDataPool::instance()), _isInitialized(false) {
 	setTimeStamp();
 	data_block()->locking_strategy(0);
 }
 
 NetworkData::NetworkData(const size_t bufferSize, const ACE_UINT8* buffer /* = 0 */ ):
-	ACE_Message_Block(bufferSize),
+	ACE_Message_Block(bufferSize, MB_DATA, 0, 0, NetworkDataPool::instance(), 0,
+		ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY, ACE_Time_Value::zero, ACE_Time_Value::max_time,
+		NetworkDataPool::instance()),
 	_isInitialized(true) {
 
 	setTimeStamp();
@@ -49,24 +78,49 @@ NetworkData::NetworkData(const size_t bufferSize, const ACE_UINT8* buffer /* = 0
 	wr_ptr(end());
 }
 
+NetworkData::NetworkData(const size_t bufferSize, const NoFill):
+	ACE_Message_Block(bufferSize, MB_DATA, 0, 0, NetworkDataPool::instance(), 0,
+		ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY, ACE_Time_Value::zero, ACE_Time_Value::max_time,
+		NetworkDataPool::instance()),
+	_isInitialized(true) {
+
+	setTimeStamp();
+	rd_ptr(base());
+	wr_ptr(end());
+}
+
+NetworkData::NetworkData(const size_t unitLength, const ACE_UINT8* buffer,
+	const size_t headroom, const size_t tailroom):
+	ACE_Message_Block(headroom + unitLength + tailroom, MB_DATA, 0, 0, NetworkDataPool::instance(), 0,
+		ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY, ACE_Time_Value::zero, ACE_Time_Value::max_time,
+		NetworkDataPool::instance()),
+	_isInitialized(true) {
+
+	setTimeStamp();
+
+	// The tailroom is kept as spare capacity past the end of the buffer.
+	size(headroom + unitLength);
+	rd_ptr(base() + headroom);
+	wr_ptr(end());
+
+	if (buffer) ACE_OS::memcpy(rd_ptr(), buffer, unitLength);
+	else if (unitLength) ACE_OS::memset(rd_ptr(), 0, unitLength);
+}
+
 NetworkData::NetworkData(const NetworkData* other,
 	const bool doDeepCopy /* = true */,
 	const size_t offset /* = 0 */,
-	const size_t newLen /* = 0 */ ): ACE_Message_Block(/* allocator */) {
+	const size_t newLen /* = 0 */ ): ACE_Message_Block(0, MB_DATA, 0, 0, NetworkDataPool::instance(), 0,
+		ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY, ACE_Time_Value::zero, ACE_Time_Value::max_time,
+		NetworkDataPool::instance()) {
 
 	if ( doDeepCopy ) {
-		if (data_block()->locking_strategy()) {
-			ACE_Lock* lockingStrategy = data_block()->locking_strategy();
-			data_block()->locking_strategy(0);
-			delete lockingStrategy;
-		}
 		deepCopy(other, offset, newLen);
 	}
 	else {
-		// Initialize the locking strategy.
+		// Once a block is shared its reference count must be guarded.
 		if ( other->data_block()->locking_strategy() == 0 ) {
-			ACE_Lock* lockingStrategy = new ACE_Lock_Adapter<ACE_Thread_Semaphore>();
-			other->data_block()->locking_strategy(lockingStrategy);
+			other->data_block()->locking_strategy(sharedBlockLock(other->data_block()));
 		}
 
 		_isInitialized = other->_isInitialized;
@@ -78,14 +132,16 @@ NetworkData::NetworkData(const NetworkData* other,
 	setTimeStamp(other->getTimeStamp());
 }
 
-NetworkData::~NetworkData() {
-	if (data_block() && data_block()->locking_strategy()) {
-		ACE_Lock* lockingStrategy = data_block()->locking_strategy();
-		data_block()->locking_strategy(0);
-		delete lockingStrategy;
-	}
+NetworkData::~NetworkData() { }
+
+void* NetworkData::operator new(size_t objSize) {
+	void* ptr = NetworkDataPool::instance()->malloc(objSize);
+	if ( ! ptr ) throw std::bad_alloc();
+	return ptr;
 }
 
+void NetworkData::operator delete(void* ptr) { NetworkDataPool::instance()->free(ptr); }
+
 ACE_UINT8* NetworkData::ptrBuffer(const size_t offset /* = 0 */) const {
 	throwIfUninitialized();
 	return reinterpret_cast<ACE_UINT8*>(base() + offset);
@@ -300,7 +356,7 @@ void NetworkData::uint2bits(const ACE_UINT64 val, ACE_UINT8* ptr, const unsigned
 
 	ACE_Time_Value NetworkData::getTimeStamp() const { return _timeStamp; }
 
-	void NetworkData::setTimeStamp() { _timeStamp = ACE_High_Res_Timer::gettimeofday_hr(); }
+	void NetworkData::setTimeStamp() { _timeStamp = ClockService::instance()->now(); }
 
 	void NetworkData::setTimeStamp(const ACE_Time_Value& newTime) { _timeStamp = newTime; }
 
@@ -351,6 +407,8 @@ void NetworkData::setDataToPattern(const NetworkData* pattern, const size_t& off
 }
 
 void NetworkData::prepend(const ACE_UINT8* buffer, const size_t bufLen) {
+	if ( prependInPlace(buffer, bufLen) ) return;
+
 	size_t oldLength = getUnitLength();
 	size_t newLength = oldLength + bufLen;
 
@@ -364,6 +422,8 @@ void NetworkData::prepend(const NetworkData* data) {
 }
 
 void NetworkData::append(const ACE_UINT8* buffer, const size_t bufLen) {
+	if ( appendInPlace(buffer, bufLen) ) return;
+
 	size_t offset = getUnitLength();
 
 	setUnitLength(offset + bufLen);
@@ -380,6 +440,10 @@ void NetworkData::append(const NetworkData* data) {
 void NetworkData::flatten() {
 	// ND_DEBUG("flatten(): Changing unit length from %d to %d.\n", getUnitLength(), getTotalUnitLength());
 	ACE_UINT64 idx = getUnitLength();
+
+	// The octets past the end of a shared buffer may belong to someone else.
+	if ( getNextPart() && reference_count() > 1 ) reallocate_(0, getTotalUnitLength() - idx, true);
+
 	setUnitLength(getTotalUnitLength());
 
 	// NetworkData* curData = this;
@@ -418,15 +482,18 @@ NetworkData* NetworkData::getNextPart() const { return dynamic_cast<NetworkData*
 void NetworkData::setNextPart(NetworkData* newPart) { cont(dynamic_cast<ACE_Message_Block*>(newPart)); }
 
 ACE_Message_Block* NetworkData::release() {
-	if ( data_block()->locking_strategy() ) {
-		if ( data_block()->reference_count() == 1 ) {
-			ACE_Lock* lockingStrategy = data_block()->locking_strategy();
-			data_block()->locking_strategy(0);
-			delete lockingStrategy;
-		}
+	// ACE would release the continuation blocks while holding this block's
+	// lock; detaching each part first means only one lock is held at a time.
+	ACE_Message_Block* part = this;
+
+	while ( part ) {
+		ACE_Message_Block* next = part->cont();
+		part->cont(0);
+		part->ACE_Message_Block::release();
+		part = next;
 	}
 
-	return ACE_Message_Block::release();
+	return 0;
 }
 
 ACE_Message_Block* NetworkData::duplicate() const { return ACE_Message_Block::duplicate(); }
@@ -462,6 +529,66 @@ int NetworkData::setBufferSize(const size_t newLen) {
 	return size() - originalSize;
 }
 
+size_t NetworkData::getHeadroom() const { return rd_ptr() - base(); }
+
+size_t NetworkData::getTailroom() const { return capacity() - (wr_ptr() - base()); }
+
+void NetworkData::reserveRoom(const size_t headroom, const size_t tailroom,
+	const bool preserveUnit /* = true */) {
+
+	if ( getHeadroom() >= headroom && getTailroom() >= tailroom ) return;
+
+	reallocate_(headroom, tailroom, preserveUnit);
+}
+
+void NetworkData::reallocate_(const size_t headroom, const size_t tailroom, const bool preserveUnit) {
+	const size_t unitLen = getUnitLength();
+
+	ACE_Data_Block* newBlock = data_block()->clone_nocopy(0, headroom + unitLen + tailroom);
+	if ( ! newBlock ) throw OutOfMemory("reallocate_(): Unable to allocate a new data block.");
+
+	// The new block is not shared yet.
+	newBlock->locking_strategy(0);
+	newBlock->size(headroom + unitLen);
+
+	char* newUnit = newBlock->base() + headroom;
+	if ( preserveUnit && unitLen ) ACE_OS::memcpy(newUnit, rd_ptr(), unitLen);
+
+	data_block(newBlock);
+	rd_ptr(newUnit);
+	wr_ptr(newUnit + unitLen);
+}
+
+bool NetworkData::prependInPlace(const ACE_UINT8* buffer, const size_t bufLen) {
+	if ( reference_count() > 1 || getHeadroom() < bufLen ) return false;
+
+	rd_ptr(rd_ptr() - bufLen);
+	ACE_OS::memcpy(rd_ptr(), buffer, bufLen);
+	_isInitialized = true;
+
+	return true;
+}
+
+bool NetworkData::appendInPlace(const ACE_UINT8* buffer, const size_t bufLen) {
+	if ( reference_count() > 1 || getTailroom() < bufLen ) return false;
+
+	ACE_OS::memcpy(wr_ptr(), buffer, bufLen);
+	return extendInPlace(bufLen);
+}
+
+bool NetworkData::extendInPlace(const size_t len) {
+	if ( reference_count() > 1 || getTailroom() < len ) return false;
+
+	// Within capacity, so ACE only moves the end of the buffer.
+	const size_t newEnd = (wr_ptr() - base()) + len;
+	if ( newEnd > size() ) size(newEnd);
+
+	wr_ptr(len);
+	_isInitialized = true;
+
+	return true;
+}
+
 int NetworkData::setUnitLength(const size_t newLen, const bool keepLargerBuffer /* = false */) {
 	// Since we're setting the size, consider the unit initialized.
 	_isInitialized = true;
@@ -149,12 +149,29 @@ public:
 
 	// static ACE_Lock* lockingStrategy;
 
+	/// Passed to a constructor to skip zeroing a buffer that the caller will overwrite completely.
+	enum NoFill { noFill };
+
 	/// Default constructor.
     NetworkData();
 
     /// Initialize with an allocated buffer.
 	NetworkData(const size_t bufferSize, const ACE_UINT8* buffer = 0);
 
+	/// @brief Initialize with an allocated buffer whose contents are left undefined.
+	/// Only for callers that write every octet of the unit before it is read.
+	/// @param bufferSize The size of the buffer and the unit.
+	NetworkData(const size_t bufferSize, const NoFill);
+
+	/// @brief Initialize with an allocated buffer that has free space on either side of the unit.
+	/// Outer layers can later be added with prepend() and append() without reallocating.
+	/// @param unitLength The size of the unit itself.
+	/// @param buffer If not null, unitLength octets to copy into the unit; otherwise it is zeroed.
+	/// @param headroom The number of free octets to reserve before the unit.
+	/// @param tailroom The number of free octets to reserve after the unit.
+	NetworkData(const size_t unitLength, const ACE_UINT8* buffer, const size_t headroom,
+		const size_t tailroom);
+
 	/// Copy constructor.
 	/// @param other A pointer to the NetworkData to copy.
 	/// @param doDeepCopy If true, makes a true duplicate of the data. Otherwise, shares other's buffer.
@@ -167,6 +184,12 @@ public:
 	/// Destructor.
     virtual ~NetworkData();
 
+	/// Allocate NetworkData objects (and descendants) from NetworkDataPool.
+	static void* operator new(size_t objSize);
+
+	/// Return NetworkData objects to NetworkDataPool.
+	static void operator delete(void* ptr);
+
 	/// @brief Pointer to the start of the buffer.
 	/// @param offset Added to the start of the buffer.
 	/// @throw PrematureAccess If not initialized.
@@ -293,7 +316,7 @@ public:
 	/// Read-only accessor for _timeStamp.
 	ACE_Time_Value getTimeStamp() const;
 
-	/// Updates _timeStamp to the current time.
+	/// Updates _timeStamp to the current time, as read from ClockService::now().
 	void setTimeStamp();
 
 	/// Sets the time stamp to the provided value.
@@ -345,6 +368,7 @@ public:
 	virtual void setDataToPattern(const NetworkData* pattern, const size_t& offset = 0);
 
 	/// Increase the internal buffer by bufLen, and prepend the provided buffer.
+	/// Done in place if there is enough headroom, otherwise the unit is moved.
 	/// @param buffer The buffer to add.
 	/// @param bufLen The amount of data to prepend.
 	virtual void prepend(const ACE_UINT8* buffer, const size_t bufLen);
@@ -354,6 +378,7 @@ public:
 	virtual void prepend(const NetworkData* data);
 
 	/// Increase the internal buffer by bufLen, and append the provided buffer.
+	/// Done in place if there is enough tailroom, otherwise the buffer is reallocated.
 	/// @param buffer The buffer to add.
 	/// @param bufLen The amount of data to add.
 	virtual void append(const ACE_UINT8* buffer, const size_t bufLen);
@@ -377,6 +402,15 @@ public:
 
 	}
 
+	/// @brief Generate an object of a different type that covers this entire unit.
+	/// Typically used after prepend() has placed a header in the headroom.
+	/// As with wrapInnerPDU, the two wrappers share the buffer.
+	/// @return A new object of the specified NetworkDataType type.
+	template <class NetworkDataType>
+	NetworkDataType* wrapOuterPDU() {
+		return new NetworkDataType(this, false, 0, getUnitLength());
+	}
+
 	// -- TYPE-RELATED FUNCTIONS ------------------------------------------------------------
 	// Functions that identify the type contained in the buffer to specific subclasses.
 
@@ -423,11 +457,46 @@ public:
 
 	/// Return the entire length of all buffer (not unit) parts added together.
 	size_t getTotalBufferSize() const;
+
+	/// The number of octets between the start of the buffer and the start of the unit.
+	size_t getHeadroom() const;
+
+	/// The number of octets the unit could grow into past its end without reallocating.
+	size_t getTailroom() const;
+
+	/// @brief Make sure the unit has at least the specified free space on either side.
+	/// If it doesn't, the buffer is reallocated once with enough room.
+	/// @param headroom The minimum number of free octets before the unit.
+	/// @param tailroom The minimum number of free octets after the unit.
+	/// @param preserveUnit If false, the contents of the unit are not copied to the new buffer.
+	void reserveRoom(const size_t headroom, const size_t tailroom, const bool preserveUnit = true);
+
+	/// @brief Grow the unit backwards into the headroom and copy the provided buffer there.
+	/// Only allowed when no other object shares the buffer, since the headroom may belong to it.
+	/// @param buffer The buffer to add.
+	/// @param bufLen The amount of data to prepend.
+	/// @return True if successful, false if the unit was left unchanged.
+	bool prependInPlace(const ACE_UINT8* buffer, const size_t bufLen);
+
+	/// @brief Grow the unit forward into the tailroom and copy the provided buffer there.
+	/// Only allowed when no other object shares the buffer.
+	/// @param buffer The buffer to add.
+	/// @param bufLen The amount of data to append.
+	/// @return True if successful, false if the unit was left unchanged.
+	bool appendInPlace(const ACE_UINT8* buffer, const size_t bufLen);
+
+	/// @brief Grow the unit forward into the tailroom without copying anything.
+	/// For callers that have already written the new content past the end of the unit.
+	/// Only allowed when no other object shares the buffer.
+	/// @param len The number of octets to add.
+	/// @return True if successful, false if the unit was left unchanged.
+	bool extendInPlace(const size_t len);
 	// -------------------------------------------------------------------------------------
 
 	// -- CONTINUATION FIELD AND REFERENCE COUNT-RELATED FUNCTIONS -------------------------
 	/// Take our internal linked list of messages and combine them into one data area.
-	/// Assumes this is the top level message.
+	/// Assumes this is the top level message. If this unit shares its buffer, as
+	/// a slice made by wrapInnerPDU() does, the parts are merged into a new buffer.
 	virtual void flatten();
 
 	/// Get a pointer to the final populated NetworkData in the list.
@@ -645,6 +714,12 @@ protected:
 	/// An accessor to _isInitialized.
 	void setInitialized_(const bool initVal = true );
 
+	/// Move the unit to a new, unshared buffer with the specified free space on either side.
+	/// @param headroom The number of free octets before the unit.
+	/// @param tailroom The number of free octets after the unit.
+	/// @param preserveUnit If false, the contents of the unit are not copied to the new buffer.
+	void reallocate_(const size_t headroom, const size_t tailroom, const bool preserveUnit);
+
 private:
 	/// Set to true when the buffer has been allocated. Most methods will
 	/// throw an exception if operations are attempted on the object and
@@ -0,0 +1,226 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   NetworkDataPool.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "NetworkDataPool.hpp"
+#include "nd_macros.hpp"
+
+#include <ace/Guard_T.h>
+#include <ace/OS_NS_stdlib.h>
+#include <ace/OS_NS_string.h>
+
+namespace nasaCE {
+
+NetworkDataPool::NetworkDataPool(const size_t maxCachedChunks /* = defaultMaxCachedChunks */,
+	const size_t maxCachedBytes /* = defaultMaxCachedBytes */):
+	classCount_(0),
+	index_(indexes_),
+	maxCachedChunks_(maxCachedChunks),
+	maxCachedBytes_(maxCachedBytes),
+	oversizeCount_(0) {
+
+	indexes_[0].count = 0;
+
+	// Power-of-two classes from 64 octets to 64 KiB catch everything that
+	// wasn't explicitly registered, with at most 2x wasted space.
+	for ( size_t sz = 64; sz <= 65536; sz <<= 1 ) addSizeClass(sz);
+}
+
+NetworkDataPool::~NetworkDataPool() {
+	for ( int idx = 0; idx < classCount_; ++idx ) {
+		ACE_GUARD(ACE_Thread_Mutex, guard, classes_[idx].lock);
+
+		while ( classes_[idx].freeList ) {
+			ChunkHeader* chunk = classes_[idx].freeList;
+			classes_[idx].freeList = chunk->next;
+			ACE_OS::free(chunk);
+		}
+		classes_[idx].cachedCount = 0;
+	}
+}
+
+NetworkDataPool* NetworkDataPool::instance() {
+	// Deliberately leaked: NetworkData objects may outlive static destructors.
+	static NetworkDataPool* pool = new NetworkDataPool();
+	return pool;
+}
+
+bool NetworkDataPool::addSizeClass(const size_t chunkSize) {
+	if ( ! chunkSize ) return true;
+
+	// Most calls are for sizes that are already registered.
+	const SizeIndex* current = index_;
+	int pos = lowerBound_(current, chunkSize);
+	if ( pos < current->count && current->chunkSizes[pos] == chunkSize ) return true;
+
+	ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, classTableLock_, false);
+
+	current = index_;
+	pos = lowerBound_(current, chunkSize);
+	if ( pos < current->count && current->chunkSizes[pos] == chunkSize ) return true;
+
+	if ( classCount_ >= maxSizeClasses ) {
+		ND_WARNING("NetworkDataPool: All %d size classes are in use, %d-octet buffers will use the next larger class.\n",
+			maxSizeClasses, static_cast<int>(chunkSize));
+		return false;
+	}
+
+	// Fully prepare the class and its new index before making them visible to findClass_().
+	const int idx = classCount_;
+	classes_[idx].chunkSize = chunkSize;
+
+	SizeIndex* next = &indexes_[idx + 1];
+	next->count = current->count + 1;
+	for ( int i = 0, j = 0; i < next->count; ++i ) {
+		if ( i == pos ) {
+			next->chunkSizes[i] = chunkSize;
+			next->classes[i] = idx;
+		}
+		else {
+			next->chunkSizes[i] = current->chunkSizes[j];
+			next->classes[i] = current->classes[j];
+			++j;
+		}
+	}
+
+	__sync_synchronize();
+	classCount_ = idx + 1;
+	index_ = next;
+
+	return true;
+}
+
+int NetworkDataPool::lowerBound_(const SizeIndex* index, const size_t nbytes) {
+	int low = 0, high = index->count;
+
+	while ( low < high ) {
+		const int mid = (low + high) / 2;
+		if ( index->chunkSizes[mid] < nbytes ) low = mid + 1;
+		else high = mid;
+	}
+
+	return low;
+}
+
+int NetworkDataPool::findClass_(const size_t nbytes) const {
+	const SizeIndex* current = index_;
+	const int pos = lowerBound_(current, nbytes);
+
+	return ( pos < current->count )? current->classes[pos] : -1;
+}
+
+void* NetworkDataPool::malloc(size_t nbytes) {
+	const int idx = findClass_(nbytes);
+	ChunkHeader* chunk = 0;
+
+	if ( idx < 0 ) {
+		chunk = static_cast<ChunkHeader*>(ACE_OS::malloc(sizeof(ChunkHeader) + nbytes));
+		if ( ! chunk ) return 0;
+
+		chunk->sizeClass = -1;
+
+		ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, classTableLock_, 0);
+		++oversizeCount_;
+	}
+	else {
+		SizeClass& sc = classes_[idx];
+
+		{
+			ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, sc.lock, 0);
+
+			if ( sc.freeList ) {
+				chunk = sc.freeList;
+				sc.freeList = chunk->next;
+				--sc.cachedCount;
+				++sc.hits;
+			}
+			else ++sc.misses;
+		}
+
+		if ( ! chunk ) {
+			chunk = static_cast<ChunkHeader*>(ACE_OS::malloc(sizeof(ChunkHeader) + sc.chunkSize));
+			if ( ! chunk ) return 0;
+		}
+
+		chunk->sizeClass = idx;
+	}
+
+	return chunk + 1;
+}
+
+void* NetworkDataPool::calloc(size_t nbytes, char initial_value /* = '\0' */) {
+	void* ptr = malloc(nbytes);
+	if ( ptr ) ACE_OS::memset(ptr, initial_value, nbytes);
+	return ptr;
+}
+
+void* NetworkDataPool::calloc(size_t n_elem, size_t elem_size, char initial_value /* = '\0' */) {
+	return calloc(n_elem * elem_size, initial_value);
+}
+
+void NetworkDataPool::free(void* ptr) {
+	if ( ! ptr ) return;
+
+	ChunkHeader* chunk = static_cast<ChunkHeader*>(ptr) - 1;
+	const int idx = chunk->sizeClass;
+
+	if ( idx >= 0 && idx < classCount_ ) {
+		SizeClass& sc = classes_[idx];
+		ACE_GUARD(ACE_Thread_Mutex, guard, sc.lock);
+
+		if ( sc.cachedCount < maxCachedChunks_ &&
+			(sc.cachedCount + 1) * sc.chunkSize <= maxCachedBytes_ ) {
+			chunk->next = sc.freeList;
+			sc.freeList = chunk;
+			++sc.cachedCount;
+			return;
+		}
+	}
+
+	ACE_OS::free(chunk);
+}
+
+ACE_UINT64 NetworkDataPool::getHitCount() const {
+	ACE_UINT64 total = 0;
+
+	for ( int idx = 0; idx < classCount_; ++idx ) {
+		ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, classes_[idx].lock, total);
+		total += classes_[idx].hits;
+	}
+
+	return total;
+}
+
+ACE_UINT64 NetworkDataPool::getMissCount() const {
+	ACE_UINT64 total = oversizeCount_;
+
+	for ( int idx = 0; idx < classCount_; ++idx ) {
+		ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, classes_[idx].lock, total);
+		total += classes_[idx].misses;
+	}
+
+	return total;
+}
+
+ACE_UINT64 NetworkDataPool::getCachedChunkCount() const {
+	ACE_UINT64 total = 0;
+
+	for ( int idx = 0; idx < classCount_; ++idx ) {
+		ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, classes_[idx].lock, total);
+		total += classes_[idx].cachedCount;
+	}
+
+	return total;
+}
+
+} // namespace nasaCE
@@ -0,0 +1,167 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   NetworkDataPool.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _NASA_NETWORK_DATA_POOL_HPP_
+#define _NASA_NETWORK_DATA_POOL_HPP_
+
+#include <ace/Basic_Types.h>
+#include <ace/Malloc_Allocator.h>
+#include <ace/Thread_Mutex.h>
+
+namespace nasaCE {
+
+//=============================================================================
+/**
+ * @class NetworkDataPool
+ * @brief A size-classed free-list allocator for NetworkData buffers.
+ *
+ * Each size class keeps a list of previously released chunks which are
+ * handed back out instead of going to the heap. Segments register the sizes
+ * they will be allocating most often (MTU, MRU, expected frame length) with
+ * addSizeClass(); a set of power-of-two classes covers everything else.
+ * Requests larger than the biggest class are passed straight to the heap.
+ *
+ * Every chunk is preceded by a small header recording the class it belongs
+ * to, so a buffer may be released by a different thread (i.e. a different
+ * segment) than the one that allocated it.
+ */
+//=============================================================================
+class NetworkDataPool: public ACE_New_Allocator {
+public:
+	/// The most size classes that can be registered.
+	static const int maxSizeClasses = 48;
+
+	/// The default limit on released chunks held by each class.
+	static const size_t defaultMaxCachedChunks = 1024;
+
+	/// The default limit on the octets of released chunks held by each class.
+	static const size_t defaultMaxCachedBytes = 4 * 1024 * 1024;
+
+	/// Default constructor.
+	/// @param maxCachedChunks The most idle chunks to hold per size class.
+	/// @param maxCachedBytes The most idle octets to hold per size class.
+	NetworkDataPool(const size_t maxCachedChunks = defaultMaxCachedChunks,
+		const size_t maxCachedBytes = defaultMaxCachedBytes);
+
+	/// Destructor. Returns all cached chunks to the heap.
+	virtual ~NetworkDataPool();
+
+	/// @brief The process-wide pool used by NetworkData.
+	/// It is never destroyed, so buffers may safely be released during shutdown.
+	static NetworkDataPool* instance();
+
+	/// @brief Add a size class for exactly the specified number of octets.
+	/// Does nothing if a class of that size already exists; logs a warning
+	/// if the table is full.
+	/// @param chunkSize The buffer size to add a class for.
+	/// @return False if the table was full, otherwise true.
+	bool addSizeClass(const size_t chunkSize);
+
+	/// Allocate at least nbytes from the best-fitting size class.
+	virtual void* malloc(size_t nbytes);
+
+	/// Allocate at least nbytes and set them all to initial_value.
+	virtual void* calloc(size_t nbytes, char initial_value = '\0');
+
+	/// Allocate n_elem * elem_size bytes and set them all to initial_value.
+	virtual void* calloc(size_t n_elem, size_t elem_size, char initial_value = '\0');
+
+	/// Return a chunk to its size class, or the heap if the class is full.
+	virtual void free(void* ptr);
+
+	/// The number of allocations satisfied from a free list.
+	ACE_UINT64 getHitCount() const;
+
+	/// The number of allocations that had to go to the heap.
+	ACE_UINT64 getMissCount() const;
+
+	/// The number of idle chunks currently held in all classes.
+	ACE_UINT64 getCachedChunkCount() const;
+
+	/// Read-only accessor to maxCachedChunks_.
+	size_t getMaxCachedChunks() const { return maxCachedChunks_; }
+
+	/// Write-only accessor to maxCachedChunks_. Excess chunks are freed as they are returned.
+	void setMaxCachedChunks(const size_t newVal) { maxCachedChunks_ = newVal; }
+
+	/// Read-only accessor to maxCachedBytes_.
+	size_t getMaxCachedBytes() const { return maxCachedBytes_; }
+
+	/// Write-only accessor to maxCachedBytes_. Excess chunks are freed as they are returned.
+	void setMaxCachedBytes(const size_t newVal) { maxCachedBytes_ = newVal; }
+
+private:
+	/// Prefixed to every chunk; sized to keep the payload 16-byte aligned.
+	union ChunkHeader {
+		int sizeClass;       ///< Index into classes_, or -1 if not pooled.
+		ChunkHeader* next;   ///< Link to the next idle chunk while on a free list.
+		char pad[16];
+	};
+
+	/// Bookkeeping for a single size class.
+	struct SizeClass {
+		size_t chunkSize;        ///< The usable size of each chunk.
+		ChunkHeader* freeList;   ///< Singly-linked list of idle chunks.
+		size_t cachedCount;      ///< Length of freeList.
+		ACE_UINT64 hits;         ///< Allocations served from freeList.
+		ACE_UINT64 misses;       ///< Allocations that went to the heap.
+		mutable ACE_Thread_Mutex lock;
+
+		SizeClass(): chunkSize(0), freeList(0), cachedCount(0), hits(0), misses(0) { }
+	};
+
+	/// The size classes ordered by chunk size, for binary searches.
+	struct SizeIndex {
+		int count;                          ///< The number of entries in use.
+		size_t chunkSizes[maxSizeClasses];  ///< Ascending chunk sizes.
+		int classes[maxSizeClasses];        ///< The classes_ index of each size.
+	};
+
+	/// Fixed table of size classes; entries are only ever appended, since
+	/// chunk headers refer to them by index.
+	SizeClass classes_[maxSizeClasses];
+
+	/// The number of entries in use in classes_.
+	volatile int classCount_;
+
+	/// One index for each possible class count. Each is written once, before
+	/// being published in index_, so lookups never need a lock.
+	SizeIndex indexes_[maxSizeClasses + 1];
+
+	/// The index covering every class added so far.
+	SizeIndex* volatile index_;
+
+	/// Guards additions to classes_.
+	ACE_Thread_Mutex classTableLock_;
+
+	/// The most idle chunks any one class will hold.
+	size_t maxCachedChunks_;
+
+	/// The most idle octets any one class will hold.
+	size_t maxCachedBytes_;
+
+	/// Allocations too large for any size class.
+	ACE_UINT64 oversizeCount_;
+
+	/// Find the smallest class that can hold nbytes.
+	/// @return The index in classes_, or -1 if none are large enough.
+	int findClass_(const size_t nbytes) const;
+
+	/// Find the position of the first entry in the index at least nbytes long.
+	static int lowerBound_(const SizeIndex* index, const size_t nbytes);
+};
+
+} // namespace nasaCE
+
+#endif // _NASA_NETWORK_DATA_POOL_HPP_
@@ -0,0 +1,116 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   PseudoRandomSequence.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "PseudoRandomSequence.hpp"
+
+#include <cstring>
+
+// AVX2 is chosen at run time, so it needs per-function target attributes.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) ) && \
+	( __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) || defined(__clang__) )
+#define PN_X86_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace nasaCE {
+
+/// The generated sequence and the kernel choice, set up once at load time.
+struct PnTable {
+	ACE_UINT8 seq[PseudoRandomSequence::tableLen] __attribute__((aligned(64)));
+	bool useAVX2;
+
+	PnTable(): useAVX2(false) {
+		std::memset(seq, 0, sizeof(seq));
+
+		// Shift out the low bit of the register; the feedback taps are bits 0, 3, 5, and 7.
+		ACE_UINT8 gen = 0xff;
+
+		for ( std::size_t x = 0; x < PseudoRandomSequence::tableLen * 8; ++x ) {
+			const ACE_UINT8 outBit = gen & 1;
+			seq[x / 8] |= outBit << (7 - x % 8);
+
+			const ACE_UINT8 feedback = outBit ^ ((gen >> 3) & 1) ^ ((gen >> 5) & 1) ^ ((gen >> 7) & 1);
+			gen = (gen >> 1) | (feedback << 7);
+		}
+
+		#ifdef PN_X86_AVX2
+		__builtin_cpu_init();
+		useAVX2 = __builtin_cpu_supports("avx2");
+		#endif
+	}
+};
+
+static const PnTable pnTable;
+
+/// XOR 64 bits at a time, then finish octet by octet.
+static void xorWords(ACE_UINT8* buf, const ACE_UINT8* seq, const std::size_t len) {
+	std::size_t i = 0;
+
+	for ( ; i + 8 <= len; i += 8 ) {
+		ACE_UINT64 word, pn;
+		std::memcpy(&word, buf + i, 8);
+		std::memcpy(&pn, seq + i, 8);
+		word ^= pn;
+		std::memcpy(buf + i, &word, 8);
+	}
+
+	for ( ; i < len; ++i ) buf[i] ^= seq[i];
+}
+
+#ifdef PN_X86_AVX2
+/// XOR 64 octets per iteration; neither buf nor seq needs to be aligned.
+__attribute__((target("avx2")))
+static void xorAVX2(ACE_UINT8* buf, const ACE_UINT8* seq, const std::size_t len) {
+	std::size_t i = 0;
+
+	for ( ; i + 64 <= len; i += 64 ) {
+		const __m256i lo = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf + i)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(seq + i)));
+		const __m256i hi = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf + i + 32)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(seq + i + 32)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(buf + i), lo);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(buf + i + 32), hi);
+	}
+
+	xorWords(buf + i, seq + i, len - i);
+}
+#endif
+
+void PseudoRandomSequence::apply(ACE_UINT8* buf, const std::size_t len, const std::size_t seqOffset /* = 0 */) {
+	std::size_t start = seqOffset % tableLen;
+
+	// After the first chunk, every pass starts at the beginning of the table again.
+	for ( std::size_t offset = 0; offset < len; offset += tableLen - start, start = 0 ) {
+		const std::size_t chunk = ( len - offset < tableLen - start )? len - offset : tableLen - start;
+
+		#ifdef PN_X86_AVX2
+		if ( pnTable.useAVX2 ) {
+			xorAVX2(buf + offset, pnTable.seq + start, chunk);
+			continue;
+		}
+		#endif
+
+		xorWords(buf + offset, pnTable.seq + start, chunk);
+	}
+}
+
+const ACE_UINT8* PseudoRandomSequence::table() {
+	return pnTable.seq;
+}
+
+bool PseudoRandomSequence::usingAVX2() {
+	return pnTable.useAVX2;
+}
+
+} // namespace nasaCE
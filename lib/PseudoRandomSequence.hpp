@@ -0,0 +1,56 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   PseudoRandomSequence.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _NASA_PSEUDO_RANDOM_SEQUENCE_HPP_
+#define _NASA_PSEUDO_RANDOM_SEQUENCE_HPP_
+
+#include <ace/Basic_Types.h>
+#include <cstddef>
+
+namespace nasaCE {
+
+//=============================================================================
+/**
+ * @class PseudoRandomSequence
+ * @brief The CCSDS TM Synchronization and Channel Coding pseudo-randomizer.
+ *
+ * The sequence from h(x) = x^8 + x^7 + x^5 + x^3 + 1, starting from all ones,
+ * repeats every 255 bits and so every 255 octets. One process-wide table holds
+ * 64 repetitions, which is also a multiple of 64 octets, so longer units simply
+ * wrap back to the start of the table and every pass begins on an aligned boundary.
+ */
+//=============================================================================
+class PseudoRandomSequence {
+public:
+	/// The length of the table in octets: 64 periods of the sequence.
+	static const std::size_t tableLen = 255 * 64;
+
+	/// @brief XOR a buffer in place with the sequence, by default starting at its first bit.
+	/// Applying it twice restores the original contents.
+	/// @param buf The buffer to randomize or derandomize.
+	/// @param len The number of octets in buf; there is no upper limit.
+	/// @param seqOffset The octet of the sequence to start at, so a unit held in several
+	/// parts can be done one part at a time.
+	static void apply(ACE_UINT8* buf, const std::size_t len, const std::size_t seqOffset = 0);
+
+	/// The 64-octet aligned table, generated once when the library is loaded.
+	static const ACE_UINT8* table();
+
+	/// True if apply() is using the AVX2 kernel on this CPU.
+	static bool usingAVX2();
+};
+
+} // namespace nasaCE
+
+#endif // _NASA_PSEUDO_RANDOM_SEQUENCE_HPP_
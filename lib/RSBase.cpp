@@ -57,6 +57,28 @@ ostream &operator<<(ostream &stream, const SymVec& v) {
   return stream;
 }
 
+/// True if poly has degree bits and x generates all 2^bits - 1 nonzero elements modulo it.
+static bool isPrimitive(const int poly, const std::size_t bits) {
+	if ( ( poly >> bits ) != 1 ) return false;
+
+	const unsigned order = ( 1U << bits ) - 1;
+	unsigned x = 1;
+
+	for ( unsigned i = 1; i < order; ++i ) {
+		x <<= 1;
+		if ( x & ( order + 1 ) ) x ^= poly;
+		if ( x == 1 ) return false;
+	}
+
+	return true;
+}
+
+/// Greatest common divisor.
+static std::size_t greatestCommonDivisor(std::size_t a, std::size_t b) {
+	while ( b ) { const std::size_t r = a % b; a = b; b = r; }
+	return a;
+}
+
 RSBase::RSBase(const int primitivePoly,
 	const std::size_t parityLength,
 	const std::size_t codeLength,
@@ -73,6 +95,7 @@ RSBase::RSBase(const int primitivePoly,
 	_firstConsecutiveRoot(firstConsecutiveRoot),
 	_interleaveDepth(interleaveDepth),
 	_doBasisTransform(doBasisTransform),
+	_simdLevel(detectSimdLevel()),
 	gfExp_(0),
 	gfExpLen_((_maxSymbol + 1) * 2),
 	gfLog_(0),
@@ -84,6 +107,27 @@ RSBase::RSBase(const int primitivePoly,
 	if ( _interleaveDepth < 1 )
 		throw ValueTooSmall("Interleave depth must be greater than 0.");
 
+	if ( _bitsPerSymbol < 2 )
+		throw ValueTooSmall(ValueTooSmall::msg("bits per symbol", _bitsPerSymbol, 2));
+
+	if ( ! isPrimitive(primitivePoly, _bitsPerSymbol) )
+		throw BadValue(BadValue::msg("Primitive polynomial", primitivePoly));
+
+	// Shortened codes are fine, but a codeword cannot outgrow the field.
+	if ( _codeLength > _maxSymbol )
+		throw ValueTooLarge(ValueTooLarge::msg("code length", _codeLength, _maxSymbol));
+
+	if ( _parityLength < 1 || _parityLength >= _codeLength )
+		throw ValueOutOfRange(ValueOutOfRange::msg("parity length", _parityLength, 1, _codeLength - 1));
+
+	// Otherwise the powers of the root repeat and error positions become ambiguous.
+	if ( greatestCommonDivisor(_primitiveRootIdx, _maxSymbol) != 1 )
+		throw BadValue(BadValue::msg("Primitive root index", _primitiveRootIdx));
+
+	// The dual basis tables are only defined for the CCSDS field and root.
+	if ( _doBasisTransform && ( _bitsPerSymbol != 8 || primitivePoly != 0x187 || _primitiveRootIdx != 11 ) )
+		throw BadValue("The dual basis transformation only applies to the CCSDS code (0x187, root index 11).");
+
 	gfExp_ = new Sym[gfExpLen_];
 	ACE_OS::memset(gfExp_, 1, gfExpLen_);
 
@@ -103,6 +147,36 @@ RSBase::~RSBase() {
 	delete[] gfLog_;
 }
 
+#ifdef RS_X86_SIMD
+/// Query CPUID; may run before main() if a coder is built during static initialization.
+static RSBase::SimdLevel querySimdLevel() {
+	__builtin_cpu_init();
+
+	if ( __builtin_cpu_supports("avx2") ) return RSBase::SimdAVX2;
+	if ( __builtin_cpu_supports("ssse3") ) return RSBase::SimdSSSE3;
+	return RSBase::SimdNone;
+}
+#endif
+
+RSBase::SimdLevel RSBase::detectSimdLevel() {
+	#ifdef RS_X86_SIMD
+	static const SimdLevel level = querySimdLevel();
+	return level;
+	#else
+	return SimdNone;
+	#endif
+}
+
+std::string RSBase::simdLevelToStr(const SimdLevel level) {
+	switch (level) {
+		case SimdAVX2: return "avx2";
+		case SimdSSSE3: return "ssse3";
+		case SimdNone: break;
+	}
+
+	return "none";
+}
+
 void RSBase::_loadTables(const int primitivePoly) {
 	std::size_t i, j, k, x = 1;
 
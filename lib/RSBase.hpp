@@ -18,6 +18,12 @@
 #include <vector>
 #include "NetworkData.hpp"
 
+// The vector GF kernels need x86 intrinsics and per-function target attributes.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) ) && \
+	( __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) || defined(__clang__) )
+#define RS_X86_SIMD 1
+#endif
+
 namespace nasaCE {
 
 typedef ACE_UINT8 Sym;
@@ -81,8 +87,11 @@ public:
 	/// @param firstConsecutiveRoot The degree of the first term in the generating polynomial.
 	/// @param interleaveDepth The number of codewords to use per message.
 	/// @param doBasisTransform Whether to convert from from dual-basis to conventional before operating.
-	/// @throw ValueTooLarge If one of the provided values is unacceptible.
-	/// @throw ValueTooSmall If interleaveDepth is 0.
+	/// @throw ValueTooLarge If bitsPerSymbol is over 8 or codeLength over 2^bitsPerSymbol - 1.
+	/// @throw ValueTooSmall If interleaveDepth is 0 or bitsPerSymbol under 2.
+	/// @throw ValueOutOfRange If parityLength leaves no room for data.
+	/// @throw BadValue If primitivePoly is not primitive of degree bitsPerSymbol, primitiveRootIdx
+	/// shares a factor with 2^bitsPerSymbol - 1, or doBasisTransform is set outside the CCSDS code.
 	RSBase(const int primitivePoly,
 		const std::size_t parityLength,
 		const std::size_t codeLength,
@@ -95,6 +104,25 @@ public:
 	/// Destructor.
 	~RSBase();
 
+	/// The instruction sets available to the vector GF(2^8) kernels, least capable first.
+	enum SimdLevel {
+		SimdNone,   ///< Scalar table lookups only.
+		SimdSSSE3,  ///< 16 symbols per pshufb.
+		SimdAVX2    ///< 32 symbols per vpshufb.
+	};
+
+	/// The most capable SimdLevel this CPU supports. Detected once per process.
+	static SimdLevel detectSimdLevel();
+
+	/// Return "none", "ssse3", or "avx2".
+	static std::string simdLevelToStr(const SimdLevel level);
+
+	/// Write-only accessor to _simdLevel. Requests above detectSimdLevel() are lowered to it.
+	void setSimdLevel(const SimdLevel newVal) { _simdLevel = std::min(newVal, detectSimdLevel()); }
+
+	/// Read-only accessor to _simdLevel.
+	SimdLevel getSimdLevel() const { return _simdLevel; }
+
 	/// Multiply x and y together in the generated Galois Field.
 	/// @return The product of x and y.
 	inline Sym gfMul(const Sym& x, const Sym& y) const {
@@ -296,6 +324,9 @@ private:
 	/// Whether to convert from from dual-basis to conventional before encoding/decoding.
 	bool _doBasisTransform;
 
+	/// The vector kernels to use; starts at detectSimdLevel().
+	SimdLevel _simdLevel;
+
 protected:
 
 	/// Table of exponentials.
@@ -316,6 +347,47 @@ protected:
 	/// Only for CCSDS basis transformation.
 	Sym talTabInv_[256];
 
+public:
+	#ifdef RS_X86_SIMD
+	// -- SUPPORT FOR THE VECTOR KERNELS ---------------------------------------------------
+	/// The widest vector the GF kernels use, and so the deepest interleave they handle.
+	static const std::size_t simdLanes = 16;
+
+	/// @brief Work area for the vector kernels, one codeword per byte lane.
+	/// Row t holds stage t of every codeword's register. There are two rows
+	/// beyond the longest possible register so kernels can read past the last stage.
+	struct LaneRegisters {
+		Sym rows[(256 + 2) * simdLanes] __attribute__((aligned(32)));
+	};
+
+	/// @brief Collect the next symbol of each codeword into its lane, converting
+	/// from dual basis if basisTab is set. Lanes from depth up are left alone.
+	/// @param msg The interleaved message.
+	/// @param pos The position of the next symbol in msg.
+	/// @param msgLen The length of msg.
+	/// @param lane The first lane to fill; lower lanes hold virtual fill.
+	/// @param depth The interleave depth.
+	/// @param basisTab talTabInv_ or null.
+	/// @param lanes Receives the symbols.
+	/// @return The position in msg after the symbols taken.
+	static inline std::size_t gatherLanes(const Sym* msg, std::size_t pos, const std::size_t msgLen,
+		std::size_t lane, const std::size_t depth, const Sym* basisTab, Sym* lanes) {
+
+		if ( basisTab ) for ( ; lane < depth && pos < msgLen; ++lane ) lanes[lane] = basisTab[msg[pos++]];
+		else for ( ; lane < depth && pos < msgLen; ++lane ) lanes[lane] = msg[pos++];
+
+		return pos;
+	}
+	// -------------------------------------------------------------------------------------
+	#endif
+
+protected:
+	/// @brief The lane (codeword) of the first symbol in an interleaved message.
+	/// Virtual fill sits in front, so the last symbol always falls in the last codeword.
+	std::size_t firstLane_(const std::size_t msgLen) const {
+		return (getInterleaveDepth() - (msgLen % getInterleaveDepth())) % getInterleaveDepth();
+	}
+
 };
 
 } // namespace nasaCE
@@ -14,8 +14,81 @@
 
 #include "RSDecoder.hpp"
 
+#ifdef RS_X86_SIMD
+#include <immintrin.h>
+#endif
+
 namespace nasaCE {
 
+#ifdef RS_X86_SIMD
+
+/// Advance every codeword's syndromes by one symbol per step with Horner's rule,
+/// 16 codewords per pshufb pair.
+__attribute__((target("ssse3")))
+static void syndromeLanesSSSE3(const Sym* msg, const std::size_t msgLen, const std::size_t firstLane,
+	const std::size_t depth, const std::size_t parityLen, const Sym* nibLo, const Sym* nibHi,
+	const Sym* basisTab, RSBase::LaneRegisters& reg) {
+
+	const __m128i lowMask = _mm_set1_epi8(0x0f);
+	Sym lanes[RSBase::simdLanes] __attribute__((aligned(16))) = { 0 };
+
+	// Virtual fill occupies the lanes before the first symbol and contributes nothing.
+	std::size_t pos = 0, lane = firstLane;
+
+	while ( pos < msgLen ) {
+		pos = RSBase::gatherLanes(msg, pos, msgLen, lane, depth, basisTab, lanes);
+		lane = 0;
+
+		const __m128i in = _mm_load_si128((const __m128i*) lanes);
+
+		for ( std::size_t j = 0; j < parityLen; ++j ) {
+			__m128i* row = (__m128i*) (reg.rows + j * RSBase::simdLanes);
+			const __m128i synd = _mm_load_si128(row);
+
+			const __m128i prod = _mm_xor_si128(
+				_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (nibLo + j * 16)), _mm_and_si128(synd, lowMask)),
+				_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (nibHi + j * 16)),
+					_mm_and_si128(_mm_srli_epi64(synd, 4), lowMask)));
+
+			_mm_store_si128(row, _mm_xor_si128(prod, in));
+		}
+	}
+}
+
+/// As syndromeLanesSSSE3(), but two syndromes per vpshufb pair. An odd last
+/// pair leaves junk in the row past the last syndrome, which is never read.
+__attribute__((target("avx2")))
+static void syndromeLanesAVX2(const Sym* msg, const std::size_t msgLen, const std::size_t firstLane,
+	const std::size_t depth, const std::size_t parityLen, const Sym* nibLo, const Sym* nibHi,
+	const Sym* basisTab, RSBase::LaneRegisters& reg) {
+
+	const __m256i lowMask = _mm256_set1_epi8(0x0f);
+	Sym lanes[RSBase::simdLanes] __attribute__((aligned(16))) = { 0 };
+
+	std::size_t pos = 0, lane = firstLane;
+
+	while ( pos < msgLen ) {
+		pos = RSBase::gatherLanes(msg, pos, msgLen, lane, depth, basisTab, lanes);
+		lane = 0;
+
+		const __m256i in = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*) lanes));
+
+		for ( std::size_t j = 0; j < parityLen; j += 2 ) {
+			__m256i* rows = (__m256i*) (reg.rows + j * RSBase::simdLanes);
+			const __m256i synd = _mm256_load_si256(rows);
+
+			const __m256i prod = _mm256_xor_si256(
+				_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*) (nibLo + j * 16)), _mm256_and_si256(synd, lowMask)),
+				_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*) (nibHi + j * 16)),
+					_mm256_and_si256(_mm256_srli_epi64(synd, 4), lowMask)));
+
+			_mm256_store_si256(rows, _mm256_xor_si256(prod, in));
+		}
+	}
+}
+
+#endif // RS_X86_SIMD
+
 RSDecoder::RSDecoder(const int primitivePoly,
 		const std::size_t parityLength,
 		const std::size_t codeLength,
@@ -25,7 +98,11 @@ RSDecoder::RSDecoder(const int primitivePoly,
 		const std::size_t interleaveDepth /* = 1 */,
 		const bool doBasisTransform /* = false */ )
  : RSBase(primitivePoly, parityLength, codeLength, bitsPerSymbol, primitiveRootIdx,
- 	firstConsecutiveRoot, interleaveDepth, doBasisTransform) {
+ 	firstConsecutiveRoot, interleaveDepth, doBasisTransform),
+	_lastCorrectedErrors(0),
+	_syndromes(parityLength * interleaveDepth, 0) {
+
+	_initRootTabs();
 }
 
 
@@ -33,6 +110,132 @@ RSDecoder::~RSDecoder()
 {
 }
 
+void RSDecoder::_initRootTabs() {
+	_rootMulTab.assign(getParityLength() * 256, 0);
+
+	for ( std::size_t j = 0; j < getParityLength(); ++j ) {
+		const Sym root = gfExp_[(getPrimitiveRootIdx() * (j + getFirstConsecutiveRoot())) % getMaxSymbol()];
+		for ( unsigned x = 1; x <= getMaxSymbol(); ++x ) _rootMulTab[j * 256 + x] = gfMul(root, x);
+	}
+
+	// Splitting by nibble relies on x having 8 bits; smaller fields stay scalar.
+	if ( getBitsPerSymbol() != 8 ) return;
+
+	_rootNibbleLo.assign((getParityLength() + 1) * 16, 0);
+	_rootNibbleHi.assign((getParityLength() + 1) * 16, 0);
+
+	for ( std::size_t j = 0; j < getParityLength(); ++j ) {
+		for ( unsigned n = 0; n < 16; ++n ) {
+			_rootNibbleLo[j * 16 + n] = _rootMulTab[j * 256 + n];
+			_rootNibbleHi[j * 16 + n] = _rootMulTab[j * 256 + (n << 4)];
+		}
+	}
+}
+
+bool RSDecoder::syndromesClear(const Sym* msg, const std::size_t msgLen) {
+	const std::size_t depth = getInterleaveDepth();
+	const std::size_t parityLen = getParityLength();
+	const Sym* basisTab = getDoBasisTransform()? talTabInv_ : 0;
+
+	if ( msgLen > getCodeLength() * depth )
+		throw ValueTooLarge(ValueTooLarge::msg("Message length", msgLen, getCodeLength() * depth));
+
+	#ifdef RS_X86_SIMD
+	if ( getSimdLevel() != SimdNone && ! _rootNibbleLo.empty() && depth > 1 && depth <= simdLanes ) {
+		LaneRegisters reg;
+		ACE_OS::memset(reg.rows, 0, (parityLen + 1) * simdLanes);
+
+		if ( getSimdLevel() == SimdAVX2 )
+			syndromeLanesAVX2(msg, msgLen, firstLane_(msgLen), depth, parityLen,
+				&_rootNibbleLo[0], &_rootNibbleHi[0], basisTab, reg);
+		else
+			syndromeLanesSSSE3(msg, msgLen, firstLane_(msgLen), depth, parityLen,
+				&_rootNibbleLo[0], &_rootNibbleHi[0], basisTab, reg);
+
+		Sym any = 0;
+		for ( std::size_t j = 0; j < parityLen; ++j ) {
+			for ( std::size_t row = 0; row < depth; ++row ) {
+				_syndromes[j * depth + row] = reg.rows[j * simdLanes + row];
+				any |= reg.rows[j * simdLanes + row];
+			}
+		}
+
+		return ( any == 0 );
+	}
+	#endif
+
+	Sym* synd = &_syndromes[0];
+	const Sym* mulTab = &_rootMulTab[0];
+	std::size_t row = firstLane_(msgLen);
+
+	ACE_OS::memset(synd, 0, parityLen * depth);
+
+	for ( std::size_t i = 0; i < msgLen; ++i ) {
+		const Sym x = basisTab? basisTab[msg[i]] : msg[i];
+
+		for ( std::size_t j = 0; j < parityLen; ++j ) {
+			Sym& s = synd[j * depth + row];
+			s = mulTab[j * 256 + s] ^ x;
+		}
+
+		if ( ++row == depth ) row = 0;
+	}
+
+	Sym any = 0;
+	for ( std::size_t i = 0; i < parityLen * depth; ++i ) any |= synd[i];
+
+	return ( any == 0 );
+}
+
+std::size_t RSDecoder::correctInPlace(Sym* msg, const std::size_t msgLen) {
+	setLastCorrectedErrors(0);
+	std::string errMsg("");
+	int uncorrectedErrCount(0);
+
+	const std::size_t depth = getInterleaveDepth();
+	const std::size_t firstLane = firstLane_(msgLen);
+
+	// Each codeword begins with this many symbols of virtual fill, plus one more
+	// for the codewords in front of firstLane.
+	const std::size_t fill = getCodeLength() - (msgLen + firstLane) / depth;
+
+	Sym synd[maxParityLength], errVal[maxParityLength];
+	std::size_t errPos[maxParityLength];
+
+	for ( std::size_t row = 0; row < depth; ++row ) {
+		Sym any = 0;
+		for ( std::size_t j = 0; j < getParityLength(); ++j ) {
+			synd[j] = _syndromes[j * depth + row];
+			any |= synd[j];
+		}
+		if ( ! any ) continue;
+
+		const std::size_t span = getCodeLength() - fill - ( ( row < firstLane )? 1 : 0 );
+
+		try {
+			const std::size_t errs = solveErrors_(synd, span, errPos, errVal);
+
+			// Symbol o of this codeword is at (o - fill) * depth + row - firstLane in msg.
+			// The basis transformation is linear, so the error value can be converted alone.
+			for ( std::size_t k = 0; k < errs; ++k )
+				msg[(errPos[k] - fill) * depth + row - firstLane] ^=
+					getDoBasisTransform()? talTab_[errVal[k]] : errVal[k];
+
+			incLastCorrectedErrors(errs);
+		}
+		catch (TooManyErrors& tme) {
+			// Continue to the end of the entire message to find all the errors.
+			errMsg += std::string(tme.what()) + " ";
+			uncorrectedErrCount += tme.errors;
+		}
+	}
+
+	if (uncorrectedErrCount > 0)
+		throw TooManyErrors(errMsg, uncorrectedErrCount);
+
+	return getLastCorrectedErrors();
+}
+
 SymVec RSDecoder::calcSyndromes_(const SymVec& msg) const {
 	SymVec synd(getParityLength());
 
@@ -115,20 +318,151 @@ SymVec RSDecoder::findErrors_(const SymVec& synd, const std::size_t msgSize) con
 
 	if ( errs * 2U > synd.size() ) throw TooManyErrors(TooManyErrors::msg(errs, synd.size() / 2U), errs);
 
-	// find zeros of error polynomial
+	// find zeros of error polynomial; errPoly is highest degree first
+	Sym lambda[maxParityLength + 1];
+	std::size_t roots[maxParityLength];
+
+	for ( std::size_t k = 0; k <= errs; ++k ) lambda[k] = errPoly[errs - k];
+
+	if ( chienSearch_(lambda, errs, roots, getCodeLength()) != errs ) throw std::logic_error("Couldn't find error locations.");
+
 	SymVec errPos;
+	for ( std::size_t k = 0; k < errs; ++k ) errPos.push_back(roots[k] - (getCodeLength() - msgSize));
+
+	return errPos;
+}
+
+
+bool RSDecoder::wordSyndromes_(const Sym* word, Sym* synd) const {
+	const Sym* mulTab = &_rootMulTab[0];
+	Sym any = 0;
 
-	for ( std::size_t i = 0; i < msgSize; ++i ) {
-		if ( gfPolyEval(errPoly, gfExp_[getPrimitiveRootIdx()*(getMaxSymbol() - i) % getMaxSymbol()]) == 0 ) {
-			errPos.push_back(msgSize - 1 - i);
+	for ( std::size_t j = 0; j < getParityLength(); ++j ) {
+		const Sym* rootTab = mulTab + j * 256;
+		Sym s = 0;
+
+		for ( std::size_t i = 0; i < getCodeLength(); ++i ) s = rootTab[s] ^ word[i];
+
+		synd[j] = s;
+		any |= s;
+	}
+
+	return ( any == 0 );
+}
+
+std::size_t RSDecoder::chienSearch_(const Sym* lambda, const std::size_t degree, std::size_t* errPos,
+	const std::size_t span) const {
+	const std::size_t order = getMaxSymbol();
+
+	// Term k of lambda(x) at x = root^-d, kept as a logarithm and advanced by
+	// root^-k per position. Zero terms are dropped.
+	std::size_t logTerm[maxParityLength + 1], logStep[maxParityLength + 1], terms = 0;
+
+	for ( std::size_t k = 1; k <= degree; ++k ) {
+		if ( lambda[k] == 0 ) continue;
+		logTerm[terms] = gfLog_[lambda[k]];
+		logStep[terms] = (order - (getPrimitiveRootIdx() * k) % order) % order;
+		++terms;
+	}
+
+	std::size_t found = 0;
+
+	for ( std::size_t d = 0; d < span && found < degree; ++d ) {
+		Sym sum = lambda[0];
+
+		for ( std::size_t t = 0; t < terms; ++t ) {
+			sum ^= gfExp_[logTerm[t]];
+			logTerm[t] += logStep[t];
+			if ( logTerm[t] >= order ) logTerm[t] -= order;
 		}
+
+		if ( sum == 0 ) errPos[found++] = getCodeLength() - 1 - d;
 	}
 
-	if ( errPos.size() != errs ) throw std::logic_error("Couldn't find error locations.");
+	return found;
+}
+
+std::size_t RSDecoder::correctWord_(Sym* word, const Sym* synd, std::size_t* errPos) const {
+	Sym errVal[maxParityLength];
+	const std::size_t errs = solveErrors_(synd, getCodeLength(), errPos, errVal);
 
-	return errPos;
+	for ( std::size_t k = 0; k < errs; ++k ) word[errPos[k]] ^= errVal[k];
+
+	return errs;
 }
 
+std::size_t RSDecoder::solveErrors_(const Sym* synd, const std::size_t span, std::size_t* errPos, Sym* errVal) const {
+	const std::size_t parityLen = getParityLength();
+	const std::size_t order = getMaxSymbol();
+
+	// Berlekamp-Massey: lambda is the error locator, prev the last one to change length.
+	Sym lambda[maxParityLength + 1], prev[maxParityLength + 1], saved[maxParityLength + 1];
+	std::size_t len = 0, shift = 1;
+	Sym prevDelta = 1;
+
+	ACE_OS::memset(lambda, 0, parityLen + 1);
+	ACE_OS::memset(prev, 0, parityLen + 1);
+	lambda[0] = prev[0] = 1;
+
+	for ( std::size_t n = 0; n < parityLen; ++n ) {
+		Sym delta = synd[n];
+		for ( std::size_t i = 1; i <= len; ++i ) delta ^= gfMul(lambda[i], synd[n - i]);
+
+		if ( delta == 0 ) { ++shift; continue; }
+
+		const Sym scale = gfDiv(delta, prevDelta);
+		const bool grow = ( 2 * len <= n );
+
+		if ( grow ) ACE_OS::memcpy(saved, lambda, parityLen + 1);
+
+		for ( std::size_t i = 0; i + shift <= parityLen; ++i )
+			lambda[i + shift] ^= gfMul(scale, prev[i]);
+
+		if ( grow ) {
+			len = n + 1 - len;
+			ACE_OS::memcpy(prev, saved, parityLen + 1);
+			prevDelta = delta;
+			shift = 1;
+		}
+		else ++shift;
+	}
+
+	if ( len * 2U > parityLen ) throw TooManyErrors(TooManyErrors::msg(len, parityLen / 2U), len);
+
+	// Missing roots mean more errors than the code can locate, or errors in the virtual fill.
+	if ( chienSearch_(lambda, len, errPos, span) != len )
+		throw TooManyErrors("Couldn't find all error locations.", len);
+
+	// Error evaluator omega(x) = S(x) * lambda(x) mod x^len.
+	Sym omega[maxParityLength];
+	for ( std::size_t i = 0; i < len; ++i ) {
+		omega[i] = 0;
+		for ( std::size_t j = 0; j <= i; ++j ) omega[i] ^= gfMul(synd[j], lambda[i - j]);
+	}
+
+	// With the first root at root^fcr, each magnitude is X^(1-fcr) * omega(1/X) / lambda'(1/X).
+	const std::size_t fcrPower = (order + 1 - (getFirstConsecutiveRoot() % order)) % order;
+
+	for ( std::size_t k = 0; k < len; ++k ) {
+		const std::size_t logX = (getPrimitiveRootIdx() * (getCodeLength() - 1 - errPos[k])) % order;
+		const Sym xInv = gfExp_[(order - logX) % order];
+		const Sym xInv2 = gfMul(xInv, xInv);
+
+		Sym num = 0;
+		for ( std::size_t i = len; i-- > 0; ) num = gfMul(num, xInv) ^ omega[i];
+
+		// The formal derivative keeps only the odd terms.
+		Sym den = 0;
+		for ( std::size_t m = (len + 1) / 2; m-- > 0; ) den = gfMul(den, xInv2) ^ lambda[2 * m + 1];
+
+		if ( den == 0 ) throw std::logic_error("Error locator has a repeated root.");
+
+		errVal[k] = ( num == 0 )? 0 :
+			gfExp_[((logX * fcrPower) % order + gfLog_[num] + order - gfLog_[den]) % order];
+	}
+
+	return len;
+}
 
 SymVec RSDecoder::correctOneWord_(const SymVec& msgIn) {
 	if (msgIn.size() != getCodeLength()) throw std::logic_error("Codeword with bad length received.");
@@ -147,6 +481,16 @@ SymVec RSDecoder::correctOneWord_(const SymVec& msgIn) {
 
 	if (erasePos.size() > getParityLength()) throw std::logic_error("Too many erasures to correct.");
 
+	if ( erasePos.empty() ) {
+		Sym synd[maxParityLength];
+		std::size_t errPos[maxParityLength];
+
+		if ( ! wordSyndromes_(&msgOut[0], synd) )
+			incLastCorrectedErrors(correctWord_(&msgOut[0], synd, errPos));
+
+		return msgOut;
+	}
+
 	SymVec synd = calcSyndromes_(msgOut);
 
 	int syndSum = 0;
@@ -209,6 +553,21 @@ SymVec RSDecoder::correct(const SymVec& msgIn) {
 }
 
 SymVec RSDecoder::decode(const SymVec& msgIn) {
+	bool erasures = false;
+	for ( std::size_t i = 0; i < msgIn.size(); ++i ) erasures = erasures || ( msgIn[i] > getMaxSymbol() );
+
+	// Without erasures, correct a single copy in place rather than padding each codeword.
+	if ( ! erasures && msgIn.size() >= getTotalParityLength() ) {
+		SymVec msgOut = msgIn;
+
+		setLastCorrectedErrors(0);
+		if ( ! msgOut.empty() && ! syndromesClear(&msgOut[0], msgOut.size()) )
+			correctInPlace(&msgOut[0], msgOut.size());
+
+		msgOut.resize(msgOut.size() - getTotalParityLength());
+		return msgOut;
+	}
+
 	SymVec msgOut = correct(msgIn), msgNoVirtualFill;
 	std::size_t virtualFillOctets = getCodeLength() * getInterleaveDepth() - msgIn.size();
 
@@ -91,6 +91,25 @@ public:
 	/// @return A vector containing only the original message (minus parity).
 	SymVec decode(const NetworkData* data);
 
+	/// @brief Compute the syndromes of every interleaved codeword in one pass over
+	/// the message, keeping them for correctInPlace(). The message is not modified.
+	/// @param msg The message with parity appended, in transmitted order.
+	/// @param msgLen The number of symbols in msg.
+	/// @return True if every syndrome is zero, i.e. no errors were detected.
+	/// @throw ValueTooLarge If msgLen is longer than all the codewords together.
+	bool syndromesClear(const Sym* msg, const std::size_t msgLen);
+
+	/// @brief Correct the codewords that the last call to syndromesClear() found
+	/// errors in, rewriting only the symbols that change.
+	/// @param msg The same message that was passed to syndromesClear().
+	/// @param msgLen The number of symbols in msg.
+	/// @return The number of symbols corrected, also set in _lastCorrectedErrors.
+	/// Shortened codewords are not padded out; error positions are mapped straight
+	/// into msg, and an error located in the virtual fill makes the codeword uncorrectable.
+	/// @throw TooManyErrors If a codeword could not be corrected; the others still are.
+	/// @throw logic_error If error correction was unsuccessful for another reason.
+	std::size_t correctInPlace(Sym* msg, const std::size_t msgLen);
+
 	/// Write-only accessor to _lastCorrectedErrors.
 	void setLastCorrectedErrors(const std::size_t& newVal) {
 		_lastCorrectedErrors = newVal;
@@ -133,6 +152,48 @@ protected:
 	/// @return A vector containing the positions of erasures and errors.
 	SymVec findErrors_(const SymVec& synd, const std::size_t msgSize) const;
 
+	/// The longest parity the fixed-size decoding arrays can hold.
+	static const std::size_t maxParityLength = 255;
+
+	/// @brief Compute the syndromes of one codeword with the root product tables.
+	/// @param word A codeword of getCodeLength() symbols in conventional basis.
+	/// @param synd Receives getParityLength() syndromes.
+	/// @return True if every syndrome is zero.
+	bool wordSyndromes_(const Sym* word, Sym* synd) const;
+
+	/// @brief Find the roots of an error locator polynomial with a Chien search.
+	/// Each term is kept in a register that is multiplied by its own root power
+	/// per position, rather than evaluating the whole polynomial every time.
+	/// @param lambda The coefficients, lowest degree first; lambda[0] must be 1.
+	/// @param degree The degree of lambda.
+	/// @param errPos Receives the codeword index of each root, up to degree of them.
+	/// @param span Only the last span positions of the codeword are searched; those
+	/// in front of them are virtual fill and cannot hold errors.
+	/// @return The number of roots found.
+	std::size_t chienSearch_(const Sym* lambda, const std::size_t degree, std::size_t* errPos,
+		const std::size_t span) const;
+
+	/// @brief Locate and size the errors in one codeword with errors only (no erasures),
+	/// using Berlekamp-Massey, chienSearch_(), and Forney's algorithm on stack arrays.
+	/// Only the syndromes are needed, so the codeword itself is never assembled.
+	/// @param synd The codeword's getParityLength() syndromes, not all zero.
+	/// @param span The number of symbols actually present at the end of the codeword.
+	/// @param errPos Receives the codeword index of each error, up to getParityLength() / 2.
+	/// @param errVal Receives the value to XOR into the symbol at each errPos.
+	/// @return The number of errors found.
+	/// @throw TooManyErrors If the errors cannot all be located within span.
+	/// @throw logic_error If the error locator has a repeated root.
+	std::size_t solveErrors_(const Sym* synd, const std::size_t span, std::size_t* errPos, Sym* errVal) const;
+
+	/// @brief Correct one full-length codeword with errors only, using solveErrors_().
+	/// @param word A codeword of getCodeLength() symbols in conventional basis, corrected in place.
+	/// @param synd The codeword's getParityLength() syndromes, not all zero.
+	/// @param errPos Receives the index of each corrected symbol, up to getParityLength() / 2.
+	/// @return The number of symbols corrected.
+	/// @throw TooManyErrors If the errors cannot all be located.
+	/// @throw logic_error If the error locator has a repeated root.
+	std::size_t correctWord_(Sym* word, const Sym* synd, std::size_t* errPos) const;
+
 	/// Apply error correction to exactly one, non-interleaved codeword.
 	/// @param msgIn A codeword than may contain errors and erasures.
 	/// @return The corrected codeword.
@@ -144,6 +205,19 @@ private:
 	/// The number of errors + erasures corrected during the last correct() operation.
 	std::size_t _lastCorrectedErrors;
 
+	/// The syndromes found by the last syndromesClear(), _syndromes[j * depth + codeword].
+	std::vector<Sym> _syndromes;
+
+	/// One 256-entry table per syndrome: _rootMulTab[j * 256 + x] is x times root j.
+	std::vector<Sym> _rootMulTab;
+
+	/// The same products split by nibble for pshufb, as in RSEncoder, with one
+	/// zero root of padding.
+	std::vector<Sym> _rootNibbleLo, _rootNibbleHi;
+
+	/// Fill in the root multiplication tables.
+	void _initRootTabs();
+
 }; // class RSDecoder
 
 } // namespace nasaCE
@@ -14,8 +14,82 @@
 
 #include "RSEncoder.hpp"
 
+#ifdef RS_X86_SIMD
+#include <immintrin.h>
+#endif
+
 namespace nasaCE {
 
+#ifdef RS_X86_SIMD
+
+/// Step every codeword's register through the message, 16 products per pshufb pair.
+__attribute__((target("ssse3")))
+static void encodeLanesSSSE3(const Sym* msg, const std::size_t msgLen, const std::size_t firstLane, const std::size_t depth,
+	const std::size_t parityLen, const Sym* nibLo, const Sym* nibHi, const Sym* basisTab,
+	RSBase::LaneRegisters& reg) {
+
+	const __m128i lowMask = _mm_set1_epi8(0x0f);
+	Sym lanes[RSBase::simdLanes] __attribute__((aligned(16))) = { 0 };
+
+	// Virtual fill occupies the lanes before the first symbol and stays zero.
+	std::size_t pos = 0, lane = firstLane;
+
+	while ( pos < msgLen ) {
+		pos = RSBase::gatherLanes(msg, pos, msgLen, lane, depth, basisTab, lanes);
+		lane = 0;
+
+		const __m128i fb = _mm_xor_si128(_mm_load_si128((const __m128i*) lanes),
+			_mm_load_si128((const __m128i*) reg.rows));
+		const __m128i fbLo = _mm_and_si128(fb, lowMask);
+		const __m128i fbHi = _mm_and_si128(_mm_srli_epi64(fb, 4), lowMask);
+
+		for ( std::size_t tap = 0; tap < parityLen; ++tap ) {
+			const __m128i prod = _mm_xor_si128(
+				_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (nibLo + tap * 16)), fbLo),
+				_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (nibHi + tap * 16)), fbHi));
+
+			_mm_store_si128((__m128i*) (reg.rows + tap * RSBase::simdLanes),
+				_mm_xor_si128(_mm_load_si128((const __m128i*) (reg.rows + (tap + 1) * RSBase::simdLanes)), prod));
+		}
+	}
+}
+
+/// As encodeLanesSSSE3(), but two taps per vpshufb pair: each 128-bit half
+/// holds all the codewords and looks up its own tap's table.
+__attribute__((target("avx2")))
+static void encodeLanesAVX2(const Sym* msg, const std::size_t msgLen, const std::size_t firstLane, const std::size_t depth,
+	const std::size_t parityLen, const Sym* nibLo, const Sym* nibHi, const Sym* basisTab,
+	RSBase::LaneRegisters& reg) {
+
+	const __m256i lowMask = _mm256_set1_epi8(0x0f);
+	Sym lanes[RSBase::simdLanes] __attribute__((aligned(16))) = { 0 };
+
+	std::size_t pos = 0, lane = firstLane;
+
+	while ( pos < msgLen ) {
+		pos = RSBase::gatherLanes(msg, pos, msgLen, lane, depth, basisTab, lanes);
+		lane = 0;
+
+		const __m128i fb = _mm_xor_si128(_mm_load_si128((const __m128i*) lanes),
+			_mm_load_si128((const __m128i*) reg.rows));
+		const __m256i fb2 = _mm256_broadcastsi128_si256(fb);
+		const __m256i fbLo = _mm256_and_si256(fb2, lowMask);
+		const __m256i fbHi = _mm256_and_si256(_mm256_srli_epi64(fb2, 4), lowMask);
+
+		// An odd last pair writes the first zero row with zero, keeping it zero.
+		for ( std::size_t tap = 0; tap < parityLen; tap += 2 ) {
+			const __m256i prod = _mm256_xor_si256(
+				_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*) (nibLo + tap * 16)), fbLo),
+				_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*) (nibHi + tap * 16)), fbHi));
+
+			_mm256_store_si256((__m256i*) (reg.rows + tap * RSBase::simdLanes),
+				_mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (reg.rows + (tap + 1) * RSBase::simdLanes)), prod));
+		}
+	}
+}
+
+#endif // RS_X86_SIMD
+
 RSEncoder::RSEncoder(const int primitivePoly,
 		const std::size_t parityLength,
 		const std::size_t codeLength,
@@ -29,7 +103,7 @@ RSEncoder::RSEncoder(const int primitivePoly,
 	_rsGeneratorPoly(1,1) {
 
 	_initGeneratorPoly();
-
+	_initGenMulTab();
 }
 
 
@@ -45,6 +119,27 @@ void RSEncoder::_initGeneratorPoly() {
 	}
 }
 
+void RSEncoder::_initGenMulTab() {
+	_genMulTab.assign(getParityLength() * 256, 0);
+
+	for ( std::size_t tap = 0; tap < getParityLength(); ++tap )
+		for ( unsigned x = 1; x <= getMaxSymbol(); ++x )
+			_genMulTab[tap * 256 + x] = gfMul(_rsGeneratorPoly[tap + 1], x);
+
+	// Splitting by nibble relies on x having 8 bits; smaller fields stay scalar.
+	if ( getBitsPerSymbol() != 8 ) return;
+
+	_genNibbleLo.assign((getParityLength() + 1) * 16, 0);
+	_genNibbleHi.assign((getParityLength() + 1) * 16, 0);
+
+	for ( std::size_t tap = 0; tap < getParityLength(); ++tap ) {
+		for ( unsigned n = 0; n < 16; ++n ) {
+			_genNibbleLo[tap * 16 + n] = _genMulTab[tap * 256 + n];
+			_genNibbleHi[tap * 16 + n] = _genMulTab[tap * 256 + (n << 4)];
+		}
+	}
+}
+
 SymVec RSEncoder::encodeOneWord_(const SymVec& msgIn, bool copyOrig /* = true */) const {
 	SymVec msgOut = msgIn;
 
@@ -64,27 +159,104 @@ SymVec RSEncoder::encodeOneWord_(const SymVec& msgIn, bool copyOrig /* = true */
 }
 
 SymVec RSEncoder::encode(const SymVec& msgIn) const {
+	SymVec parity(getTotalParityLength(), 0);
+
+	encodeInPlace(msgIn.empty()? 0 : &msgIn[0], msgIn.size(), &parity[0]);
+
+	return parity;
+}
+
+void RSEncoder::encodeInPlace(const Sym* msg, const std::size_t msgLen, Sym* parity) const {
+	#ifdef RS_X86_SIMD
+	const std::size_t depth = getInterleaveDepth();
 
-	SymVec msgOut = (getDoBasisTransform())? ccsdsDualBasisToConventional(msgIn) : msgIn;
+	// A single codeword would leave 15 lanes idle, so it is faster in scalar.
+	if ( getSimdLevel() != SimdNone && ! _genNibbleLo.empty() && depth > 1 && depth <= RSBase::simdLanes ) {
+		const std::size_t parityLen = getParityLength();
+		const Sym* basisTab = getDoBasisTransform()? talTabInv_ : 0;
+		LaneRegisters reg;
 
-	std::vector<SymVec> interleavedSyms = ccsdsInterleave(msgOut);
-	std::vector<SymVec> encoded;
+		ACE_OS::memset(reg.rows, 0, (parityLen + 2) * RSBase::simdLanes);
+
+		if ( getSimdLevel() == SimdAVX2 )
+			encodeLanesAVX2(msg, msgLen, firstLane_(msgLen), depth, parityLen, &_genNibbleLo[0], &_genNibbleHi[0], basisTab, reg);
+		else
+			encodeLanesSSSE3(msg, msgLen, firstLane_(msgLen), depth, parityLen, &_genNibbleLo[0], &_genNibbleHi[0], basisTab, reg);
+
+		for ( std::size_t tap = 0; tap < parityLen; ++tap )
+			for ( std::size_t row = 0; row < depth; ++row )
+				parity[tap * depth + row] = reg.rows[tap * RSBase::simdLanes + row];
+
+		// Convert just the parity symbols to dual basis representation.
+		if ( basisTab )
+			for ( std::size_t i = 0; i < parityLen * depth; ++i ) parity[i] = talTab_[parity[i]];
+
+		return;
+	}
+	#endif
+
+	_encodeScalar(msg, msgLen, parity);
+}
 
-	std::vector<SymVec>::iterator pos;
-	for ( pos = interleavedSyms.begin(); pos != interleavedSyms.end(); ++pos )
-		encoded.push_back(encodeOneWord_(*pos, false));
+void RSEncoder::_encodeScalar(const Sym* msg, const std::size_t msgLen, Sym* parity) const {
+	const std::size_t depth = getInterleaveDepth();
+	const std::size_t parityLen = getParityLength();
+	const std::size_t lastTap = parityLen - 1;
+	const Sym* mulTab = &_genMulTab[0];
+	const bool transform = getDoBasisTransform();
 
-	SymVec parity(getParityLength() * getInterleaveDepth(), 0);
+	// The parity for codeword r, position p, lives at parity[p * depth + r], which is
+	// already its transmitted order. Each codeword's column is its shift register.
+	ACE_OS::memset(parity, 0, parityLen * depth);
 
-	for ( std::size_t parityOffset = 0; parityOffset < getParityLength(); ++parityOffset )
-		for ( std::size_t row = 0; row < getInterleaveDepth(); ++row )
-			parity[parityOffset * getInterleaveDepth() + row ] =
-				encoded[row][(getCodeLength() - getParityLength()) + parityOffset];
+	// Virtual fill is at the front of each codeword and leaves the registers at zero,
+	// so it can be skipped. What remains ends with the last symbol in the last row.
+	std::size_t row = firstLane_(msgLen);
+
+	for ( std::size_t i = 0; i < msgLen; ++i ) {
+		Sym* reg = parity + row;
+		const Sym feedback = (transform? talTabInv_[msg[i]] : msg[i]) ^ reg[0];
+
+		if ( feedback ) {
+			for ( std::size_t tap = 0; tap < lastTap; ++tap )
+				reg[tap * depth] = reg[(tap + 1) * depth] ^ mulTab[tap * 256 + feedback];
+			reg[lastTap * depth] = mulTab[lastTap * 256 + feedback];
+		}
+		else {
+			for ( std::size_t tap = 0; tap < lastTap; ++tap )
+				reg[tap * depth] = reg[(tap + 1) * depth];
+			reg[lastTap * depth] = 0;
+		}
+
+		if ( ++row == depth ) row = 0;
+	}
 
 	// Convert just the parity symbols to dual basis representation.
-	if (getDoBasisTransform()) parity = ccsdsConventionalToDualBasis(parity);
+	if ( transform )
+		for ( std::size_t i = 0; i < parityLen * depth; ++i ) parity[i] = talTab_[parity[i]];
+}
 
-	return parity;
+void RSEncoder::appendParity(NetworkData* data) const {
+	const std::size_t msgLen = data->getUnitLength();
+	const std::size_t parityLen = getTotalParityLength();
+
+	if ( msgLen > getMaxMessageLength() )
+		throw ValueTooLarge(ValueTooLarge::msg("Message length", msgLen, getMaxMessageLength()));
+
+	if ( data->reference_count() > 1 ) {
+		// The tail may belong to another unit sharing the buffer.
+		SymVec parity(parityLen, 0);
+		encodeInPlace(data->ptrUnit(), msgLen, &parity[0]);
+		data->append(&parity[0], parityLen);
+		return;
+	}
+
+	data->reserveRoom(data->getHeadroom(), parityLen);
+
+	Sym* parity = data->ptrUnit() + msgLen;
+	encodeInPlace(data->ptrUnit(), msgLen, parity);
+
+	data->extendInPlace(parityLen);
 }
 
 SymVec RSEncoder::encode(const Sym data[], const std::size_t dataLen) const {
@@ -65,6 +65,27 @@ public:
 	/// @param data NetworkData unit containing data to encode.
 	/// @return A vector containing the parity symbols.
 	SymVec encode(const NetworkData* data) const;	
+
+	/// @brief Generate parity symbols for a message directly into a caller-supplied buffer.
+	/// All interleaved codewords are encoded in a single pass over the message, so
+	/// nothing is allocated. With 8-bit symbols and an interleave depth of 2 to 16,
+	/// the codewords are stepped together in vector lanes if getSimdLevel() allows.
+	/// @param msg The message, at most getMaxMessageLength() symbols.
+	/// @param msgLen The number of symbols in msg.
+	/// @param parity Receives getTotalParityLength() symbols; must not overlap msg.
+	void encodeInPlace(const Sym* msg, const std::size_t msgLen, Sym* parity) const;
+
+	/// @brief Append the parity symbols to the end of the unit.
+	/// When the unit owns its buffer and has enough tailroom, parity is written
+	/// straight into it; otherwise the buffer is grown first.
+	/// @param data The unit containing the message.
+	/// @throw ValueTooLarge If the unit is longer than getMaxMessageLength().
+	void appendParity(NetworkData* data) const;
+
+	/// The largest message that can be encoded, in symbols.
+	std::size_t getMaxMessageLength() const {
+		return (getCodeLength() - getParityLength()) * getInterleaveDepth();
+	}
 	
 	/// Return the coefficients of the generating polynomial _rsGeneratorPoly.
 	SymVec getGeneratorPoly() const { return _rsGeneratorPoly; }
@@ -76,6 +97,21 @@ private:
 
 	/// A vector containing the coefficients of the generating polynomial.
 	SymVec _rsGeneratorPoly;
+
+	/// Fill in _genMulTab from _rsGeneratorPoly.
+	void _initGenMulTab();
+
+	/// One 256-entry table per generator tap: _genMulTab[tap * 256 + x] is the
+	/// product of x and the coefficient of tap + 1 in _rsGeneratorPoly.
+	std::vector<Sym> _genMulTab;
+
+	/// The same products split by nibble for pshufb: _genNibbleLo[tap * 16 + n] is
+	/// the product for x = n, _genNibbleHi[tap * 16 + n] for x = n << 4. Padded
+	/// with one zero tap so the AVX2 kernel can always take taps in pairs.
+	std::vector<Sym> _genNibbleLo, _genNibbleHi;
+
+	/// Run encodeInPlace() with one scalar shift register per codeword.
+	void _encodeScalar(const Sym* msg, const std::size_t msgLen, Sym* parity) const;
 	
 protected:
 
@@ -46,8 +46,10 @@ TM_Transfer_Frame::TM_Transfer_Frame(
 
 	const bool hasOperationalControl /* = false */,
 	const bool hasFrameErrorControl /* = false */,
-	const size_t secondaryHeaderLen /* = 0 */):
-	NetworkData(bufLen, frameBuf),
+	const size_t secondaryHeaderLen /* = 0 */,
+	const size_t headroom /* = 0 */,
+	const size_t tailroom /* = 0 */):
+	NetworkData(bufLen, frameBuf, headroom, tailroom),
 	_hasOperationalControl(hasOperationalControl),
 	_hasFrameErrorControl(hasFrameErrorControl),
 	_secondaryHeaderLen(secondaryHeaderLen) {
@@ -163,8 +165,9 @@ void TM_Transfer_Frame::initialize(
 
 	size_t required_size = getNonDataLength() + dataLen;
 
-	if ( getBufferSize() != required_size ) clearBuffer(required_size);
-	else clearBuffer();
+	// Work on the unit rather than the buffer so any reserved headroom is kept.
+	if ( getUnitLength() != required_size ) clearUnit(required_size);
+	else clearUnit();
 
 	setInitialized_(true);
 
@@ -63,12 +63,16 @@ public:
 	/// @param hasOperationalControl True if the frame uses an operational control field.
 	/// @param hasFrameErrorControl True when a CRC value is to be generated for the entire frame.
 	/// @param secondaryHeaderLen The length of the secondary header, if the frame needs one.
+	/// @param headroom The number of free octets to reserve before the frame.
+	/// @param tailroom The number of free octets to reserve after the frame.
 	TM_Transfer_Frame(
 		const size_t bufLen,
 		const ACE_UINT8* frameBuf = 0,
 		const bool hasOperationalControl = false,
 		const bool hasFrameErrorControl = false,
-		const size_t secondaryHeaderLen = 0
+		const size_t secondaryHeaderLen = 0,
+		const size_t headroom = 0,
+		const size_t tailroom = 0
 	);
 
 	/// Copy constructor.
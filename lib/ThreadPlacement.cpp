@@ -0,0 +1,280 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   ThreadPlacement.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "ThreadPlacement.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <pthread.h>
+#include <sstream>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// From <numaif.h>, which is only present when libnuma is installed.
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+
+namespace nasaCE {
+
+ThreadPlacement::ThreadPlacement(): haveCpuSet_(false), policy_(Other),
+	priority_(0), numaNode_(-1) {
+	CPU_ZERO(&cpuSet_);
+}
+
+bool ThreadPlacement::isDefault() const {
+	return ( ! haveCpuSet_ && policy_ == Other && numaNode_ < 0 );
+}
+
+void ThreadPlacement::setCpuList(const std::string& newVal) {
+	if ( newVal.empty() ) {
+		CPU_ZERO(&cpuSet_);
+		haveCpuSet_ = false;
+		return;
+	}
+
+	cpu_set_t cpus;
+	if ( ! parseCpuList_(newVal, cpus) ) throw BadValue(BadValue::msg("CPU list", newVal));
+
+	cpuSet_ = cpus;
+	haveCpuSet_ = true;
+}
+
+std::string ThreadPlacement::getCpuList() const {
+	return ( haveCpuSet_ )? formatCpuList_(cpuSet_) : "";
+}
+
+void ThreadPlacement::setPolicy(const Policy newVal) {
+	policy_ = newVal;
+
+	const int native = nativePolicy_(policy_);
+	if ( priority_ < sched_get_priority_min(native) || priority_ > sched_get_priority_max(native) )
+		priority_ = sched_get_priority_min(native);
+}
+
+void ThreadPlacement::setPolicy(const std::string& newVal) {
+	if ( newVal == "other" || newVal.empty() ) setPolicy(Other);
+	else if ( newVal == "fifo" ) setPolicy(Fifo);
+	else if ( newVal == "rr" ) setPolicy(RoundRobin);
+	else throw BadValue(BadValue::msg("Scheduling policy", newVal));
+}
+
+void ThreadPlacement::setPriority(const int newVal) {
+	const int native = nativePolicy_(policy_);
+	const int minPrio = sched_get_priority_min(native);
+	const int maxPrio = sched_get_priority_max(native);
+
+	// Zero is the unset default, which no real-time policy accepts.
+	if ( newVal == 0 && policy_ != Other ) {
+		priority_ = minPrio;
+		return;
+	}
+
+	if ( newVal < minPrio || newVal > maxPrio )
+		throw ValueOutOfRange(ValueOutOfRange::msg("Scheduling priority", newVal, minPrio, maxPrio));
+
+	priority_ = newVal;
+}
+
+void ThreadPlacement::setNumaNode(const int newVal) {
+	if ( newVal >= 0 ) {
+		cpu_set_t nodeCpus;
+		if ( ! readNodeCpus_(newVal, nodeCpus) ) throw BadValue(BadValue::msg("NUMA node", newVal));
+	}
+
+	numaNode_ = ( newVal < 0 )? -1 : newVal;
+}
+
+bool ThreadPlacement::applyToSelf(std::string& problems) const {
+	std::ostringstream os;
+	bool ok = true;
+
+	cpu_set_t cpus = cpuSet_;
+	bool restrictCpus = haveCpuSet_;
+
+	if ( numaNode_ >= 0 ) {
+		cpu_set_t nodeCpus;
+
+		if ( readNodeCpus_(numaNode_, nodeCpus) ) {
+			if ( restrictCpus ) {
+				CPU_AND(&cpus, &cpus, &nodeCpus);
+				if ( CPU_COUNT(&cpus) == 0 ) {
+					os << "CPU list " << formatCpuList_(cpuSet_) << " has no CPUs on NUMA node "
+						<< numaNode_ << ", using the whole node. ";
+					cpus = nodeCpus;
+					ok = false;
+				}
+			}
+			else cpus = nodeCpus;
+
+			restrictCpus = true;
+		}
+		else {
+			os << "NUMA node " << numaNode_ << " not found. ";
+			ok = false;
+		}
+
+		#ifdef SYS_set_mempolicy
+		if ( numaNode_ < static_cast<int>(sizeof(unsigned long) * 8) ) {
+			unsigned long nodeMask = 1UL << numaNode_;
+			if ( syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodeMask, sizeof(nodeMask) * 8 + 1) != 0 ) {
+				os << "Preferring memory from NUMA node " << numaNode_ << " failed: " << strerror(errno) << ". ";
+				ok = false;
+			}
+		}
+		#endif
+	}
+
+	if ( restrictCpus ) {
+		const int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+		if ( ret != 0 ) {
+			os << "Setting CPU affinity to " << formatCpuList_(cpus) << " failed: " << strerror(ret) << ". ";
+			ok = false;
+		}
+	}
+
+	if ( policy_ != Other ) {
+		sched_param param;
+		param.sched_priority = priority_;
+
+		const int ret = pthread_setschedparam(pthread_self(), nativePolicy_(policy_), &param);
+		if ( ret != 0 ) {
+			os << "Setting " << getPolicyStr() << " scheduling at priority " << priority_
+				<< " failed: " << strerror(ret) << ". ";
+			ok = false;
+		}
+	}
+
+	problems = os.str();
+	return ok;
+}
+
+ThreadPlacement ThreadPlacement::current(const ThreadPlacement& requested) {
+	ThreadPlacement placement;
+
+	cpu_set_t cpus;
+	if ( pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0 ) {
+		placement.cpuSet_ = cpus;
+		placement.haveCpuSet_ = true;
+	}
+
+	int native;
+	sched_param param;
+
+	if ( pthread_getschedparam(pthread_self(), &native, &param) == 0 ) {
+		switch (native) {
+			case SCHED_FIFO: placement.policy_ = Fifo; break;
+			case SCHED_RR: placement.policy_ = RoundRobin; break;
+			default: placement.policy_ = Other; break;
+		}
+		placement.priority_ = param.sched_priority;
+	}
+
+	placement.numaNode_ = requested.numaNode_;
+
+	return placement;
+}
+
+std::string ThreadPlacement::policyToStr(const Policy policy) {
+	switch (policy) {
+		case Fifo: return "fifo";
+		case RoundRobin: return "rr";
+		case Other: break;
+	}
+
+	return "other";
+}
+
+int ThreadPlacement::nativePolicy_(const Policy policy) {
+	switch (policy) {
+		case Fifo: return SCHED_FIFO;
+		case RoundRobin: return SCHED_RR;
+		case Other: break;
+	}
+
+	return SCHED_OTHER;
+}
+
+bool ThreadPlacement::parseCpuList_(const std::string& list, cpu_set_t& cpus) {
+	CPU_ZERO(&cpus);
+
+	long cpuLimit = sysconf(_SC_NPROCESSORS_CONF);
+	if ( cpuLimit < 1 || cpuLimit > CPU_SETSIZE ) cpuLimit = CPU_SETSIZE;
+
+	const char* pos = list.c_str();
+
+	while ( *pos ) {
+		char* end;
+		const long first = strtol(pos, &end, 10);
+		if ( end == pos ) return false;
+
+		long last = first;
+		pos = end;
+
+		if ( *pos == '-' ) {
+			++pos;
+			last = strtol(pos, &end, 10);
+			if ( end == pos ) return false;
+			pos = end;
+		}
+
+		if ( first < 0 || last < first || last >= cpuLimit ) return false;
+
+		for ( long cpu = first; cpu <= last; ++cpu ) CPU_SET(cpu, &cpus);
+
+		if ( *pos == ',' ) ++pos;
+		else if ( *pos == '\n' ) break;
+		else if ( *pos ) return false;
+	}
+
+	return ( CPU_COUNT(&cpus) > 0 );
+}
+
+std::string ThreadPlacement::formatCpuList_(const cpu_set_t& cpus) {
+	std::ostringstream os;
+	bool first = true;
+
+	for ( int cpu = 0; cpu < CPU_SETSIZE; ++cpu ) {
+		if ( ! CPU_ISSET(cpu, &cpus) ) continue;
+
+		int last = cpu;
+		while ( last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &cpus) ) ++last;
+
+		if ( ! first ) os << ",";
+		os << cpu;
+		if ( last > cpu ) os << "-" << last;
+
+		first = false;
+		cpu = last;
+	}
+
+	return os.str();
+}
+
+bool ThreadPlacement::readNodeCpus_(const int node, cpu_set_t& cpus) {
+	std::ostringstream path;
+	path << "/sys/devices/system/node/node" << node << "/cpulist";
+
+	std::ifstream in(path.str().c_str());
+	std::string list;
+
+	if ( ! in || ! std::getline(in, list) ) return false;
+
+	return parseCpuList_(list, cpus);
+}
+
+} // namespace nasaCE
@@ -0,0 +1,139 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   ThreadPlacement.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _NASA_THREAD_PLACEMENT_HPP_
+#define _NASA_THREAD_PLACEMENT_HPP_
+
+#include "nd_error.hpp"
+#include <sched.h>
+#include <string>
+
+namespace nasaCE {
+
+//=============================================================================
+/**
+ * @class ThreadPlacement
+ * @brief Where a thread may run and how the kernel schedules it.
+ *
+ * Holds a CPU set, a scheduling policy with its priority, and an optional
+ * NUMA node. Nothing happens until applyToSelf() is called from the thread
+ * being placed, which keeps thread creation itself from failing when the
+ * process lacks permission for a real-time policy.
+ *
+ * When a NUMA node is given, the thread is confined to that node's CPUs
+ * (intersected with the CPU set, if one was also given) and its new memory
+ * is preferentially allocated from that node.
+ */
+//=============================================================================
+class ThreadPlacement {
+public:
+	/// The scheduling policies that can be requested.
+	enum Policy {
+		Other,     ///< SCHED_OTHER, the default time-sharing policy.
+		Fifo,      ///< SCHED_FIFO, real-time first in, first out.
+		RoundRobin ///< SCHED_RR, real-time round robin.
+	};
+
+	/// Default constructor; leaves every aspect of placement to the kernel.
+	ThreadPlacement();
+
+	/// True if nothing has been requested, so applyToSelf() would do nothing.
+	bool isDefault() const;
+
+	/// @brief Set the CPUs the thread may run on.
+	/// @param newVal A list such as "0-3,8,10-11"; empty means any CPU.
+	/// @throw BadValue If the list cannot be parsed or names a CPU that does not exist.
+	void setCpuList(const std::string& newVal);
+
+	/// Return the CPU list in canonical form, or an empty string for any CPU.
+	std::string getCpuList() const;
+
+	/// Write-only accessor to policy_. Resets the priority if it is no longer valid.
+	void setPolicy(const Policy newVal);
+
+	/// @brief Set the policy from its name.
+	/// @param newVal One of "other", "fifo", or "rr".
+	/// @throw BadValue If the name is not recognized.
+	void setPolicy(const std::string& newVal);
+
+	/// Read-only accessor to policy_.
+	Policy getPolicy() const { return policy_; }
+
+	/// Return the name of the current policy.
+	std::string getPolicyStr() const { return policyToStr(policy_); }
+
+	/// @brief Set the priority used with the real-time policies.
+	/// @param newVal The priority; 0 with a real-time policy selects its lowest priority.
+	/// @throw ValueOutOfRange If the priority is not valid for the current policy.
+	void setPriority(const int newVal);
+
+	/// Read-only accessor to priority_.
+	int getPriority() const { return priority_; }
+
+	/// @brief Set the NUMA node to run on and allocate from.
+	/// @param newVal The node number, or -1 for no preference.
+	/// @throw BadValue If the node does not exist on this host.
+	void setNumaNode(const int newVal);
+
+	/// Read-only accessor to numaNode_.
+	int getNumaNode() const { return numaNode_; }
+
+	/// @brief Apply the placement to the calling thread.
+	/// Each aspect is attempted even if an earlier one fails.
+	/// @param problems Receives a description of anything that could not be applied.
+	/// @return True if everything requested was applied.
+	bool applyToSelf(std::string& problems) const;
+
+	/// @brief Describe where the calling thread is actually allowed to run.
+	/// The NUMA node is reported as requested, since the kernel does not bind it.
+	/// @param requested The placement that was asked for.
+	static ThreadPlacement current(const ThreadPlacement& requested);
+
+	/// Return "other", "fifo", or "rr".
+	static std::string policyToStr(const Policy policy);
+
+private:
+	/// The CPUs to run on; only meaningful if haveCpuSet_ is true.
+	cpu_set_t cpuSet_;
+
+	/// False if the thread may run on any CPU.
+	bool haveCpuSet_;
+
+	/// The requested scheduling policy.
+	Policy policy_;
+
+	/// The requested priority; always zero for the Other policy.
+	int priority_;
+
+	/// The requested NUMA node, or -1.
+	int numaNode_;
+
+	/// Translate a Policy into the SCHED_* constant.
+	static int nativePolicy_(const Policy policy);
+
+	/// Parse a list like "0-3,8" into a CPU set.
+	/// @return False if the list is malformed.
+	static bool parseCpuList_(const std::string& list, cpu_set_t& cpus);
+
+	/// Produce the canonical list for a CPU set.
+	static std::string formatCpuList_(const cpu_set_t& cpus);
+
+	/// Read the CPUs belonging to a NUMA node from sysfs.
+	/// @return False if the node does not exist.
+	static bool readNodeCpus_(const int node, cpu_set_t& cpus);
+};
+
+} // namespace nasaCE
+
+#endif // _NASA_THREAD_PLACEMENT_HPP_
@@ -26,6 +26,9 @@ AOS_Mux_Base::AOS_Mux_Base(const std::string& newName, const std::string& newCha
 		defaultPrioritySetting_(CEcfg::instance()->getOrAddInt(cfgKey("defaultMuxPriority"), defaultPriority_)),
 		prioritiesSetting_(CEcfg::instance()->getOrAddList(cfgKey("channelID_Priorities"))) {
 
+	// Many inputs feed one queue in priority order, which a ring can't do.
+	useRingQueue_(false);
+
 	defaultPriority_ = defaultPrioritySetting_;
 
 	for ( int idx = 0; idx < prioritiesSetting_.getLength(); ++idx ) {
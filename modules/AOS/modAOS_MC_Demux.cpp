@@ -32,48 +32,56 @@ int modAOS_MC_Demux::svc() {
 
 	AOS_Transfer_Frame* aos = 0;
 	HandlerLinkMap::iterator outputLink;
+	std::vector<NetworkData*> batch;
+	HandlerLinkBatch outputs;
 
 	while ( continueService() ) {
-		ndSafeRelease(aos);
-
-		std::pair<NetworkData*, int> queueTop = getData_();
-
-		if ( msg_queue()->deactivated() ) break;
+		const int queued = getDataBatch_(batch, getMaxBatchUnits());
 
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
-		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
-			continue;
+		if ( msg_queue()->deactivated() ) {
+			releaseBatch_(batch);
+			break;
 		}
 
-		aos = dynamic_cast<AOS_Transfer_Frame*>(queueTop.first);
-
-		if ( ! aos ) {
-			MOD_INFO("Received %d octets of non-AOS data! Dropping.", queueTop.first->getUnitLength());
-			ndSafeRelease(queueTop.first);
-			queueTop.first = 0;
+		if ( queued < 0 ) {
+			MOD_ERROR("getDataBatch_() call failed.");
 			continue;
 		}
 
-		MOD_DEBUG("Received %d octets to demultiplex.", aos->getUnitLength());
-
-		// Test expected values.
-		if ( ! validateFrame(aos) ) {
-			if (getDropBadFrames()) continue;
+		for ( size_t idx = 0; idx < batch.size(); ++idx ) {
+			ndSafeRelease(aos);
+
+			aos = dynamic_cast<AOS_Transfer_Frame*>(batch[idx]);
+
+			if ( ! aos ) {
+				MOD_INFO("Received %d octets of non-AOS data! Dropping.", batch[idx]->getUnitLength());
+				ndSafeRelease(batch[idx]);
+				batch[idx] = 0;
+				continue;
+			}
+
+			MOD_DEBUG("Received %d octets to demultiplex.", aos->getUnitLength());
+
+			// Test expected values.
+			if ( ! validateFrame(aos) ) {
+				if (getDropBadFrames()) continue;
+			}
+			else { incValidFrameCount(); }
+
+			if ( ( outputLink = primaryOutputLinks_.find(aos->getSpacecraftID())) != primaryOutputLinks_.end() ) {
+				MOD_DEBUG("Sending %d octets.", aos->getUnitLength());
+				outputs.add(outputLink->second, aos);
+				aos = 0; // important
+			}
+			else {
+				MOD_NOTICE("No output target defined for MCID %d, dropping data.", aos->getMCID());
+			}
 		}
-		else { incValidFrameCount(); }
 
-		if ( ( outputLink = primaryOutputLinks_.find(aos->getSpacecraftID())) != primaryOutputLinks_.end() ) {
-			MOD_DEBUG("Sending %d octets.", aos->getUnitLength());
-			outputLink->second->send(aos);
-			aos = 0; // important
-		}
-		else {
-			MOD_NOTICE("No output target defined for MCID %d, dropping data.", aos->getMCID());
-		}
+		// Release the last unit if it was dropped, and pass on what's pending.
+		ndSafeRelease(aos);
+		batch.clear();
+		outputs.flush();
 	}
 
 	return svcEnd_();
@@ -165,7 +165,10 @@ AOS_Multiplexing_PDU* modAOS_M_PDU_Add::_processData(NetworkData* netdata) {
 				return 0;
 			}
 
-			mpdu = new AOS_Multiplexing_PDU(get_M_PDU_Length());
+			// The Packet Zone is always completely filled with packets or Fill
+			// before sending, so only the header needs clearing.
+			mpdu = new AOS_Multiplexing_PDU(get_M_PDU_Length(), NetworkData::noFill);
+			ACE_OS::memset(mpdu->ptrHeader(), 0, AOS_Multiplexing_PDU::spanHeader);
 			_firstHeaderIndexSet = false;
 			mpdu_idx = 0;
 			++mpdu_count;
@@ -247,7 +250,7 @@ AOS_Multiplexing_PDU* modAOS_M_PDU_Add::_processData(NetworkData* netdata) {
 		if ( ! _sendImmediately ) last_mpdu = ((AOS_Multiplexing_PDU*) mpdu_list->tail());
 		else last_mpdu = mpdu;
 
-		ACE_Time_Value timeToWaitUntil(ACE_High_Res_Timer::gettimeofday_hr() + getWaitForNextPacket());
+		ACE_Time_Value timeToWaitUntil(ClockService::instance()->preciseNow() + getWaitForNextPacket());
 
 		// If multiple packets in the Packet Zone are disallowed, or we're not sending the M_PDUs in
 		// "groups" (_sendImmediately is false), or there's nothing left in the message queue, fill
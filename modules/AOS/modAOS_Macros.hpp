@@ -46,6 +46,7 @@ public:
 	bool useFrameEC;
 	bool useASM;
 	bool usePseudoRandomize;
+	bool fuseCoding;
 	bool minimize;
 	std::string segNamePrefix;
 	std::string segNameSuffix;
@@ -30,55 +30,62 @@ int modAOS_VC_Demux::svc() {
 	svcStart_();
 	AOS_Transfer_Frame* aos = 0;
 	HandlerLinkMap::iterator outputLink;
+	std::vector<NetworkData*> batch;
+	HandlerLinkBatch outputs;
 
 	while ( continueService() ) {
-		ndSafeRelease(aos);
-
-		bool frameIsValid = true;
-
-		std::pair<NetworkData*, int> queueTop = getData_();
-
-		if ( msg_queue()->deactivated() ) break;
+		const int queued = getDataBatch_(batch, getMaxBatchUnits());
 
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
+		if ( msg_queue()->deactivated() ) {
+			releaseBatch_(batch);
+			break;
 		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
+
+		if ( queued < 0 ) {
+			MOD_ERROR("getDataBatch_() call failed.");
 			continue;
 		}
 
-		aos = dynamic_cast<AOS_Transfer_Frame*>(queueTop.first);
+		for ( size_t idx = 0; idx < batch.size(); ++idx ) {
+			ndSafeRelease(aos);
+			bool frameIsValid = true;
 
-		if ( ! aos ) {
-			MOD_INFO("Received %d octets of non-AOS data! Dropping.", queueTop.first->getUnitLength());
-			ndSafeRelease(queueTop.first);
-			continue;
-		}
+			aos = dynamic_cast<AOS_Transfer_Frame*>(batch[idx]);
 
-		MOD_DEBUG("Received %d octets to demultiplex.", aos->getTotalUnitLength());
+			if ( ! aos ) {
+				MOD_INFO("Received %d octets of non-AOS data! Dropping.", batch[idx]->getUnitLength());
+				ndSafeRelease(batch[idx]);
+				continue;
+			}
 
-		// Test expected values.
-		if ( ! validateFrame(aos) ) continue;
+			MOD_DEBUG("Received %d octets to demultiplex.", aos->getTotalUnitLength());
 
-		if ( aos->getMCID() != getMCID() ) {
-			MOD_WARNING("Received Frame with wrong MCID, 0x%X instead of 0x%X. Dropping.", aos->getMCID(), getMCID());
-			incBadMCIDCount();
-			frameIsValid = false;
-			if ( getDropBadFrames() ) continue;
-		}
+			// Test expected values.
+			if ( ! validateFrame(aos) ) continue;
 
-		if ( frameIsValid ) incValidFrameCount();
+			if ( aos->getMCID() != getMCID() ) {
+				MOD_WARNING("Received Frame with wrong MCID, 0x%X instead of 0x%X. Dropping.", aos->getMCID(), getMCID());
+				incBadMCIDCount();
+				frameIsValid = false;
+				if ( getDropBadFrames() ) continue;
+			}
 
-		if ( ( outputLink = primaryOutputLinks_.find(aos->getVirtualChannelID())) != primaryOutputLinks_.end() ) {
-			MOD_DEBUG("Sending %d octets.", aos->getTotalUnitLength());
-			outputLink->second->send(aos);
-			aos = 0; // important
-		}
-		else {
-			MOD_NOTICE("No output target defined for VCID %d, dropping data.", aos->getVirtualChannelID());
+			if ( frameIsValid ) incValidFrameCount();
+
+			if ( ( outputLink = primaryOutputLinks_.find(aos->getVirtualChannelID())) != primaryOutputLinks_.end() ) {
+				MOD_DEBUG("Sending %d octets.", aos->getTotalUnitLength());
+				outputs.add(outputLink->second, aos);
+				aos = 0; // important
+			}
+			else {
+				MOD_NOTICE("No output target defined for VCID %d, dropping data.", aos->getVirtualChannelID());
+			}
 		}
+
+		// Release the last unit if it was dropped, and pass on what's pending.
+		ndSafeRelease(aos);
+		batch.clear();
+		outputs.flush();
 	}
 
 	return svcEnd_();
@@ -65,7 +65,9 @@ int modAOS_VC_Gen::svc() {
 				getUseHeaderErrorControl(), // all frames in MC use header error control or not.
 				getInsertZoneSize(), // all frames in MC have Insert Zone, or not
 				getUseOperationalControl(), // existance of OCF is VC dependent
-				getUseFrameErrorControl() // all frames in MC have frame CRC, or not
+				getUseFrameErrorControl(), // all frames in MC have frame CRC, or not
+				getReservedHeadroom(), // room for layers added later in the channel
+				getReservedTailroom()
 			);
 
 			if (! aos) throw nd_error("Unable to allocate an AOS_Transfer_Frame!");
@@ -22,7 +22,7 @@ modASM_Add::modASM_Add(const std::string& newName, const std::string& newChannel
     	 const CE_DLL* newDLLPtr):
 	BaseTrafficHandler(newName, newChannelName, newDLLPtr),
 	_marker(CEcfg::instance()->getOrAddArray(cfgKey("markerPattern"))),
-	_rebuildMarker(true), _asmCount(0) {
+	_rebuildMarker(true), _markerBuf(0), _markerLen(0), _asmCount(0) {
 
 	if ( _marker.getLength() == 0 ) {
 		uint8_t defaultPattern[] = { 0x1A, 0xCF, 0xFC, 0x1D };
@@ -35,6 +35,9 @@ modASM_Add::modASM_Add(const std::string& newName, const std::string& newChannel
 
 modASM_Add::~modASM_Add() {
 	MOD_DEBUG("Running ~modASM_Add().");
+	stopTraffic();
+
+	delete[] _markerBuf;
 }
 
 void modASM_Add::setMarker(const uint8_t* asmBuf, const int bufLen) {
@@ -93,64 +96,41 @@ void modASM_Add::_updateMarker(ACE_UINT8*& buffer, size_t& bufferLen) {
 }
 
 int modASM_Add::svc() {
-	svcStart_();
-
-	ACE_UINT8* markerBuf = 0;
-	size_t markerLen = 0;
-	_rebuildMarker = true;
+	return transformLoop_();
+}
 
-	while ( continueService() ) {
-		std::pair<NetworkData*, int> queueTop = getData_();
-
-		if ( msg_queue()->deactivated() ) break;
-
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
-		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
-			continue;
-		}
-
-		NetworkData* data = queueTop.first;
-
-		if ( data->getUnitLength() ) {
-
-			_updateMarker(markerBuf, markerLen);
-
-			MOD_DEBUG("Received a %d-octet %s to prepend a %d-octet ASM to.",
-				data->getUnitLength(), data->typeStr().c_str(), markerLen);
-
-			if (markerLen) {
-				// Create a new unit with the ASM at the beginning.
-				NetworkData* newData = new NetworkData(data->getUnitLength() + markerLen);
-				if ( ! newData ) throw OutOfMemory("modASM_Add::svc(): Failed to allocate memory for NetworkData object.");
-				newData->copyUnit(newData->ptrUnit(), markerBuf, markerLen);
-				newData->copyUnit(newData->ptrUnit() + markerLen, data);
-				ndSafeRelease(data);
-				data = newData;
-				_asmCount++;
-			}
-
-			if ( links_[PrimaryOutputLink] ) {
-				MOD_DEBUG("Sending %d octets.", data->getUnitLength());
-				links_[PrimaryOutputLink]->send(data);
-			}
-			else {
-				MOD_NOTICE("No output target defined yet, dropping data.");
-				ndSafeRelease(data);
-			}
-		}
-		else {
-			MOD_INFO("Received null data.");
-		}
+NetworkData* modASM_Add::transformUnit_(NetworkData* data) {
+	if ( ! data->getUnitLength() ) {
+		MOD_INFO("Received null data.");
+		ndSafeRelease(data);
+		return 0;
 	}
 
-	delete[] markerBuf;
+	_updateMarker(_markerBuf, _markerLen);
+
+	MOD_DEBUG("Received a %d-octet %s to prepend a %d-octet ASM to.",
+		data->getUnitLength(), data->typeStr().c_str(), _markerLen);
+
+	if ( ! _markerLen ) return data;
+
+	NetworkData* newData;
+
+	if ( data->prependInPlace(_markerBuf, _markerLen) ) {
+		// The ASM went into reserved headroom; just rewrap the unit.
+		newData = data->wrapOuterPDU<NetworkData>();
+	}
+	else {
+		// Create a new unit with the ASM at the beginning.
+		newData = new NetworkData(data->getUnitLength() + _markerLen);
+		if ( ! newData ) throw OutOfMemory("modASM_Add::transformUnit_(): Failed to allocate memory for NetworkData object.");
+		newData->copyUnit(newData->ptrUnit(), _markerBuf, _markerLen);
+		newData->copyUnit(newData->ptrUnit() + _markerLen, data);
+	}
 
-	return svcEnd_();
+	ndSafeRelease(data);
+	_asmCount++;
 
+	return newData;
 }
 
 }
@@ -41,6 +41,9 @@ public:
 	/// Reads in some data and looks for sync markers.
 	int svc();
 
+	/// Every unit gets the same marker, so units can be handled on any thread.
+	bool supportsInline() const { return true; }
+
 	/// Set the contents of _marker.
 	/// @param asmBuf The buffer holding the new marker.
 	/// @param bufLen The length of the pattern in the buffer.
@@ -64,6 +67,10 @@ public:
 		return _asmCount;
 	}
 
+protected:
+	/// Prepend the marker to the unit, in place if there is headroom.
+	NetworkData* transformUnit_(NetworkData* data);
+
 private:
 	/// The type of ASM marker.
 	Setting& _marker;
@@ -71,6 +78,12 @@ private:
 	/// Whether _marker has been updated or the ASM buffer otherwise needs to be (re)created.
 	bool _rebuildMarker;
 
+	/// The marker octets, copied out of _marker by _updateMarker().
+	ACE_UINT8* _markerBuf;
+
+	/// The length of _markerBuf.
+	size_t _markerLen;
+
 	/// Create a buffer with the contents of the new marker.
 	/// @param buffer Deleted if not null. Then a new buffer is allocated and filled.
 	/// @param bufferLen Receives the new marker length.
@@ -14,7 +14,6 @@
 
 #include "modASM_Remove.hpp"
 #include "NetworkData.hpp"
-#include <bitset>
 
 namespace nASM_Remove {
 
@@ -26,18 +25,22 @@ modASM_Remove::modASM_Remove(const std::string& newName, const std::string& newC
 	_expectedUnitLengthSetting(CEcfg::instance()->getOrAddInt(cfgKey("expectedUnitLength"), _expectedUnitLength)),
 	_allowedMarkerBitErrors(0),
 	_allowedMarkerBitErrorsSetting(CEcfg::instance()->getOrAddInt(cfgKey("allowedMarkerBitErrors"), 0)),
+	_acceptInvertedMarker(CEcfg::instance()->getOrAddBool(cfgKey("acceptInvertedMarker"), false)),
+	_checkThresholdSetting(CEcfg::instance()->getOrAddInt(cfgKey("checkThreshold"), 1)),
+	_flywheelThresholdSetting(CEcfg::instance()->getOrAddInt(cfgKey("flywheelThreshold"), 2)),
 	_rebuildMarker(true),
 	_currentBitErrors(0),
 	_asmCount(0),
 	_asmValidCount(0),
 	_asmMissedCount(0),
-	_asmSearchCount(0),
 	_asmDiscoveredCount(0),
 	_asmBitErrorsAllowed(0),
 	_asmBitErrorsRejected(0),
 	_asmAllowedWithBitErrorsCount(0),
 	_asmRejectedWithBitErrorsCount(0),
-	_asmPartialMismatch(0) {
+	_asmPartialMismatch(0),
+	_asmBitSlipCount(0),
+	_asmInvertedCount(0) {
 
 	if ( _marker.getLength() == 0 ) {
 		uint8_t defaultPattern[] = { 0x1A, 0xCF, 0xFC, 0x1D };
@@ -45,7 +48,10 @@ modASM_Remove::modASM_Remove(const std::string& newName, const std::string& newC
 	}
 
 	_allowedMarkerBitErrors = _allowedMarkerBitErrorsSetting;
+	setCheckThreshold(_checkThresholdSetting);
+	setFlywheelThreshold(_flywheelThresholdSetting);
 	_expectedUnitLength = _expectedUnitLengthSetting;
+	if ( _expectedUnitLength > 0 ) NetworkDataPool::instance()->addSizeClass(_expectedUnitLength);
 
 	MOD_DEBUG("Initializing with a %d-octet sync marker.", _marker.getLength());
 }
@@ -88,21 +94,16 @@ void modASM_Remove::getMarker(std::vector<uint8_t>& marker) const {
 		marker.push_back(static_cast<int>(_marker[i]) & 0xFF);
 }
 
-void modASM_Remove::_updateMarker(ACE_UINT8*& buffer, size_t& bufferLen) {
+void modASM_Remove::_updateMarker() {
 	if ( ! _rebuildMarker ) return;
 
-	delete[] buffer;
-
-	bufferLen = _marker.getLength();
-	buffer = new ACE_UINT8[bufferLen];
-
-	for (unsigned i = 0; i < bufferLen; i++) {
-		buffer[i] = static_cast<int>(_marker[i]);
-	}
+	std::vector<uint8_t> marker;
+	getMarker(marker);
 
+	_sync.setMarker(&marker[0], marker.size());
 	_rebuildMarker = false;
 
-	MOD_DEBUG("Updated marker to %d-octet buffer.", bufferLen);
+	MOD_DEBUG("Updated marker to %d-octet buffer.", marker.size());
 }
 
 void modASM_Remove::_send(NetworkData*& goodUnit) {
@@ -118,19 +119,51 @@ void modASM_Remove::_send(NetworkData*& goodUnit) {
 	goodUnit = 0;
 }
 
+NetworkData* modASM_Remove::_realign(NetworkData* data, const unsigned shift, const bool inverted,
+	ACE_UINT8& carry) {
+
+	NetworkData* aligned = new NetworkData(data->getUnitLength(), NetworkData::noFill);
+	AsmCorrelator::realign(aligned->ptrUnit(), data->ptrUnit(), data->getUnitLength(), shift, inverted, carry);
+
+	return aligned;
+}
+
+void modASM_Remove::_countMarker(const bool discovered) {
+	MOD_DEBUG("Found ASM.");
+	_asmCount++;
+
+	if ( discovered ) _asmDiscoveredCount++;
+	else _asmValidCount++;
+
+	_currentBitErrors = 0;
+}
+
 int modASM_Remove::svc() {
 	svcStart_();
-	ACE_UINT8* markerBuf = 0;
+	AsmCorrelator& correlator = _sync.getCorrelator();
+	const ACE_UINT8* markerBuf = 0;
 	size_t markerLen = 0;
 	_rebuildMarker = true;
 	NetworkData* data = 0;
+	NetworkData* aligned = 0;
 	NetworkData* goodUnit = 0;
 	size_t goodUnitLength = 0;
+	size_t alignedLen = 0;
 	size_t advanceLen = 0;
 	size_t remainingLen = 0;
 	size_t partialMarkerLen = 0;
+	size_t testLen = 0;
 	size_t markerOffset = 0;
-	bool searching = false;
+	bool searching = true;
+	bool discovered = false;
+	bool flywheeling = false;
+	bool realigning = false;
+	unsigned shift = 0;
+	bool inverted = false;
+	ACE_UINT8 carry = 0;
+	AsmCorrelator::Match match;
+
+	_sync.startSearch();
 
 	while ( continueService() ) {
 		std::pair<NetworkData*, int> queueTop = getData_();
@@ -148,99 +181,166 @@ int modASM_Remove::svc() {
 
 		data = queueTop.first;
 
-		_updateMarker(markerBuf, markerLen);
+		_updateMarker();
+		markerBuf = &_sync.getMarker()[0];
+		markerLen = _sync.getMarkerLen();
+		_sync.setCheckThreshold(getCheckThreshold());
+		_sync.setFlywheelThreshold(getFlywheelThreshold());
 
 		MOD_DEBUG("Received a %d-octet unit to test for ASMs.", data->getUnitLength());
 
 		while ( data->getUnitLength() ) {
-			if ( ! goodUnit ) { // no unit to continue, need to find next ASM
-				partialMarkerLen = markerLen - markerOffset;
-
-				// determine if enough buffer left to find ASM
-				// if not, check what's left and check for remainder in next buffer
-				if ( data->getUnitLength() < partialMarkerLen ) {
-					if ( _markerMatch(data->ptrUnit(), markerBuf + markerOffset, data->getUnitLength()) ) {
-						// this portion is correct
-						markerOffset += data->getUnitLength();
-					}
-					else {
-						MOD_DEBUG("Missed partial ASM, resetting marker offset and bit error count.");
-						incPartialMismatchCount();
-						markerOffset = 0;
-						_currentBitErrors = 0;
-					}
+			if ( searching ) { // out of sync, correlate at every bit offset
+				correlator.setAllowedBitErrors(_allowedMarkerBitErrors);
+				correlator.setAcceptInverted(getAcceptInvertedMarker());
+
+				if ( ! correlator.search(data->ptrUnit(), data->getUnitLength(), match) ) {
+					data->rd_ptr(data->getUnitLength());
+					break;
+				}
+
+				MOD_DEBUG("Correlated %sASM with %d bit errors, stream offset by %d bits.",
+					( match.inverted? "inverted " : "" ), match.bitErrors, match.shift);
+
+				searching = false;
+				discovered = true;
+				shift = match.shift;
+				inverted = match.inverted;
+				carry = *(data->ptrUnit() + match.endOctet);
+				markerOffset = correlator.getPatternLen();
+				_currentBitErrors = match.bitErrors;
+
+				if ( shift ) _asmBitSlipCount++;
+				if ( inverted ) _asmInvertedCount++;
+
+				if ( match.bitErrors ) {
+					incAsmBitErrorsAllowed(match.bitErrors);
+					incAllowedWithBitErrorsCount();
+				}
 
-					advanceLen = data->getUnitLength();
+				// A marker longer than the correlator is finished below, once aligned.
+				if ( markerOffset == markerLen ) {
+					_countMarker(discovered);
+					_sync.markerFound(discovered);
 				}
-				// if so, look for ASM normally
-				else if ( _markerMatch(data->ptrUnit(), markerBuf + markerOffset, partialMarkerLen) ) {
-					MOD_DEBUG("Found ASM.");
-					_asmCount++;
 
-					if ( searching ) _asmDiscoveredCount++;
-					else _asmValidCount++;
+				data->rd_ptr(match.endOctet + 1);
+				continue;
+			}
 
-					searching = false;
-					advanceLen = partialMarkerLen;
-					markerOffset = 0;
-					_currentBitErrors = 0;
+			// In sync; work through an octet-aligned view of the rest of the block.
+			realigning = ( shift || inverted );
+			aligned = realigning? _realign(data, shift, inverted, carry) : data;
+			alignedLen = aligned->getUnitLength();
+
+			while ( ! searching && aligned->getUnitLength() ) {
+				// When locked with a whole marker and frame in the buffer, just verify the
+				// marker and jump over both.
+				if ( ! goodUnit && markerOffset == 0 && _sync.getState() == FrameSynchronizer::Lock &&
+					aligned->getUnitLength() >= markerLen + getExpectedUnitLength() &&
+					! memcmp(aligned->ptrUnit(), markerBuf, markerLen) ) {
+					_countMarker(false);
+					goodUnit = aligned->wrapInnerPDU<NetworkData>(getExpectedUnitLength(),
+						aligned->ptrUnit() + markerLen);
+					_send(goodUnit);
+					aligned->rd_ptr(markerLen + getExpectedUnitLength());
+					continue;
+				}
 
+				if ( ! goodUnit ) { // no unit to continue, need the next ASM
+					if ( markerOffset < markerLen ) {
+						partialMarkerLen = markerLen - markerOffset;
+						testLen = ( aligned->getUnitLength() < partialMarkerLen )? aligned->getUnitLength() :
+							partialMarkerLen;
+
+						if ( ! flywheeling && ! _markerMatch(aligned->ptrUnit(), markerBuf + markerOffset, testLen) ) {
+							if ( testLen < partialMarkerLen ) incPartialMismatchCount();
+							if ( ! discovered ) _asmMissedCount++;
+
+							// Past a missed marker, the rest of it is skipped unexamined.
+							if ( ! discovered && _sync.markerMissed() ) {
+								flywheeling = true;
+							}
+							else {
+								MOD_DEBUG("Missed ASM, searching at every bit offset.");
+								_sync.startSearch();
+								searching = true;
+								markerOffset = 0;
+								_currentBitErrors = 0;
+								break;
+							}
+						}
+
+						markerOffset += testLen;
+						advanceLen = testLen;
+
+						if ( markerOffset == markerLen ) {
+							if ( flywheeling ) {
+								flywheeling = false;
+								_currentBitErrors = 0;
+							}
+							else {
+								_countMarker(discovered);
+								_sync.markerFound(discovered);
+							}
+						}
+					}
 					// determine if entire unit can be extracted from buffer
 					// if so, wrap and send
-                    if ( data->getUnitLength() - partialMarkerLen >= getExpectedUnitLength() ) {
+					else if ( aligned->getUnitLength() >= getExpectedUnitLength() ) {
 						MOD_DEBUG("Found complete unit.");
-						goodUnit = data->wrapInnerPDU<NetworkData>(getExpectedUnitLength(),
-							data->ptrUnit() + partialMarkerLen);
+						goodUnit = aligned->wrapInnerPDU<NetworkData>(getExpectedUnitLength(), aligned->ptrUnit());
 						_send(goodUnit);
-						advanceLen += getExpectedUnitLength();
-                    }
-					// if not, create a new unit to hold it
+						advanceLen = getExpectedUnitLength();
+						markerOffset = 0;
+						discovered = false;
+					}
+					// if not, hold on to a slice of it and add slices of the following blocks
 					else {
 						MOD_DEBUG("Holding partial unit for expected completion.");
-						goodUnitLength = data->getUnitLength() - partialMarkerLen;
-						goodUnit = new NetworkData(getExpectedUnitLength());
-						goodUnit->copyUnit(goodUnit->ptrUnit(), data->ptrUnit() + partialMarkerLen, goodUnitLength);
-						advanceLen += goodUnitLength;
-					};
-				}
-				else {
-					MOD_DEBUG("Missed ASM, advancing one octet at a time.");
-					if (! searching ) _asmMissedCount++; // Only increment for the first miss, or after another ASM was found.
-					searching = true;
-					incSearchCount();
-
-					// data->dump();
-					advanceLen = 1;
-					markerOffset = 0;
-					_currentBitErrors = 0;
-				}
-			}
-			else { // continuing previous unit, don't look for ASM
-				remainingLen = getExpectedUnitLength() - goodUnitLength;
-				// determine if remaining unit fits in buffer
-				// if so, append it and send, reset goodUnit to 0
-				if ( data->getUnitLength() >= remainingLen ) {
-					MOD_DEBUG("Completing partial unit with newly received data.");
-					goodUnit->copyUnit(goodUnit->ptrUnit() + goodUnitLength, data->ptrUnit(),
-						remainingLen);
-					_send(goodUnit);
-					advanceLen = remainingLen;
+						goodUnitLength = aligned->getUnitLength();
+						goodUnit = aligned->wrapInnerPDU<NetworkData>(goodUnitLength, aligned->ptrUnit());
+						advanceLen = goodUnitLength;
+					}
 				}
+				else { // continuing previous unit, don't look for ASM
+					remainingLen = getExpectedUnitLength() - goodUnitLength;
+					// determine if remaining unit fits in buffer
+					// if so, append it and send, reset goodUnit to 0
+					if ( aligned->getUnitLength() >= remainingLen ) {
+						MOD_DEBUG("Completing partial unit with newly received data.");
+						goodUnit->tail()->setNextPart(aligned->wrapInnerPDU<NetworkData>(remainingLen,
+							aligned->ptrUnit()));
+						_send(goodUnit);
+						advanceLen = remainingLen;
+						markerOffset = 0;
+						discovered = false;
+					}
 
-				// if not, append it and don't send
-				else {
-					MOD_DEBUG("Adding to partial unit but will complete later.");
+					// if not, append it and don't send
+					else {
+						MOD_DEBUG("Adding to partial unit but will complete later.");
 
-					goodUnit->copyUnit(goodUnit->ptrUnit() + goodUnitLength, data->ptrUnit(),
-						data->getUnitLength());
-					goodUnitLength += data->getUnitLength();
-					advanceLen = data->getUnitLength();
+						goodUnit->tail()->setNextPart(aligned->wrapInnerPDU<NetworkData>(aligned->getUnitLength(),
+							aligned->ptrUnit()));
+						goodUnitLength += aligned->getUnitLength();
+						advanceLen = aligned->getUnitLength();
+					}
 				}
+
+				// advance read pointer by length just used up
+				aligned->rd_ptr(advanceLen);
+				MOD_DEBUG("Buffer length is now %d.", aligned->getUnitLength());
+			}
+
+			// Aligned octet n came mostly from received octet n, so a new search starts
+			// there; the few bits it skips belonged to the marker that was just missed.
+			if ( realigning ) {
+				data->rd_ptr(alignedLen - aligned->getUnitLength());
+				ndSafeRelease(aligned);
 			}
 
-			// advance read pointer by length just used up
-			data->rd_ptr(advanceLen);
-			MOD_DEBUG("Buffer length is now %d.", data->getUnitLength());
+			aligned = 0;
 		}
 
 		ndSafeRelease(data);
@@ -263,17 +363,13 @@ bool modASM_Remove::_markerMatch(const ACE_UINT8* ptrUnitBuf, const ACE_UINT8* p
 	if ( _allowedMarkerBitErrors == 0 ) return false;
 
 	// Determine if there are only a few mismatched bits in the marker.
-	for ( size_t offset = 0; offset < testLen; ++offset ) {
-		// Use XOR to get mismatched bits.
-		std::bitset<8> testOctet(*(ptrUnitBuf + offset) ^ *(ptrMarkerBuf + offset));
-		_currentBitErrors += testOctet.count();
-
-		if ( _currentBitErrors > _allowedMarkerBitErrors ) {
-			incAsmBitErrorsRejected(_currentBitErrors);
-			incRejectedWithBitErrorsCount();
-			MOD_DEBUG("Too many wrong ASM bits (%d allowed), signaling mismatch.", _allowedMarkerBitErrors);
-			return false;
-		}
+	_currentBitErrors += AsmCorrelator::countBitErrors(ptrUnitBuf, ptrMarkerBuf, testLen);
+
+	if ( _currentBitErrors > _allowedMarkerBitErrors ) {
+		incAsmBitErrorsRejected(_currentBitErrors);
+		incRejectedWithBitErrorsCount();
+		MOD_DEBUG("Too many wrong ASM bits (%d allowed), signaling mismatch.", _allowedMarkerBitErrors);
+		return false;
 	}
 
 	// Found a match with only a few errors.
@@ -16,6 +16,7 @@
 #define _MOD_ASM_REMOVE_HPP_
 
 #include "BaseTrafficHandler.hpp"
+#include "FrameSynchronizer.hpp"
 
 namespace nASM_Remove {
 
@@ -24,6 +25,13 @@ namespace nASM_Remove {
 	@class modASM_Remove
 	@author Tad Kollar  
 	@brief Remove the ASM markers from a traffic stream.
+
+	A frame synchronizer with the SEARCH, CHECK, LOCK, and FLYWHEEL states
+	described in FrameSynchronizer.
+
+	Frames are slices of the received blocks. One that spans blocks is sent as a
+	chain of slices linked with setNextPart(); it's only copied into one buffer
+	if the next segment doesn't acceptsChainedUnits().
 */
 //=============================================================================
 class modASM_Remove: public BaseTrafficHandler {
@@ -58,6 +66,7 @@ public:
 	void setExpectedUnitLength(const int& newVal) {
 		_expectedUnitLength = newVal;
 		_expectedUnitLengthSetting = newVal;
+		if ( newVal > 0 ) NetworkDataPool::instance()->addSizeClass(newVal);
 	}
 
 	/// Read-only accessor to _expectedUnitLength.
@@ -74,6 +83,42 @@ public:
 		return _allowedMarkerBitErrors;
 	}
 
+	/// Write-only accessor to _acceptInvertedMarker; off unless enabled.
+	void setAcceptInvertedMarker(const bool newVal) {
+		_acceptInvertedMarker = newVal;
+	}
+
+	/// Read-only accessor to _acceptInvertedMarker.
+	bool getAcceptInvertedMarker() const {
+		return _acceptInvertedMarker;
+	}
+
+	/// Write-only accessor to _checkThresholdSetting.
+	/// @throw ValueTooSmall If newVal is negative.
+	void setCheckThreshold(const int newVal) {
+		if ( newVal < 0 ) throw ValueTooSmall(ValueTooSmall::msg("Check threshold", newVal, 0));
+		_checkThresholdSetting = newVal;
+	}
+
+	/// Read-only accessor to _checkThresholdSetting.
+	int getCheckThreshold() const { return _checkThresholdSetting; }
+
+	/// Write-only accessor to _flywheelThresholdSetting.
+	/// @throw ValueTooSmall If newVal is negative.
+	void setFlywheelThreshold(const int newVal) {
+		if ( newVal < 0 ) throw ValueTooSmall(ValueTooSmall::msg("Flywheel threshold", newVal, 0));
+		_flywheelThresholdSetting = newVal;
+	}
+
+	/// Read-only accessor to _flywheelThresholdSetting.
+	int getFlywheelThreshold() const { return _flywheelThresholdSetting; }
+
+	/// The current synchronizer state.
+	FrameSynchronizer::State getSyncState() const { return _sync.getState(); }
+
+	/// The name of the current synchronizer state.
+	std::string getSyncStateName() const { return _sync.getStateName(); }
+
 	/// Write-only accessor to _asmCount.
 	void setAsmCount(const uint64_t& newVal) {
 		_asmCount = newVal;
@@ -174,19 +219,64 @@ public:
 		return _asmRejectedWithBitErrorsCount;
 	}
 
-	/// Write-only accessor to _asmSearchCount.
+	/// Write-only accessor to the synchronizer's search count.
 	void setSearchCount(const uint64_t& newVal) {
-		_asmSearchCount = newVal;
+		_sync.setSearchCount(newVal);
 	}
 
-	/// Increase _asmSearchCount by the specified amount.
-	void incSearchCount(const uint16_t& inc = 1) {
-		_asmSearchCount += inc;
+	/// Read-only accessor to the synchronizer's search count.
+	uint64_t getSearchCount() const {
+		return _sync.getSearchCount();
 	}
 
-	/// Read-only accessor to _asmSearchCount.
-	uint64_t getSearchCount() const {
-		return _asmSearchCount;
+	/// Write-only accessor to _asmBitSlipCount.
+	void setAsmBitSlipCount(const uint64_t& newVal) {
+		_asmBitSlipCount = newVal;
+	}
+
+	/// Read-only accessor to _asmBitSlipCount.
+	uint64_t getAsmBitSlipCount() const {
+		return _asmBitSlipCount;
+	}
+
+	/// Write-only accessor to _asmInvertedCount.
+	void setAsmInvertedCount(const uint64_t& newVal) {
+		_asmInvertedCount = newVal;
+	}
+
+	/// Read-only accessor to _asmInvertedCount.
+	uint64_t getAsmInvertedCount() const {
+		return _asmInvertedCount;
+	}
+
+	/// Write-only accessor to the synchronizer's lock count.
+	void setLockCount(const uint64_t& newVal) {
+		_sync.setLockCount(newVal);
+	}
+
+	/// Read-only accessor to the synchronizer's lock count.
+	uint64_t getLockCount() const {
+		return _sync.getLockCount();
+	}
+
+	/// Write-only accessor to the synchronizer's lock loss count.
+	void setLockLossCount(const uint64_t& newVal) {
+		_sync.setLockLossCount(newVal);
+	}
+
+	/// Read-only accessor to the synchronizer's lock loss count.
+	uint64_t getLockLossCount() const {
+		return _sync.getLockLossCount();
+	}
+
+	/// Write-only accessor to the synchronizer's flywheel count.
+	void setFlywheelCount(const uint64_t& newVal) {
+		_sync.setFlywheelCount(newVal);
+	}
+
+	/// Read-only accessor to the synchronizer's flywheel count.
+	uint64_t getFlywheelCount() const {
+		return _sync.getFlywheelCount();
 	}
 
 	/// Write-only accessor to _asmPartialMismatch.
@@ -221,16 +311,39 @@ private:
 	/// Config file interface to _allowedMarkerBitErrors.
 	Setting& _allowedMarkerBitErrorsSetting;
 
+	/// Whether a complemented marker is also accepted, after which the frames are inverted too.
+	Setting& _acceptInvertedMarker;
+
+	/// The number of markers after the one found by a search that must be where
+	/// expected before declaring lock.
+	Setting& _checkThresholdSetting;
+
+	/// The number of consecutive missed markers tolerated once locked.
+	Setting& _flywheelThresholdSetting;
+
+	/// The marker, the correlator, and the synchronizer state.
+	FrameSynchronizer _sync;
+
 	/// Whether _marker has been updated or the ASM buffer otherwise needs to be (re)created.
 	bool _rebuildMarker;
 
-	/// Create a buffer with the contents of the new marker.
-	/// @param buffer Deleted if not null. Then a new buffer is allocated and filled.
-	/// @param bufferLen Receives the new marker length.
-	void _updateMarker(ACE_UINT8*& buffer, size_t& bufferLen);
+	/// Give the synchronizer the contents of _marker if it needs to be (re)created.
+	void _updateMarker();
 
 	void _send(NetworkData*& goodUnit);
 
+	/// @brief Make an octet-aligned copy of the rest of a received block.
+	/// @param data The block as received; its read pointer is not moved.
+	/// @param shift The bit offset of the stream, from the last marker search.
+	/// @param inverted Whether to complement every bit.
+	/// @param carry The last received octet before data, updated to its last octet.
+	/// @return A new unit the same length as data.
+	NetworkData* _realign(NetworkData* data, const unsigned shift, const bool inverted, ACE_UINT8& carry);
+
+	/// Tally a complete marker and clear its bit error count.
+	/// @param discovered True if it was found by a search rather than where expected.
+	void _countMarker(const bool discovered);
+
 	/// Determine if the specified area in the unit buffer matches the specified portion of
 	/// the marker buffer. It doesn't have to be a perfect match if allowedMarkerBERs is
 	/// greater than zero.
@@ -252,9 +365,6 @@ private:
 	/// The tally of ASMs that were not exactly where they were supposed to be.
 	uint64_t _asmMissedCount;
 
-	/// The tally of failed searches for an ASM.
-	uint64_t _asmSearchCount;
-
 	/// Tally of ASMs found only after a search.
 	uint64_t _asmDiscoveredCount;
 
@@ -273,6 +383,12 @@ private:
 	/// The number of ASMs that matched at the head but not the tail.
 	uint64_t _asmPartialMismatch;
 
+	/// The number of ASMs found after a search that did not start on an octet boundary.
+	uint64_t _asmBitSlipCount;
+
+	/// The number of ASMs found complemented after a search.
+	uint64_t _asmInvertedCount;
+
 }; // class modASM_Remove
 
 } // namespace nASM_Remove
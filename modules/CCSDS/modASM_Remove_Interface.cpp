@@ -65,6 +65,9 @@ public:
 
 	GENERATE_INT_ACCESSORS(expected_unit_length, setExpectedUnitLength, getExpectedUnitLength);
 	GENERATE_INT_ACCESSORS(allowed_bit_errors, setAllowedMarkerBitErrors, getAllowedMarkerBitErrors);
+	GENERATE_BOOL_ACCESSORS(accept_inverted, setAcceptInvertedMarker, getAcceptInvertedMarker);
+	GENERATE_INT_ACCESSORS(check_threshold, setCheckThreshold, getCheckThreshold);
+	GENERATE_INT_ACCESSORS(flywheel_threshold, setFlywheelThreshold, getFlywheelThreshold);
 	GENERATE_I8_ACCESSORS(asm_count, setAsmCount, getAsmCount);
 	GENERATE_I8_ACCESSORS(asm_valid_count, setAsmValidCount, getAsmValidCount);
 	GENERATE_I8_ACCESSORS(asm_missed, setAsmMissedCount, getAsmMissedCount);
@@ -75,6 +78,11 @@ public:
 	GENERATE_I8_ACCESSORS(asm_rejected_with_errs, setAsmRejectedWithBitErrorsCount, getAsmRejectedWithBitErrorsCount);
 	GENERATE_I8_ACCESSORS(asm_partial_errs, setPartialMismatchCount, getPartialMismatchCount);
 	GENERATE_I8_ACCESSORS(asm_discovered_count, setAsmDiscoveredCount, getAsmDiscoveredCount);
+	GENERATE_I8_ACCESSORS(asm_bit_slip_count, setAsmBitSlipCount, getAsmBitSlipCount);
+	GENERATE_I8_ACCESSORS(asm_inverted_count, setAsmInvertedCount, getAsmInvertedCount);
+	GENERATE_I8_ACCESSORS(lock_count, setLockCount, getLockCount);
+	GENERATE_I8_ACCESSORS(lock_loss_count, setLockLossCount, getLockLossCount);
+	GENERATE_I8_ACCESSORS(flywheel_count, setFlywheelCount, getFlywheelCount);
 
 	/// Export specified methods via XML-RPC.
 	void register_methods(xmlrpc_c::registryPtr&);
@@ -96,6 +104,12 @@ protected:
 		counters["asmRejectedUnitErrorCount"] = xmlrpc_c::value_i8(handler->getAsmRejectedWithBitErrorsCount());
 		counters["asmPartialCount"] = xmlrpc_c::value_i8(handler->getPartialMismatchCount());
 		counters["asmDiscoveredCount"] = xmlrpc_c::value_i8(handler->getAsmDiscoveredCount());
+		counters["asmBitSlipCount"] = xmlrpc_c::value_i8(handler->getAsmBitSlipCount());
+		counters["asmInvertedCount"] = xmlrpc_c::value_i8(handler->getAsmInvertedCount());
+		counters["lockCount"] = xmlrpc_c::value_i8(handler->getLockCount());
+		counters["lockLossCount"] = xmlrpc_c::value_i8(handler->getLockLossCount());
+		counters["flywheelCount"] = xmlrpc_c::value_i8(handler->getFlywheelCount());
+		counters["syncState"] = xmlrpc_c::value_string(handler->getSyncStateName());
 	}
 
 	void get_settings_(xmlrpc_c::paramList const& paramList, modASM_Remove* handler,
@@ -116,6 +130,9 @@ protected:
 		settings["markerPattern"] = xmlrpc_c::value_string(os.str());
 		settings["expectedUnitLength"] = xmlrpc_c::value_int(handler->getExpectedUnitLength());
 		settings["allowedMarkerBitErrors"] = xmlrpc_c::value_int(handler->getAllowedMarkerBitErrors());
+		settings["acceptInvertedMarker"] = xmlrpc_c::value_boolean(handler->getAcceptInvertedMarker());
+		settings["checkThreshold"] = xmlrpc_c::value_int(handler->getCheckThreshold());
+		settings["flywheelThreshold"] = xmlrpc_c::value_int(handler->getFlywheelThreshold());
 	}
 };
 
@@ -128,6 +145,12 @@ GENERATE_ACCESSOR_METHODS(expected_unit_length, i, "the length of all expected d
 	modASM_Remove_InterfaceP);
 GENERATE_ACCESSOR_METHODS(allowed_bit_errors, i, "the number of bit errors allowed in an ASM match.",
 	modASM_Remove_InterfaceP);
+GENERATE_ACCESSOR_METHODS(accept_inverted, b, "whether a complemented ASM is accepted and its frame inverted (default false).",
+	modASM_Remove_InterfaceP);
+GENERATE_ACCESSOR_METHODS(check_threshold, i, "the number of markers that must follow a discovered one before lock.",
+	modASM_Remove_InterfaceP);
+GENERATE_ACCESSOR_METHODS(flywheel_threshold, i, "the number of consecutive missed markers tolerated in lock.",
+	modASM_Remove_InterfaceP);
 GENERATE_ACCESSOR_METHODS(asm_count, i, "the grand total of ASMs that were located.",
 	modASM_Remove_InterfaceP);
 GENERATE_ACCESSOR_METHODS(asm_valid_count, i, "the tally of ASMs found exactly where expected.",
@@ -148,6 +171,16 @@ GENERATE_ACCESSOR_METHODS(asm_partial_errs, i, "the tally of ASMs with a correct
 	modASM_Remove_InterfaceP);
 GENERATE_ACCESSOR_METHODS(asm_discovered_count, i, "the tally of ASMs found only after a search.",
 	modASM_Remove_InterfaceP);
+GENERATE_ACCESSOR_METHODS(asm_bit_slip_count, i, "the tally of ASMs found off an octet boundary.",
+	modASM_Remove_InterfaceP);
+GENERATE_ACCESSOR_METHODS(asm_inverted_count, i, "the tally of ASMs found complemented.",
+	modASM_Remove_InterfaceP);
+GENERATE_ACCESSOR_METHODS(lock_count, i, "the tally of times the synchronizer locked.",
+	modASM_Remove_InterfaceP);
+GENERATE_ACCESSOR_METHODS(lock_loss_count, i, "the tally of times lock was lost.",
+	modASM_Remove_InterfaceP);
+GENERATE_ACCESSOR_METHODS(flywheel_count, i, "the tally of missed ASMs passed over while locked.",
+	modASM_Remove_InterfaceP);
 
 void modASM_Remove_Interface::register_methods(xmlrpc_c::registryPtr& rpcRegistry) {
 	ACE_TRACE("modASM_Remove_Interface::register_methods");
@@ -156,6 +189,9 @@ void modASM_Remove_Interface::register_methods(xmlrpc_c::registryPtr& rpcRegistr
 	REGISTER_ACCESSOR_METHODS(marker, modASM_Remove, ASM);
 	REGISTER_ACCESSOR_METHODS(expected_unit_length, modASM_Remove, ExpectedUnitLength);
 	REGISTER_ACCESSOR_METHODS(allowed_bit_errors, modASM_Remove, AllowedMarkerBitErrors);
+	REGISTER_ACCESSOR_METHODS(accept_inverted, modASM_Remove, AcceptInvertedMarker);
+	REGISTER_ACCESSOR_METHODS(check_threshold, modASM_Remove, CheckThreshold);
+	REGISTER_ACCESSOR_METHODS(flywheel_threshold, modASM_Remove, FlywheelThreshold);
 	REGISTER_ACCESSOR_METHODS(asm_count, modASM_Remove, ASMCount);
 	REGISTER_ACCESSOR_METHODS(asm_valid_count, modASM_Remove, ASMValidCount);
 	REGISTER_ACCESSOR_METHODS(asm_missed, modASM_Remove, ASMMissedCount);
@@ -166,6 +202,11 @@ void modASM_Remove_Interface::register_methods(xmlrpc_c::registryPtr& rpcRegistr
 	REGISTER_ACCESSOR_METHODS(asm_rejected_with_errs, modASM_Remove, ASMRejectedUnitErrors);
 	REGISTER_ACCESSOR_METHODS(asm_partial_errs, modASM_Remove, ASMPartialErrors);
 	REGISTER_ACCESSOR_METHODS(asm_discovered_count, modASM_Remove, ASMDiscoveredCount);
+	REGISTER_ACCESSOR_METHODS(asm_bit_slip_count, modASM_Remove, ASMBitSlipCount);
+	REGISTER_ACCESSOR_METHODS(asm_inverted_count, modASM_Remove, ASMInvertedCount);
+	REGISTER_ACCESSOR_METHODS(lock_count, modASM_Remove, LockCount);
+	REGISTER_ACCESSOR_METHODS(lock_loss_count, modASM_Remove, LockLossCount);
+	REGISTER_ACCESSOR_METHODS(flywheel_count, modASM_Remove, FlywheelCount);
 }
 
 } // namespace nASM_Remove
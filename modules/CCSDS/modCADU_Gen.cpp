@@ -0,0 +1,205 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   modCADU_Gen.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "modCADU_Gen.hpp"
+#include "NetworkData.hpp"
+#include "PseudoRandomSequence.hpp"
+
+#include <ace/Guard_T.h>
+
+namespace nCADU_Gen {
+
+modCADU_Gen::modCADU_Gen(const std::string& newName, const std::string& newChannelName,
+	const CE_DLL* newDLLPtr):
+	BaseTrafficHandler(newName, newChannelName, newDLLPtr),
+	_marker(CEcfg::instance()->getOrAddArray(cfgKey("markerPattern"))),
+	_randomizeSetting(CEcfg::instance()->getOrAddBool(cfgKey("randomize"), true)),
+	_maxErrorsPerCodewordSetting(CEcfg::instance()->getOrAddInt(cfgKey("maxErrorsPerCodeword"), 16)),
+	_interleavingDepthSetting(CEcfg::instance()->getOrAddInt(cfgKey("interleavingDepth"), 1)),
+	_primitivePolySetting(CEcfg::instance()->getOrAddInt(cfgKey("primitivePoly"), 0x187)),
+	_codeLengthSetting(CEcfg::instance()->getOrAddInt(cfgKey("codeLength"), 255)),
+	_bitsPerSymbolSetting(CEcfg::instance()->getOrAddInt(cfgKey("bitsPerSymbol"), 8)),
+	_primitiveRootIdxSetting(CEcfg::instance()->getOrAddInt(cfgKey("primitiveRootIdx"), 11)),
+	_firstConsecutiveRootSetting(CEcfg::instance()->getOrAddInt(cfgKey("firstConsecutiveRoot"), -1)),
+	_dualBasisSetting(CEcfg::instance()->getOrAddBool(cfgKey("dualBasis"), true)),
+	_rebuildMarker(true),
+	_rebuildEncoder(true),
+	_rsEncoder(0),
+	_encoderFailed(false),
+	_asmCount(0),
+	_movedUnitCount(0) {
+
+	if ( _marker.getLength() == 0 ) {
+		uint8_t defaultPattern[] = { 0x1A, 0xCF, 0xFC, 0x1D };
+		setMarker(defaultPattern, 4);
+	}
+
+	setMaxErrorsPerCodeword(_maxErrorsPerCodewordSetting);
+	setInterleavingDepth(_interleavingDepthSetting);
+	setPrimitivePoly(_primitivePolySetting);
+	setCodeLength(_codeLengthSetting);
+	setBitsPerSymbol(_bitsPerSymbolSetting);
+	setPrimitiveRootIdx(_primitiveRootIdxSetting);
+	setFirstConsecutiveRoot(_firstConsecutiveRootSetting);
+
+	MOD_DEBUG("Initializing with a %d-octet sync marker.", _marker.getLength());
+}
+
+modCADU_Gen::~modCADU_Gen() {
+	MOD_DEBUG("Running ~modCADU_Gen().");
+	stopTraffic();
+	delete _rsEncoder;
+}
+
+void modCADU_Gen::setMarker(const uint8_t* asmBuf, const int bufLen) {
+	for (int i = 0; i < bufLen; i++) {
+		// Add slots when needed
+		if ( _marker.getLength() < i + 1 ) _marker.add(Setting::TypeInt);
+		_marker[i].setFormat(Setting::FormatHex);
+		_marker[i] = asmBuf[i];
+	}
+
+	// Eliminate extra slots
+	while (_marker.getLength() > bufLen) _marker.remove(bufLen);
+
+	_rebuildMarker = true;
+}
+
+void modCADU_Gen::setMarker(const std::vector<uint8_t>& newMarker) {
+	for (unsigned i = 0; i < newMarker.size(); i++) {
+		// Add slots when needed
+		if ( static_cast<unsigned>(_marker.getLength()) < i + 1 )
+			_marker.add(Setting::TypeInt);
+
+		_marker[i].setFormat(Setting::FormatHex);
+		_marker[i] = newMarker[i];
+	}
+
+	// Eliminate extra slots
+	while (static_cast<unsigned>(_marker.getLength()) > newMarker.size())
+		_marker.remove(newMarker.size());
+
+	_rebuildMarker = true;
+}
+
+void modCADU_Gen::getMarker(std::vector<uint8_t>& marker) const {
+	marker.clear();
+
+	for ( int i = 0; i < _marker.getLength(); i++ )
+		marker.push_back(static_cast<int>(_marker[i]) & 0xFF);
+}
+
+void modCADU_Gen::_updateMarker() {
+	if ( ! _rebuildMarker ) return;
+
+	_markerBuf.resize(_marker.getLength());
+	for ( unsigned i = 0; i < _markerBuf.size(); ++i ) _markerBuf[i] = static_cast<int>(_marker[i]);
+
+	_rebuildMarker = false;
+
+	MOD_DEBUG("Updated marker to %d-octet buffer.", _markerBuf.size());
+}
+
+void modCADU_Gen::_updateEncoder() {
+	if ( ! _rebuildEncoder ) return;
+
+	delete _rsEncoder;
+	_rsEncoder = 0;
+	_rebuildEncoder = false;
+	_encoderFailed = false;
+
+	const int maxErrors = getMaxErrorsPerCodeword();
+	if ( maxErrors == 0 ) {
+		MOD_DEBUG("Reed-Solomon encoding is off.");
+		return;
+	}
+
+	try {
+		_rsEncoder = new RSEncoder(getPrimitivePoly(), maxErrors * 2, getCodeLength(), getBitsPerSymbol(),
+			getPrimitiveRootIdx(), getFirstConsecutiveRoot(), getInterleavingDepth(), getDualBasis());
+	}
+	catch (const nd_error& e) {
+		MOD_ERROR("Cannot construct a Reed-Solomon encoder, dropping frames until the settings change: %s", e.what());
+		_encoderFailed = true;
+		return;
+	}
+
+	MOD_DEBUG("Constructed a RS(%d,%d) encoder with an interleaving depth of %d.",
+		getCodeLength(), getCodeLength() - maxErrors * 2, getInterleavingDepth());
+}
+
+int modCADU_Gen::svc() {
+	return transformLoop_();
+}
+
+NetworkData* modCADU_Gen::transformUnit_(NetworkData* data) {
+	const size_t msgLen = data->getUnitLength();
+
+	if ( ! msgLen ) {
+		MOD_INFO("Received null data.");
+		ndSafeRelease(data);
+		return 0;
+	}
+
+	ACE_Guard<ACE_Thread_Mutex> guard(_codingLock);
+
+	_updateMarker();
+	_updateEncoder();
+
+	if ( _encoderFailed ) {
+		ndSafeRelease(data);
+		return 0;
+	}
+
+	const size_t markerLen = _markerBuf.size();
+	const size_t parityLen = _rsEncoder? _rsEncoder->getTotalParityLength() : 0;
+
+	if ( _rsEncoder && msgLen > _rsEncoder->getMaxMessageLength() ) {
+		MOD_WARNING("Unit length %d is greater than maximum message length %d, dropping.",
+			msgLen, _rsEncoder->getMaxMessageLength());
+		ndSafeRelease(data);
+		return 0;
+	}
+
+	MOD_DEBUG("Received a %d-octet %s to make into a %d-octet CADU.",
+		msgLen, data->typeStr().c_str(), markerLen + msgLen + parityLen);
+
+	NetworkData* frame = data;
+
+	if ( data->reference_count() > 1 || data->getHeadroom() < markerLen || data->getTailroom() < parityLen ) {
+		// Copy the frame once into a buffer with room for the marker and parity.
+		// A shared buffer is never written to, since the other units may cover it.
+		frame = new NetworkData(msgLen, data->ptrUnit(), markerLen, parityLen);
+		++_movedUnitCount;
+	}
+
+	ACE_UINT8* msg = frame->ptrUnit();
+
+	// The parity goes straight into the tailroom, then everything is randomized while still in cache.
+	if ( _rsEncoder ) _rsEncoder->encodeInPlace(msg, msgLen, msg + msgLen);
+	if ( getRandomize() ) PseudoRandomSequence::apply(msg, msgLen + parityLen);
+
+	frame->extendInPlace(parityLen);
+	if ( markerLen ) frame->prependInPlace(&_markerBuf[0], markerLen);
+
+	// Rewrap the unit so that it's no longer treated as a frame of some type.
+	NetworkData* cadu = ( frame == data )? data->wrapOuterPDU<NetworkData>() : frame;
+	ndSafeRelease(data);
+
+	++_asmCount;
+
+	return cadu;
+}
+
+} // namespace nCADU_Gen
@@ -0,0 +1,256 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   modCADU_Gen.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _MOD_CADU_GEN_HPP_
+#define _MOD_CADU_GEN_HPP_
+
+#include "BaseTrafficHandler.hpp"
+#include "RSEncoder.hpp"
+
+#include <ace/Thread_Mutex.h>
+#include <vector>
+
+namespace nCADU_Gen {
+
+//=============================================================================
+/**
+	@class modCADU_Gen
+	@author Tad Kollar
+	@brief Turn transfer frames into CADUs in one segment.
+
+	Does the work of modRSEncode, modPseudoRandomize, and modASM_Add without
+	the two queues between them. The parity is written into the tailroom of
+	the frame, the frame and parity are XORed with the pseudo-random sequence,
+	and the marker is written into the headroom, all in the frame's own buffer.
+	If the frame was not allocated with enough room, it is moved once.
+
+	The Reed-Solomon settings are those of modRSEncode and default to the
+	CCSDS code; a maximum of zero errors per codeword turns encoding off.
+*/
+//=============================================================================
+class modCADU_Gen: public BaseTrafficHandler {
+public:
+	/// Primary constructor.
+	/// @param newName An identifier for the module that's unique within the channel.
+	/// @param newChannelName An identifier for the containing channel.
+	/// @param newDLLPtr Pointer to the DLL management structure.
+	modCADU_Gen(const std::string& newName, const std::string& newChannelName,
+		const CE_DLL* newDLLPtr);
+
+	/// Destructor.
+	~modCADU_Gen();
+
+	/// Reads in frames and sends each one as a CADU.
+	int svc();
+
+	/// Every frame is coded the same way, so frames can be handled on any thread.
+	bool supportsInline() const { return true; }
+
+	/// Set the contents of _marker.
+	/// @param asmBuf The buffer holding the new marker.
+	/// @param bufLen The length of the pattern in the buffer.
+	void setMarker(const uint8_t* asmBuf, const int bufLen);
+
+	/// Set the contents of _marker.
+	/// @param newMarker A vector containing the new pattern.
+	void setMarker(const std::vector<uint8_t>& newMarker);
+
+	/// Return the contents of _marker.
+	/// @param marker A vector to copy _marker into.
+	void getMarker(std::vector<uint8_t>& marker) const;
+
+	/// Write-only accessor to _randomizeSetting.
+	void setRandomize(const bool newVal) { _randomizeSetting = newVal; }
+
+	/// Read-only accessor to _randomizeSetting.
+	bool getRandomize() const { return _randomizeSetting; }
+
+	/// @brief Write-only accessor to _maxErrorsPerCodewordSetting. Takes effect with the next frame.
+	/// @param newVal The Reed-Solomon correction capability; CCSDS uses 8 or 16, and 0 turns encoding off.
+	/// @throw ValueOutOfRange If newVal is not between 0 and 127.
+	void setMaxErrorsPerCodeword(const int newVal) {
+		if ( newVal < 0 || newVal > 127 ) throw ValueOutOfRange(ValueOutOfRange::msg("Max errors per codeword", newVal, 0, 127));
+		_maxErrorsPerCodewordSetting = newVal;
+		_rebuildEncoder = true;
+	}
+
+	/// Read-only accessor to _maxErrorsPerCodewordSetting.
+	int getMaxErrorsPerCodeword() const { return _maxErrorsPerCodewordSetting; }
+
+	/// @brief Write-only accessor to _interleavingDepthSetting. Takes effect with the next frame.
+	/// @throw ValueOutOfRange If newVal is not between 1 and 255.
+	void setInterleavingDepth(const int newVal) {
+		if ( newVal < 1 || newVal > 255 ) throw ValueOutOfRange(ValueOutOfRange::msg("Interleaving depth", newVal, 1, 255));
+		_interleavingDepthSetting = newVal;
+		_rebuildEncoder = true;
+	}
+
+	/// Read-only accessor to _interleavingDepthSetting.
+	int getInterleavingDepth() const { return _interleavingDepthSetting; }
+
+	/// @brief Write-only accessor to _primitivePolySetting. Takes effect with the next frame.
+	/// Whether it is actually primitive is checked when the encoder is rebuilt.
+	/// @throw ValueOutOfRange If newVal is not a polynomial of degree 2 through 8.
+	void setPrimitivePoly(const int newVal) {
+		if ( newVal < 0x4 || newVal > 0x1ff )
+			throw ValueOutOfRange(ValueOutOfRange::msg("Primitive polynomial", newVal, 0x4, 0x1ff));
+		_primitivePolySetting = newVal;
+		_rebuildEncoder = true;
+	}
+
+	/// Read-only accessor to _primitivePolySetting.
+	int getPrimitivePoly() const { return _primitivePolySetting; }
+
+	/// @brief Write-only accessor to _codeLengthSetting. Takes effect with the next frame.
+	/// Values below 2^bitsPerSymbol - 1 select a shortened code.
+	/// @throw ValueOutOfRange If newVal is not between 3 and 255.
+	void setCodeLength(const int newVal) {
+		if ( newVal < 3 || newVal > 255 ) throw ValueOutOfRange(ValueOutOfRange::msg("Code length", newVal, 3, 255));
+		_codeLengthSetting = newVal;
+		_rebuildEncoder = true;
+	}
+
+	/// Read-only accessor to _codeLengthSetting.
+	int getCodeLength() const { return _codeLengthSetting; }
+
+	/// @brief Write-only accessor to _bitsPerSymbolSetting. Takes effect with the next frame.
+	/// @throw ValueOutOfRange If newVal is not between 2 and 8.
+	void setBitsPerSymbol(const int newVal) {
+		if ( newVal < 2 || newVal > 8 ) throw ValueOutOfRange(ValueOutOfRange::msg("Bits per symbol", newVal, 2, 8));
+		_bitsPerSymbolSetting = newVal;
+		_rebuildEncoder = true;
+	}
+
+	/// Read-only accessor to _bitsPerSymbolSetting.
+	int getBitsPerSymbol() const { return _bitsPerSymbolSetting; }
+
+	/// @brief Write-only accessor to _primitiveRootIdxSetting. Takes effect with the next frame.
+	/// @throw ValueOutOfRange If newVal is not between 1 and 254.
+	void setPrimitiveRootIdx(const int newVal) {
+		if ( newVal < 1 || newVal > 254 ) throw ValueOutOfRange(ValueOutOfRange::msg("Primitive root index", newVal, 1, 254));
+		_primitiveRootIdxSetting = newVal;
+		_rebuildEncoder = true;
+	}
+
+	/// Read-only accessor to _primitiveRootIdxSetting.
+	int getPrimitiveRootIdx() const { return _primitiveRootIdxSetting; }
+
+	/// @brief Write-only accessor to _firstConsecutiveRootSetting. Takes effect with the next frame.
+	/// @param newVal The power of the primitive root that is the generator's first root,
+	/// or -1 to choose it as CCSDS does.
+	/// @throw ValueTooLarge If newVal is over 254.
+	void setFirstConsecutiveRoot(const int newVal) {
+		if ( newVal > 254 ) throw ValueTooLarge(ValueTooLarge::msg("First consecutive root", newVal, 254));
+		_firstConsecutiveRootSetting = ( newVal < 0 )? -1 : newVal;
+		_rebuildEncoder = true;
+	}
+
+	/// @brief The first consecutive root in use. If none was set, it is 2^(bitsPerSymbol - 1) - E,
+	/// as in modRSDecode.
+	int getFirstConsecutiveRoot() const {
+		const int fcr = _firstConsecutiveRootSetting;
+		return ( fcr >= 0 )? fcr : ( 1 << (getBitsPerSymbol() - 1) ) - getMaxErrorsPerCodeword();
+	}
+
+	/// Write-only accessor to _dualBasisSetting. Takes effect with the next frame.
+	void setDualBasis(const bool newVal) {
+		_dualBasisSetting = newVal;
+		_rebuildEncoder = true;
+	}
+
+	/// Read-only accessor to _dualBasisSetting.
+	bool getDualBasis() const { return _dualBasisSetting; }
+
+	/// Write-only accessor to _asmCount.
+	void setAsmCount(const uint64_t& newVal) { _asmCount = newVal; }
+
+	/// Read-only accessor to _asmCount.
+	uint64_t getAsmCount() const { return _asmCount; }
+
+	/// Write-only accessor to _movedUnitCount.
+	void setMovedUnitCount(const uint64_t& newVal) { _movedUnitCount = newVal; }
+
+	/// Read-only accessor to _movedUnitCount.
+	uint64_t getMovedUnitCount() const { return _movedUnitCount; }
+
+protected:
+	/// Encode, randomize, and mark the frame, in place if it has the room.
+	NetworkData* transformUnit_(NetworkData* data);
+
+private:
+	/// The ASM to prepend.
+	Setting& _marker;
+
+	/// Config file setting for whether frames are XORed with the pseudo-random sequence.
+	Setting& _randomizeSetting;
+
+	/// Config file setting for the Reed-Solomon correction capability; 0 for none.
+	Setting& _maxErrorsPerCodewordSetting;
+
+	/// Config file setting for the number of interleaved codewords per frame.
+	Setting& _interleavingDepthSetting;
+
+	/// Config file setting for the field polynomial; 0x187 for CCSDS.
+	Setting& _primitivePolySetting;
+
+	/// Config file setting for the symbols per codeword, data plus parity; 255 for CCSDS.
+	Setting& _codeLengthSetting;
+
+	/// Config file setting for the size of each symbol; 8 for CCSDS.
+	Setting& _bitsPerSymbolSetting;
+
+	/// Config file setting for the power of alpha used as the primitive root; 11 for CCSDS.
+	Setting& _primitiveRootIdxSetting;
+
+	/// Config file setting for the first root of the generator, or -1 for automatic.
+	Setting& _firstConsecutiveRootSetting;
+
+	/// Config file setting for whether symbols are sent in Berlekamp's dual basis, as CCSDS does.
+	Setting& _dualBasisSetting;
+
+	/// Set when _marker changes.
+	bool _rebuildMarker;
+
+	/// A copy of _marker, made by _updateMarker().
+	std::vector<ACE_UINT8> _markerBuf;
+
+	/// Set when the Reed-Solomon settings change.
+	bool _rebuildEncoder;
+
+	/// Encodes the frames; null when encoding is off.
+	RSEncoder* _rsEncoder;
+
+	/// True if the Reed-Solomon settings don't make a valid code; frames are dropped until they do.
+	bool _encoderFailed;
+
+	/// Keeps a rebuild from happening while another thread is coding a frame.
+	ACE_Thread_Mutex _codingLock;
+
+	/// The total number of CADUs made.
+	uint64_t _asmCount;
+
+	/// The total number of frames that had to be moved to a larger buffer.
+	uint64_t _movedUnitCount;
+
+	/// Copy _marker into _markerBuf if it has changed.
+	void _updateMarker();
+
+	/// Replace _rsEncoder if the Reed-Solomon settings have changed.
+	void _updateEncoder();
+
+}; // class modCADU_Gen
+
+} // namespace nCADU_Gen
+
+#endif // _MOD_CADU_GEN_HPP_
@@ -0,0 +1,162 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   modCADU_Gen_Interface.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "modCADU_Gen.hpp"
+#include "TrafficHandler_Interface.hpp"
+
+namespace nCADU_Gen {
+
+//=============================================================================
+/**
+ * @class modCADU_Gen_Interface
+ * @author Tad Kollar
+ * @brief Provide an XML-RPC interface to the CADU Generation module.
+ */
+//=============================================================================
+class modCADU_Gen_Interface: public nasaCE::TrafficHandler_Interface<modCADU_Gen> {
+public:
+	modCADU_Gen_Interface(xmlrpc_c::registryPtr& rpcRegistry):
+		nasaCE::TrafficHandler_Interface<modCADU_Gen>(rpcRegistry, "modCADU_Gen") {
+		ACE_TRACE("modCADU_Gen_Interface::modCADU_Gen_Interface");
+
+		register_methods(rpcRegistry);
+	}
+
+	void set_marker(xmlrpc_c::paramList const& paramList, xmlrpc_c::value* retvalP) {
+		ACE_TRACE("modCADU_Gen_Interface::set_marker");
+		const std::vector<xmlrpc_c::value> xml_rpc_marker = paramList.getArray(2);
+
+		std::vector<uint8_t> marker;
+
+		for (unsigned i = 0; i < xml_rpc_marker.size(); i++ ) {
+			marker.push_back(xmlrpc_c::value_int(xml_rpc_marker[i]));
+		}
+
+		find_handler(paramList)->setMarker(marker);
+
+		*retvalP = xmlrpc_c::value_nil();
+	}
+
+	void get_marker(xmlrpc_c::paramList const& paramList, xmlrpc_c::value* retvalP) {
+		ACE_TRACE("modCADU_Gen_Interface::get_marker");
+
+		std::vector<uint8_t> marker;
+		find_handler(paramList)->getMarker(marker);
+
+		std::vector<xmlrpc_c::value> xml_rpc_marker;
+
+		for (unsigned i = 0; i < marker.size(); i++ ) {
+			xml_rpc_marker.push_back(xmlrpc_c::value_int(marker[i]));
+		}
+
+		*retvalP = xmlrpc_c::value_array(xml_rpc_marker);
+	}
+
+	GENERATE_BOOL_ACCESSORS(randomize, setRandomize, getRandomize);
+	GENERATE_INT_ACCESSORS(max_errors_per_codeword, setMaxErrorsPerCodeword, getMaxErrorsPerCodeword);
+	GENERATE_INT_ACCESSORS(interleaving_depth, setInterleavingDepth, getInterleavingDepth);
+	GENERATE_INT_ACCESSORS(primitive_poly, setPrimitivePoly, getPrimitivePoly);
+	GENERATE_INT_ACCESSORS(code_length, setCodeLength, getCodeLength);
+	GENERATE_INT_ACCESSORS(bits_per_symbol, setBitsPerSymbol, getBitsPerSymbol);
+	GENERATE_INT_ACCESSORS(primitive_root_idx, setPrimitiveRootIdx, getPrimitiveRootIdx);
+	GENERATE_INT_ACCESSORS(first_consecutive_root, setFirstConsecutiveRoot, getFirstConsecutiveRoot);
+	GENERATE_BOOL_ACCESSORS(dual_basis, setDualBasis, getDualBasis);
+	GENERATE_I8_ACCESSORS(asm_count, setAsmCount, getAsmCount);
+	GENERATE_I8_ACCESSORS(moved_unit_count, setMovedUnitCount, getMovedUnitCount);
+
+	/// Export specified methods via XML-RPC.
+	void register_methods(xmlrpc_c::registryPtr&);
+
+protected:
+	void get_counters_(xmlrpc_c::paramList const& paramList, modCADU_Gen* handler,
+		xstruct& counters) {
+		ACE_TRACE("modCADU_Gen_Interface::get_counters_");
+
+		nasaCE::TrafficHandler_Interface<modCADU_Gen>::get_counters_(paramList, handler, counters);
+
+		counters["asmCount"] = xmlrpc_c::value_i8(handler->getAsmCount());
+		counters["movedUnitCount"] = xmlrpc_c::value_i8(handler->getMovedUnitCount());
+	}
+
+	void get_settings_(xmlrpc_c::paramList const& paramList, modCADU_Gen* handler,
+		xstruct& settings) {
+		ACE_TRACE("modCADU_Gen_Interface::get_settings_");
+
+		nasaCE::TrafficHandler_Interface<modCADU_Gen>::get_settings_(paramList, handler, settings);
+		using namespace std;
+
+		vector<uint8_t> marker;
+		handler->getMarker(marker);
+		vector<uint8_t>::iterator pos;
+		ostringstream os;
+
+		for ( pos = marker.begin(); pos != marker.end(); ++pos )
+			os << uppercase << hex << setw(2) << setfill('0') << static_cast<int>(*pos);
+
+		settings["markerPattern"] = xmlrpc_c::value_string(os.str());
+		settings["randomize"] = xmlrpc_c::value_boolean(handler->getRandomize());
+		settings["maxErrorsPerCodeword"] = xmlrpc_c::value_int(handler->getMaxErrorsPerCodeword());
+		settings["interleavingDepth"] = xmlrpc_c::value_int(handler->getInterleavingDepth());
+		settings["primitivePoly"] = xmlrpc_c::value_int(handler->getPrimitivePoly());
+		settings["codeLength"] = xmlrpc_c::value_int(handler->getCodeLength());
+		settings["bitsPerSymbol"] = xmlrpc_c::value_int(handler->getBitsPerSymbol());
+		settings["primitiveRootIdx"] = xmlrpc_c::value_int(handler->getPrimitiveRootIdx());
+		settings["firstConsecutiveRoot"] = xmlrpc_c::value_int(handler->getFirstConsecutiveRoot());
+		settings["dualBasis"] = xmlrpc_c::value_boolean(handler->getDualBasis());
+	}
+};
+
+modCADU_Gen_Interface* modCADU_Gen_InterfaceP;
+
+TEMPLATE_METHOD_CLASSES(modCADU_Gen_Interface, modCADU_Gen_InterfaceP);
+METHOD_CLASS(set_marker, "n:A", "Sets a new attached sync marker (ASM).", modCADU_Gen_InterfaceP);
+METHOD_CLASS(get_marker, "A:n", "Returns the current attached sync marker (ASM).", modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(randomize, b, "whether frames are XORed with the pseudo-random sequence.",
+	modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(max_errors_per_codeword, i, "the Reed-Solomon errors correctable per codeword, or 0 for no encoding.",
+	modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(interleaving_depth, i, "the number of Reed-Solomon codewords interleaved in each frame.",
+	modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(primitive_poly, i, "the field polynomial, such as 0x187 for CCSDS.", modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(code_length, i, "the number of symbols per codeword; less than 2^bitsPerSymbol - 1 for a shortened code.",
+	modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(bits_per_symbol, i, "the size of each symbol, from 2 to 8 bits.", modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(primitive_root_idx, i, "the power of alpha used as the code's primitive root.", modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(first_consecutive_root, i, "the first root of the generator polynomial, or -1 to choose as CCSDS does.",
+	modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(dual_basis, b, "whether symbols are sent in Berlekamp's dual basis.", modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(asm_count, i, "the grand total of CADUs made.",
+	modCADU_Gen_InterfaceP);
+GENERATE_ACCESSOR_METHODS(moved_unit_count, i, "the tally of frames moved to a buffer with more room.",
+	modCADU_Gen_InterfaceP);
+
+void modCADU_Gen_Interface::register_methods(xmlrpc_c::registryPtr& rpcRegistry) {
+	ACE_TRACE("modCADU_Gen_Interface::register_methods");
+
+	TEMPLATE_REGISTER_METHODS(modCADU_Gen, modCADU_Gen_Interface);
+	REGISTER_ACCESSOR_METHODS(marker, modCADU_Gen, ASM);
+	REGISTER_ACCESSOR_METHODS(randomize, modCADU_Gen, Randomize);
+	REGISTER_ACCESSOR_METHODS(max_errors_per_codeword, modCADU_Gen, MaxErrorsPerCodeword);
+	REGISTER_ACCESSOR_METHODS(interleaving_depth, modCADU_Gen, InterleavingDepth);
+	REGISTER_ACCESSOR_METHODS(primitive_poly, modCADU_Gen, PrimitivePoly);
+	REGISTER_ACCESSOR_METHODS(code_length, modCADU_Gen, CodeLength);
+	REGISTER_ACCESSOR_METHODS(bits_per_symbol, modCADU_Gen, BitsPerSymbol);
+	REGISTER_ACCESSOR_METHODS(primitive_root_idx, modCADU_Gen, PrimitiveRootIdx);
+	REGISTER_ACCESSOR_METHODS(first_consecutive_root, modCADU_Gen, FirstConsecutiveRoot);
+	REGISTER_ACCESSOR_METHODS(dual_basis, modCADU_Gen, DualBasis);
+	REGISTER_ACCESSOR_METHODS(asm_count, modCADU_Gen, ASMCount);
+	REGISTER_ACCESSOR_METHODS(moved_unit_count, modCADU_Gen, MovedUnitCount);
+}
+
+} // namespace nCADU_Gen
@@ -0,0 +1,447 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   modCADU_Rcv.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "modCADU_Rcv.hpp"
+#include "NetworkData.hpp"
+#include "PseudoRandomSequence.hpp"
+
+namespace nCADU_Rcv {
+
+modCADU_Rcv::modCADU_Rcv(const std::string& newName, const std::string& newChannelName,
+	const CE_DLL* newDLLPtr):
+	BaseTrafficHandler(newName, newChannelName, newDLLPtr),
+	_marker(CEcfg::instance()->getOrAddArray(cfgKey("markerPattern"))),
+	_expectedUnitLengthSetting(CEcfg::instance()->getOrAddInt(cfgKey("expectedUnitLength"), 256)),
+	_allowedMarkerBitErrorsSetting(CEcfg::instance()->getOrAddInt(cfgKey("allowedMarkerBitErrors"), 0)),
+	_acceptInvertedMarkerSetting(CEcfg::instance()->getOrAddBool(cfgKey("acceptInvertedMarker"), false)),
+	_checkThresholdSetting(CEcfg::instance()->getOrAddInt(cfgKey("checkThreshold"), 1)),
+	_flywheelThresholdSetting(CEcfg::instance()->getOrAddInt(cfgKey("flywheelThreshold"), 2)),
+	_derandomizeSetting(CEcfg::instance()->getOrAddBool(cfgKey("derandomize"), true)),
+	_maxErrorsPerCodewordSetting(CEcfg::instance()->getOrAddInt(cfgKey("maxErrorsPerCodeword"), 16)),
+	_interleavingDepthSetting(CEcfg::instance()->getOrAddInt(cfgKey("interleavingDepth"), 1)),
+	_primitivePolySetting(CEcfg::instance()->getOrAddInt(cfgKey("primitivePoly"), 0x187)),
+	_codeLengthSetting(CEcfg::instance()->getOrAddInt(cfgKey("codeLength"), 255)),
+	_bitsPerSymbolSetting(CEcfg::instance()->getOrAddInt(cfgKey("bitsPerSymbol"), 8)),
+	_primitiveRootIdxSetting(CEcfg::instance()->getOrAddInt(cfgKey("primitiveRootIdx"), 11)),
+	_firstConsecutiveRootSetting(CEcfg::instance()->getOrAddInt(cfgKey("firstConsecutiveRoot"), -1)),
+	_dualBasisSetting(CEcfg::instance()->getOrAddBool(cfgKey("dualBasis"), true)),
+	_heldLen(0),
+	_searchOctet(0),
+	_nextBit(0),
+	_candidate(false),
+	_inverted(false),
+	_rebuildDecoder(true),
+	_rsDecoder(0),
+	_decoderFailed(false),
+	_asmCount(0),
+	_asmMissedCount(0),
+	_correctedErrorCount(0),
+	_uncorrectedErrorCount(0),
+	_errorlessUnitCount(0),
+	_correctedUnitCount(0),
+	_uncorrectedUnitCount(0) {
+
+	if ( _marker.getLength() == 0 ) {
+		uint8_t defaultPattern[] = { 0x1A, 0xCF, 0xFC, 0x1D };
+		setMarker(defaultPattern, 4);
+	}
+
+	setExpectedUnitLength(_expectedUnitLengthSetting);
+	setAllowedMarkerBitErrors(_allowedMarkerBitErrorsSetting);
+	setCheckThreshold(_checkThresholdSetting);
+	setFlywheelThreshold(_flywheelThresholdSetting);
+	setMaxErrorsPerCodeword(_maxErrorsPerCodewordSetting);
+	setInterleavingDepth(_interleavingDepthSetting);
+	setPrimitivePoly(_primitivePolySetting);
+	setCodeLength(_codeLengthSetting);
+	setBitsPerSymbol(_bitsPerSymbolSetting);
+	setPrimitiveRootIdx(_primitiveRootIdxSetting);
+	setFirstConsecutiveRoot(_firstConsecutiveRootSetting);
+
+	MOD_DEBUG("Initializing with a %d-octet sync marker and %d-octet coded frames.",
+		_marker.getLength(), getExpectedUnitLength());
+}
+
+modCADU_Rcv::~modCADU_Rcv() {
+	MOD_DEBUG("Running ~modCADU_Rcv().");
+	stopTraffic();
+	_releaseHeld();
+	delete _rsDecoder;
+}
+
+void modCADU_Rcv::setMarker(const uint8_t* asmBuf, const int bufLen) {
+	for (int i = 0; i < bufLen; i++) {
+		// Add slots when needed
+		if ( _marker.getLength() < i + 1 ) _marker.add(Setting::TypeInt);
+		_marker[i].setFormat(Setting::FormatHex);
+		_marker[i] = asmBuf[i];
+	}
+
+	// Eliminate extra slots
+	while (_marker.getLength() > bufLen) _marker.remove(bufLen);
+}
+
+void modCADU_Rcv::setMarker(const std::vector<uint8_t>& newMarker) {
+	for (unsigned i = 0; i < newMarker.size(); i++) {
+		// Add slots when needed
+		if ( static_cast<unsigned>(_marker.getLength()) < i + 1 )
+			_marker.add(Setting::TypeInt);
+
+		_marker[i].setFormat(Setting::FormatHex);
+		_marker[i] = newMarker[i];
+	}
+
+	// Eliminate extra slots
+	while (static_cast<unsigned>(_marker.getLength()) > newMarker.size())
+		_marker.remove(newMarker.size());
+}
+
+void modCADU_Rcv::getMarker(std::vector<uint8_t>& marker) const {
+	marker.clear();
+
+	for ( int i = 0; i < _marker.getLength(); i++ )
+		marker.push_back(static_cast<int>(_marker[i]) & 0xFF);
+}
+
+void modCADU_Rcv::_updateMarker() {
+	if ( _marker.getLength() == 0 ) {
+		MOD_WARNING("No marker is set, using the CCSDS default.");
+		uint8_t defaultPattern[] = { 0x1A, 0xCF, 0xFC, 0x1D };
+		setMarker(defaultPattern, 4);
+	}
+
+	std::vector<uint8_t> marker;
+	getMarker(marker);
+
+	_sync.setMarker(&marker[0], marker.size());
+
+	MOD_DEBUG("Using a %d-octet marker, correlating the first %d.", marker.size(),
+		_sync.getCorrelator().getPatternLen());
+}
+
+void modCADU_Rcv::_updateDecoder() {
+	if ( ! _rebuildDecoder ) return;
+
+	delete _rsDecoder;
+	_rsDecoder = 0;
+	_rebuildDecoder = false;
+	_decoderFailed = false;
+
+	const int maxErrors = getMaxErrorsPerCodeword();
+	if ( maxErrors == 0 ) {
+		MOD_DEBUG("Reed-Solomon decoding is off.");
+		return;
+	}
+
+	try {
+		_rsDecoder = new RSDecoder(getPrimitivePoly(), maxErrors * 2, getCodeLength(), getBitsPerSymbol(),
+			getPrimitiveRootIdx(), getFirstConsecutiveRoot(), getInterleavingDepth(), getDualBasis());
+	}
+	catch (const nd_error& e) {
+		MOD_ERROR("Cannot construct a Reed-Solomon decoder, dropping frames until the settings change: %s", e.what());
+		_decoderFailed = true;
+		return;
+	}
+
+	MOD_DEBUG("Constructed a RS(%d,%d) decoder with an interleaving depth of %d.",
+		getCodeLength(), getCodeLength() - maxErrors * 2, getInterleavingDepth());
+}
+
+void modCADU_Rcv::_startSearch(const std::size_t fromOctet) {
+	_sync.startSearch();
+	_searchOctet = fromOctet;
+	_candidate = false;
+}
+
+std::size_t modCADU_Rcv::_locate(std::size_t octet, std::size_t& offset) const {
+	std::size_t idx = 0;
+
+	while ( octet >= _held[idx]->getUnitLength() ) octet -= _held[idx++]->getUnitLength();
+
+	offset = octet;
+	return idx;
+}
+
+bool modCADU_Rcv::_search(AsmCorrelator::Match& match) {
+	if ( _searchOctet >= _heldLen ) return false;
+
+	std::size_t offset;
+	std::size_t blockStart = _searchOctet;
+
+	for ( std::size_t idx = _locate(_searchOctet, offset); idx < _held.size(); ++idx, offset = 0 ) {
+		const std::size_t len = _held[idx]->getUnitLength() - offset;
+
+		if ( _sync.getCorrelator().search(_held[idx]->ptrUnit() + offset, len, match) ) {
+			match.endOctet += blockStart;
+			return true;
+		}
+
+		blockStart += len;
+	}
+
+	return false;
+}
+
+void modCADU_Rcv::_copyBits(ACE_UINT8* dst, const std::size_t fromBit, const std::size_t len, const bool inverted) const {
+	const unsigned shift = fromBit % 8;
+	std::size_t offset;
+	std::size_t idx = _locate(fromBit / 8, offset);
+	ACE_UINT8 carry = *(_held[idx]->ptrUnit() + offset);
+
+	// With a shift, the first output octet begins in the octet after the carry.
+	if ( shift && ++offset == _held[idx]->getUnitLength() ) {
+		++idx;
+		offset = 0;
+	}
+
+	for ( std::size_t done = 0; done < len; ++idx, offset = 0 ) {
+		const std::size_t avail = _held[idx]->getUnitLength() - offset;
+		const std::size_t chunk = ( len - done < avail )? len - done : avail;
+
+		AsmCorrelator::realign(dst + done, _held[idx]->ptrUnit() + offset, chunk, shift, inverted, carry);
+		done += chunk;
+	}
+}
+
+void modCADU_Rcv::_releaseHeld() {
+	while ( ! _held.empty() ) {
+		ndSafeRelease(_held.front());
+		_held.pop_front();
+	}
+
+	_heldLen = 0;
+}
+
+void modCADU_Rcv::_discardUsedOctets() {
+	std::size_t used;
+
+	// The marker found by the correlator may begin a few octets before the search position.
+	if ( _sync.getState() == FrameSynchronizer::Search && ! _candidate ) {
+		const std::size_t history = AsmCorrelator::maxPatternLen + 1;
+		used = ( _searchOctet > history )? _searchOctet - history : 0;
+	}
+	else used = _nextBit / 8;
+
+	// Only whole blocks are released; frames already sent may still be slices of them.
+	while ( ! _held.empty() && used >= _held.front()->getUnitLength() ) {
+		const std::size_t blockLen = _held.front()->getUnitLength();
+
+		ndSafeRelease(_held.front());
+		_held.pop_front();
+
+		_heldLen -= blockLen;
+		used -= blockLen;
+		_searchOctet = ( _searchOctet > blockLen )? _searchOctet - blockLen : 0;
+		_nextBit = ( _nextBit >= blockLen * 8 )? _nextBit - blockLen * 8 : 0;
+	}
+}
+
+void modCADU_Rcv::_extractFrames() {
+	AsmCorrelator& correlator = _sync.getCorrelator();
+	const std::vector<ACE_UINT8>& marker = _sync.getMarker();
+	const std::size_t markerLen = marker.size();
+	const std::size_t frameLen = getExpectedUnitLength();
+	const std::size_t caduLen = markerLen + frameLen;
+	const unsigned allowedBitErrors = getAllowedMarkerBitErrors();
+
+	correlator.setAllowedBitErrors(allowedBitErrors);
+	correlator.setAcceptInverted(getAcceptInvertedMarker());
+	_sync.setCheckThreshold(getCheckThreshold());
+	_sync.setFlywheelThreshold(getFlywheelThreshold());
+
+	while ( true ) {
+		if ( _sync.getState() == FrameSynchronizer::Search && ! _candidate ) {
+			AsmCorrelator::Match match;
+
+			if ( ! _search(match) ) {
+				_searchOctet = _heldLen;
+				return;
+			}
+
+			_searchOctet = match.endOctet + 1;
+
+			// The correlated part of the marker ends match.shift bits into its last octet, or at its end if zero.
+			_nextBit = _searchOctet * 8 - ( match.shift? 8 - match.shift : 0 ) - correlator.getPatternLen() * 8;
+			_inverted = match.inverted;
+			_candidate = true;
+		}
+
+		const std::size_t octet = _nextBit / 8;
+		const unsigned shift = _nextBit % 8;
+
+		// A CADU that doesn't start on an octet boundary takes up one more octet.
+		if ( _heldLen < octet + caduLen + ( shift? 1 : 0 ) ) return;
+
+		NetworkData* frame = 0;
+		unsigned markerErrors;
+		std::size_t offset;
+		NetworkData* block = _held[_locate(octet, offset)];
+
+		if ( ! shift && ! _inverted && offset + caduLen <= block->getUnitLength() ) {
+			// Already aligned and in one block, so the frame can be a slice of it.
+			markerErrors = AsmCorrelator::countBitErrors(block->ptrUnit() + offset, &marker[0], markerLen);
+		}
+		else {
+			// Realign the marker and frame straight into the unit that will be sent.
+			frame = new NetworkData(caduLen, NetworkData::noFill);
+			_copyBits(frame->ptrUnit(), _nextBit, caduLen, _inverted);
+			markerErrors = AsmCorrelator::countBitErrors(frame->ptrUnit(), &marker[0], markerLen);
+		}
+
+		const bool discovered = _candidate;
+		_candidate = false;
+
+		if ( markerErrors <= allowedBitErrors ) {
+			++_asmCount;
+			_sync.markerFound(discovered);
+		}
+		else if ( discovered ) {
+			// Only the start of a long marker matched; keep looking past it.
+			ndSafeRelease(frame);
+			_startSearch(octet + 1);
+			continue;
+		}
+		else {
+			++_asmMissedCount;
+
+			if ( ! _sync.markerMissed() ) {
+				MOD_DEBUG("Missed ASM, searching at every bit offset.");
+				ndSafeRelease(frame);
+				_startSearch(octet);
+				continue;
+			}
+		}
+
+		_nextBit += caduLen * 8;
+
+		if ( frame ) frame->rd_ptr(markerLen);
+		else frame = block->wrapInnerPDU<NetworkData>(frameLen, block->ptrUnit() + offset + markerLen);
+
+		_finishFrame(frame);
+	}
+}
+
+void modCADU_Rcv::_finishFrame(NetworkData* frame) {
+	const std::size_t frameLen = frame->getUnitLength();
+
+	if ( _decoderFailed ) {
+		ndSafeRelease(frame);
+		return;
+	}
+
+	if ( getDerandomize() ) PseudoRandomSequence::apply(frame->ptrUnit(), frameLen);
+
+	if ( _rsDecoder ) {
+		const std::size_t parityLen = _rsDecoder->getTotalParityLength();
+
+		if ( frameLen > _rsDecoder->getCodeLength() * _rsDecoder->getInterleaveDepth() || frameLen <= parityLen ) {
+			MOD_WARNING("Coded frame length %d does not suit RS(%d,%d) with interleaving depth %d, dropping.",
+				frameLen, _rsDecoder->getCodeLength(), _rsDecoder->getCodeLength() - _rsDecoder->getParityLength(),
+				_rsDecoder->getInterleaveDepth());
+			ndSafeRelease(frame);
+			return;
+		}
+
+		try {
+			std::size_t errs = 0;
+
+			if ( ! _rsDecoder->syndromesClear(frame->ptrUnit(), frameLen) )
+				errs = _rsDecoder->correctInPlace(frame->ptrUnit(), frameLen);
+
+			if ( errs == 0 ) ++_errorlessUnitCount;
+			else ++_correctedUnitCount;
+
+			_correctedErrorCount += errs;
+
+			// Drop the parity; the frame itself stays where it is.
+			frame->setUnitLength(frameLen - parityLen, true);
+		}
+		catch (RSDecoder::TooManyErrors& tme) {
+			++_uncorrectedUnitCount;
+			_uncorrectedErrorCount += tme.errors;
+			MOD_NOTICE("Failed to decode: %s. Dropping frame.", tme.what());
+			ndSafeRelease(frame);
+			return;
+		}
+		catch (std::logic_error& e) {
+			MOD_WARNING("Failed to decode: %s. Dropping frame.", e.what());
+			ndSafeRelease(frame);
+			return;
+		}
+	}
+
+	MOD_DEBUG("Sending a %d-octet frame.", frame->getUnitLength());
+	links_[PrimaryOutputLink]->send(frame);
+}
+
+int modCADU_Rcv::svc() {
+	svcStart_();
+
+	_updateMarker();
+	_releaseHeld();
+	_nextBit = 0;
+	_startSearch(0);
+
+	while ( continueService() ) {
+		std::pair<NetworkData*, int> queueTop = getData_();
+
+		if ( msg_queue()->deactivated() ) break;
+
+		if ( queueTop.second < 0 ) {
+			MOD_ERROR("getData_() call failed.");
+			continue;
+		}
+		else if ( ! queueTop.first ) {
+			MOD_ERROR("getData_() returned with null data.");
+			continue;
+		}
+
+		NetworkData* data = queueTop.first;
+
+		MOD_DEBUG("Received %d octets to synchronize and decode.", data->getUnitLength());
+
+		if ( ! links_[PrimaryOutputLink] ) {
+			MOD_NOTICE("No output target defined yet, dropping data.");
+			ndSafeRelease(data);
+			continue;
+		}
+
+		_updateDecoder();
+
+		if ( ! data->getUnitLength() ) {
+			ndSafeRelease(data);
+			continue;
+		}
+
+		// Frames are derandomized and corrected in place, so a block that
+		// another unit shares has to be copied first.
+		if ( data->reference_count() > 1 ) {
+			NetworkData* own = new NetworkData(data);
+			ndSafeRelease(data);
+			data = own;
+		}
+
+		_discardUsedOctets();
+		_held.push_back(data);
+		_heldLen += data->getUnitLength();
+
+		_extractFrames();
+	}
+
+	_releaseHeld();
+
+	return svcEnd_();
+}
+
+} // namespace nCADU_Rcv
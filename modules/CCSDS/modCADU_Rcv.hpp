@@ -0,0 +1,435 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   modCADU_Rcv.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _MOD_CADU_RCV_HPP_
+#define _MOD_CADU_RCV_HPP_
+
+#include "BaseTrafficHandler.hpp"
+#include "FrameSynchronizer.hpp"
+#include "RSDecoder.hpp"
+
+#include <deque>
+#include <vector>
+
+namespace nCADU_Rcv {
+
+//=============================================================================
+/**
+	@class modCADU_Rcv
+	@author Tad Kollar
+	@brief Turn a stream of CADUs back into transfer frames in one segment.
+
+	Does the work of modASM_Remove, modPseudoRandomize, and modRSDecode without
+	the two queues between them. The received blocks are held until every frame
+	in them is taken. A frame that starts on an octet boundary within one block
+	is a slice of it, derandomized and corrected where it lies. Only a frame
+	that is bit-shifted, inverted, or split across blocks is copied, realigned
+	on the way, into a new unit.
+
+	Synchronization follows modASM_Remove, using the same FrameSynchronizer.
+	The Reed-Solomon settings are those of modRSDecode and default to the
+	CCSDS code; a maximum of zero errors per codeword turns decoding off.
+*/
+//=============================================================================
+class modCADU_Rcv: public BaseTrafficHandler {
+public:
+	/// Primary constructor.
+	/// @param newName An identifier for the module that's unique within the channel.
+	/// @param newChannelName An identifier for the containing channel.
+	/// @param newDLLPtr Pointer to the DLL management structure.
+	modCADU_Rcv(const std::string& newName, const std::string& newChannelName,
+		const CE_DLL* newDLLPtr);
+
+	/// Destructor.
+	~modCADU_Rcv();
+
+	/// Reads in the coded stream and sends each decoded frame.
+	int svc();
+
+	/// Set the contents of _marker.
+	/// @param asmBuf The buffer holding the new marker.
+	/// @param bufLen The length of the pattern in the buffer.
+	void setMarker(const uint8_t* asmBuf, const int bufLen);
+
+	/// Set the contents of _marker.
+	/// @param newMarker A vector containing the new pattern.
+	void setMarker(const std::vector<uint8_t>& newMarker);
+
+	/// Return the contents of _marker.
+	/// @param marker A vector to copy _marker into.
+	void getMarker(std::vector<uint8_t>& marker) const;
+
+	/// Write-only accessor to _expectedUnitLengthSetting.
+	/// @throw ValueTooSmall If newVal is less than 1.
+	void setExpectedUnitLength(const int newVal) {
+		if ( newVal < 1 ) throw ValueTooSmall(ValueTooSmall::msg("Expected unit length", newVal, 1));
+		_expectedUnitLengthSetting = newVal;
+		NetworkDataPool::instance()->addSizeClass(_marker.getLength() + newVal);
+	}
+
+	/// The length of the coded frame following each marker, parity included.
+	int getExpectedUnitLength() const { return _expectedUnitLengthSetting; }
+
+	/// Write-only accessor to _allowedMarkerBitErrorsSetting.
+	/// @throw ValueTooSmall If newVal is negative.
+	void setAllowedMarkerBitErrors(const int newVal) {
+		if ( newVal < 0 ) throw ValueTooSmall(ValueTooSmall::msg("Allowed marker bit errors", newVal, 0));
+		_allowedMarkerBitErrorsSetting = newVal;
+	}
+
+	/// Read-only accessor to _allowedMarkerBitErrorsSetting.
+	int getAllowedMarkerBitErrors() const { return _allowedMarkerBitErrorsSetting; }
+
+	/// Write-only accessor to _acceptInvertedMarkerSetting; off unless enabled.
+	void setAcceptInvertedMarker(const bool newVal) { _acceptInvertedMarkerSetting = newVal; }
+
+	/// Read-only accessor to _acceptInvertedMarkerSetting.
+	bool getAcceptInvertedMarker() const { return _acceptInvertedMarkerSetting; }
+
+	/// Write-only accessor to _checkThresholdSetting.
+	/// @throw ValueTooSmall If newVal is negative.
+	void setCheckThreshold(const int newVal) {
+		if ( newVal < 0 ) throw ValueTooSmall(ValueTooSmall::msg("Check threshold", newVal, 0));
+		_checkThresholdSetting = newVal;
+	}
+
+	/// Read-only accessor to _checkThresholdSetting.
+	int getCheckThreshold() const { return _checkThresholdSetting; }
+
+	/// Write-only accessor to _flywheelThresholdSetting.
+	/// @throw ValueTooSmall If newVal is negative.
+	void setFlywheelThreshold(const int newVal) {
+		if ( newVal < 0 ) throw ValueTooSmall(ValueTooSmall::msg("Flywheel threshold", newVal, 0));
+		_flywheelThresholdSetting = newVal;
+	}
+
+	/// Read-only accessor to _flywheelThresholdSetting.
+	int getFlywheelThreshold() const { return _flywheelThresholdSetting; }
+
+	/// Write-only accessor to _derandomizeSetting.
+	void setDerandomize(const bool newVal) { _derandomizeSetting = newVal; }
+
+	/// Read-only accessor to _derandomizeSetting.
+	bool getDerandomize() const { return _derandomizeSetting; }
+
+	/// @brief Write-only accessor to _maxErrorsPerCodewordSetting. Takes effect with the next frame.
+	/// @param newVal The Reed-Solomon correction capability; CCSDS uses 8 or 16, and 0 turns decoding off.
+	/// @throw ValueOutOfRange If newVal is not between 0 and 127.
+	void setMaxErrorsPerCodeword(const int newVal) {
+		if ( newVal < 0 || newVal > 127 ) throw ValueOutOfRange(ValueOutOfRange::msg("Max errors per codeword", newVal, 0, 127));
+		_maxErrorsPerCodewordSetting = newVal;
+		_rebuildDecoder = true;
+	}
+
+	/// Read-only accessor to _maxErrorsPerCodewordSetting.
+	int getMaxErrorsPerCodeword() const { return _maxErrorsPerCodewordSetting; }
+
+	/// @brief Write-only accessor to _interleavingDepthSetting. Takes effect with the next frame.
+	/// @throw ValueOutOfRange If newVal is not between 1 and 255.
+	void setInterleavingDepth(const int newVal) {
+		if ( newVal < 1 || newVal > 255 ) throw ValueOutOfRange(ValueOutOfRange::msg("Interleaving depth", newVal, 1, 255));
+		_interleavingDepthSetting = newVal;
+		_rebuildDecoder = true;
+	}
+
+	/// Read-only accessor to _interleavingDepthSetting.
+	int getInterleavingDepth() const { return _interleavingDepthSetting; }
+
+	/// @brief Write-only accessor to _primitivePolySetting. Takes effect with the next frame.
+	/// Whether it is actually primitive is checked when the decoder is rebuilt.
+	/// @throw ValueOutOfRange If newVal is not a polynomial of degree 2 through 8.
+	void setPrimitivePoly(const int newVal) {
+		if ( newVal < 0x4 || newVal > 0x1ff )
+			throw ValueOutOfRange(ValueOutOfRange::msg("Primitive polynomial", newVal, 0x4, 0x1ff));
+		_primitivePolySetting = newVal;
+		_rebuildDecoder = true;
+	}
+
+	/// Read-only accessor to _primitivePolySetting.
+	int getPrimitivePoly() const { return _primitivePolySetting; }
+
+	/// @brief Write-only accessor to _codeLengthSetting. Takes effect with the next frame.
+	/// Values below 2^bitsPerSymbol - 1 select a shortened code.
+	/// @throw ValueOutOfRange If newVal is not between 3 and 255.
+	void setCodeLength(const int newVal) {
+		if ( newVal < 3 || newVal > 255 ) throw ValueOutOfRange(ValueOutOfRange::msg("Code length", newVal, 3, 255));
+		_codeLengthSetting = newVal;
+		_rebuildDecoder = true;
+	}
+
+	/// Read-only accessor to _codeLengthSetting.
+	int getCodeLength() const { return _codeLengthSetting; }
+
+	/// @brief Write-only accessor to _bitsPerSymbolSetting. Takes effect with the next frame.
+	/// @throw ValueOutOfRange If newVal is not between 2 and 8.
+	void setBitsPerSymbol(const int newVal) {
+		if ( newVal < 2 || newVal > 8 ) throw ValueOutOfRange(ValueOutOfRange::msg("Bits per symbol", newVal, 2, 8));
+		_bitsPerSymbolSetting = newVal;
+		_rebuildDecoder = true;
+	}
+
+	/// Read-only accessor to _bitsPerSymbolSetting.
+	int getBitsPerSymbol() const { return _bitsPerSymbolSetting; }
+
+	/// @brief Write-only accessor to _primitiveRootIdxSetting. Takes effect with the next frame.
+	/// @throw ValueOutOfRange If newVal is not between 1 and 254.
+	void setPrimitiveRootIdx(const int newVal) {
+		if ( newVal < 1 || newVal > 254 ) throw ValueOutOfRange(ValueOutOfRange::msg("Primitive root index", newVal, 1, 254));
+		_primitiveRootIdxSetting = newVal;
+		_rebuildDecoder = true;
+	}
+
+	/// Read-only accessor to _primitiveRootIdxSetting.
+	int getPrimitiveRootIdx() const { return _primitiveRootIdxSetting; }
+
+	/// @brief Write-only accessor to _firstConsecutiveRootSetting. Takes effect with the next frame.
+	/// @param newVal The power of the primitive root that is the generator's first root,
+	/// or -1 to choose it as CCSDS does.
+	/// @throw ValueTooLarge If newVal is over 254.
+	void setFirstConsecutiveRoot(const int newVal) {
+		if ( newVal > 254 ) throw ValueTooLarge(ValueTooLarge::msg("First consecutive root", newVal, 254));
+		_firstConsecutiveRootSetting = ( newVal < 0 )? -1 : newVal;
+		_rebuildDecoder = true;
+	}
+
+	/// @brief The first consecutive root in use. If none was set, it is 2^(bitsPerSymbol - 1) - E,
+	/// as in modRSDecode.
+	int getFirstConsecutiveRoot() const {
+		const int fcr = _firstConsecutiveRootSetting;
+		return ( fcr >= 0 )? fcr : ( 1 << (getBitsPerSymbol() - 1) ) - getMaxErrorsPerCodeword();
+	}
+
+	/// Write-only accessor to _dualBasisSetting. Takes effect with the next frame.
+	void setDualBasis(const bool newVal) {
+		_dualBasisSetting = newVal;
+		_rebuildDecoder = true;
+	}
+
+	/// Read-only accessor to _dualBasisSetting.
+	bool getDualBasis() const { return _dualBasisSetting; }
+
+	/// The current synchronizer state.
+	FrameSynchronizer::State getSyncState() const { return _sync.getState(); }
+
+	/// The name of the current synchronizer state.
+	std::string getSyncStateName() const { return _sync.getStateName(); }
+
+	/// Write-only accessor to _asmCount.
+	void setAsmCount(const uint64_t& newVal) { _asmCount = newVal; }
+
+	/// Read-only accessor to _asmCount.
+	uint64_t getAsmCount() const { return _asmCount; }
+
+	/// Write-only accessor to _asmMissedCount.
+	void setAsmMissedCount(const uint64_t& newVal) { _asmMissedCount = newVal; }
+
+	/// Read-only accessor to _asmMissedCount.
+	uint64_t getAsmMissedCount() const { return _asmMissedCount; }
+
+	/// Write-only accessor to the synchronizer's search count.
+	void setSearchCount(const uint64_t& newVal) { _sync.setSearchCount(newVal); }
+
+	/// Read-only accessor to the synchronizer's search count.
+	uint64_t getSearchCount() const { return _sync.getSearchCount(); }
+
+	/// Write-only accessor to the synchronizer's lock count.
+	void setLockCount(const uint64_t& newVal) { _sync.setLockCount(newVal); }
+
+	/// Read-only accessor to the synchronizer's lock count.
+	uint64_t getLockCount() const { return _sync.getLockCount(); }
+
+	/// Write-only accessor to the synchronizer's lock loss count.
+	void setLockLossCount(const uint64_t& newVal) { _sync.setLockLossCount(newVal); }
+
+	/// Read-only accessor to the synchronizer's lock loss count.
+	uint64_t getLockLossCount() const { return _sync.getLockLossCount(); }
+
+	/// Write-only accessor to the synchronizer's flywheel count.
+	void setFlywheelCount(const uint64_t& newVal) { _sync.setFlywheelCount(newVal); }
+
+	/// Read-only accessor to the synchronizer's flywheel count.
+	uint64_t getFlywheelCount() const { return _sync.getFlywheelCount(); }
+
+	/// Write-only accessor to _correctedErrorCount.
+	void setCorrectedErrorCount(const uint64_t& newVal) { _correctedErrorCount = newVal; }
+
+	/// Read-only accessor to _correctedErrorCount.
+	uint64_t getCorrectedErrorCount() const { return _correctedErrorCount; }
+
+	/// Write-only accessor to _uncorrectedErrorCount.
+	void setUncorrectedErrorCount(const uint64_t& newVal) { _uncorrectedErrorCount = newVal; }
+
+	/// Read-only accessor to _uncorrectedErrorCount.
+	uint64_t getUncorrectedErrorCount() const { return _uncorrectedErrorCount; }
+
+	/// Write-only accessor to _errorlessUnitCount.
+	void setErrorlessUnitCount(const uint64_t& newVal) { _errorlessUnitCount = newVal; }
+
+	/// Read-only accessor to _errorlessUnitCount.
+	uint64_t getErrorlessUnitCount() const { return _errorlessUnitCount; }
+
+	/// Write-only accessor to _correctedUnitCount.
+	void setCorrectedUnitCount(const uint64_t& newVal) { _correctedUnitCount = newVal; }
+
+	/// Read-only accessor to _correctedUnitCount.
+	uint64_t getCorrectedUnitCount() const { return _correctedUnitCount; }
+
+	/// Write-only accessor to _uncorrectedUnitCount.
+	void setUncorrectedUnitCount(const uint64_t& newVal) { _uncorrectedUnitCount = newVal; }
+
+	/// Read-only accessor to _uncorrectedUnitCount.
+	uint64_t getUncorrectedUnitCount() const { return _uncorrectedUnitCount; }
+
+private:
+	/// The ASM to look for.
+	Setting& _marker;
+
+	/// Config file setting for the coded frame length after each marker.
+	Setting& _expectedUnitLengthSetting;
+
+	/// Config file setting for the most bit errors accepted in a marker.
+	Setting& _allowedMarkerBitErrorsSetting;
+
+	/// Config file setting for whether a complemented marker is accepted, and its frame inverted.
+	Setting& _acceptInvertedMarkerSetting;
+
+	/// Config file setting for the markers that must follow a discovered one before locking.
+	Setting& _checkThresholdSetting;
+
+	/// Config file setting for the consecutive missed markers tolerated in lock.
+	Setting& _flywheelThresholdSetting;
+
+	/// Config file setting for whether frames are XORed with the pseudo-random sequence.
+	Setting& _derandomizeSetting;
+
+	/// Config file setting for the Reed-Solomon correction capability; 0 for none.
+	Setting& _maxErrorsPerCodewordSetting;
+
+	/// Config file setting for the number of interleaved codewords per frame.
+	Setting& _interleavingDepthSetting;
+
+	/// Config file setting for the field polynomial; 0x187 for CCSDS.
+	Setting& _primitivePolySetting;
+
+	/// Config file setting for the symbols per codeword, data plus parity; 255 for CCSDS.
+	Setting& _codeLengthSetting;
+
+	/// Config file setting for the size of each symbol; 8 for CCSDS.
+	Setting& _bitsPerSymbolSetting;
+
+	/// Config file setting for the power of alpha used as the primitive root; 11 for CCSDS.
+	Setting& _primitiveRootIdxSetting;
+
+	/// Config file setting for the first root of the generator, or -1 for automatic.
+	Setting& _firstConsecutiveRootSetting;
+
+	/// Config file setting for whether symbols are sent in Berlekamp's dual basis, as CCSDS does.
+	Setting& _dualBasisSetting;
+
+	/// The marker, copied from _marker when the segment starts, and the synchronizer state.
+	FrameSynchronizer _sync;
+
+	/// Received blocks not yet made into frames, oldest first.
+	std::deque<NetworkData*> _held;
+
+	/// The total unit length of the blocks in _held.
+	std::size_t _heldLen;
+
+	/// While searching, the next octet of _held for the correlator.
+	std::size_t _searchOctet;
+
+	/// While synchronized, the bit of _held where the next marker should begin.
+	std::size_t _nextBit;
+
+	/// True if the marker at _nextBit was found by searching and hasn't been checked in full.
+	bool _candidate;
+
+	/// Whether the stream is being received complemented.
+	bool _inverted;
+
+	/// Set when the Reed-Solomon settings change.
+	bool _rebuildDecoder;
+
+	/// Decodes the frames; null when decoding is off.
+	RSDecoder* _rsDecoder;
+
+	/// True if the Reed-Solomon settings don't make a valid code; frames are dropped until they do.
+	bool _decoderFailed;
+
+	/// The total number of markers found.
+	uint64_t _asmCount;
+
+	/// The total number of markers missing where expected.
+	uint64_t _asmMissedCount;
+
+	/// The total number of errors fixed.
+	uint64_t _correctedErrorCount;
+
+	/// The total number of errors that could not be fixed.
+	uint64_t _uncorrectedErrorCount;
+
+	/// The total number of frames that had no errors.
+	uint64_t _errorlessUnitCount;
+
+	/// The total number of frames that were repaired.
+	uint64_t _correctedUnitCount;
+
+	/// The total number of frames that could not be repaired.
+	uint64_t _uncorrectedUnitCount;
+
+	/// Copy _marker into the synchronizer.
+	void _updateMarker();
+
+	/// Replace _rsDecoder if the Reed-Solomon settings have changed.
+	void _updateDecoder();
+
+	/// Move to SEARCH, correlating from the given octet of _held.
+	void _startSearch(const std::size_t fromOctet);
+
+	/// @brief Find the held block containing an octet.
+	/// @param octet An octet of _held, which must be less than _heldLen.
+	/// @param offset Receives the position of the octet within the block.
+	/// @return The index of the block in _held.
+	std::size_t _locate(std::size_t octet, std::size_t& offset) const;
+
+	/// @brief Correlate the held blocks from _searchOctet onward.
+	/// @param match Receives the location of the marker, with endOctet counted from the start of _held.
+	/// @return True if a marker was found.
+	bool _search(AsmCorrelator::Match& match);
+
+	/// @brief Copy and realign octets of _held that may span several blocks.
+	/// @param dst Receives len octets.
+	/// @param fromBit The bit of _held to start at.
+	/// @param len The number of octets to write.
+	/// @param inverted Whether to complement every bit.
+	void _copyBits(ACE_UINT8* dst, const std::size_t fromBit, const std::size_t len, const bool inverted) const;
+
+	/// Make frames from _held until it runs out.
+	void _extractFrames();
+
+	/// Release the held blocks that are no longer needed.
+	void _discardUsedOctets();
+
+	/// Release every held block.
+	void _releaseHeld();
+
+	/// Derandomize and decode a frame in place, then send it.
+	/// @param frame The coded frame, which is consumed.
+	void _finishFrame(NetworkData* frame);
+
+}; // class modCADU_Rcv
+
+} // namespace nCADU_Rcv
+
+#endif // _MOD_CADU_RCV_HPP_
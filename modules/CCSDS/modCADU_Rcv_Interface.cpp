@@ -0,0 +1,233 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   modCADU_Rcv_Interface.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "modCADU_Rcv.hpp"
+#include "TrafficHandler_Interface.hpp"
+
+namespace nCADU_Rcv {
+
+//=============================================================================
+/**
+ * @class modCADU_Rcv_Interface
+ * @author Tad Kollar
+ * @brief Provide an XML-RPC interface to the CADU Receive module.
+ */
+//=============================================================================
+class modCADU_Rcv_Interface: public nasaCE::TrafficHandler_Interface<modCADU_Rcv> {
+public:
+	modCADU_Rcv_Interface(xmlrpc_c::registryPtr& rpcRegistry):
+		nasaCE::TrafficHandler_Interface<modCADU_Rcv>(rpcRegistry, "modCADU_Rcv") {
+		ACE_TRACE("modCADU_Rcv_Interface::modCADU_Rcv_Interface");
+
+		register_methods(rpcRegistry);
+	}
+
+	void set_marker(xmlrpc_c::paramList const& paramList, xmlrpc_c::value* retvalP) {
+		ACE_TRACE("modCADU_Rcv_Interface::set_marker");
+		const std::vector<xmlrpc_c::value> xml_rpc_marker = paramList.getArray(2);
+
+		std::vector<uint8_t> marker;
+
+		for (unsigned i = 0; i < xml_rpc_marker.size(); i++ ) {
+			marker.push_back(xmlrpc_c::value_int(xml_rpc_marker[i]));
+		}
+
+		find_handler(paramList)->setMarker(marker);
+
+		*retvalP = xmlrpc_c::value_nil();
+	}
+
+	void get_marker(xmlrpc_c::paramList const& paramList, xmlrpc_c::value* retvalP) {
+		ACE_TRACE("modCADU_Rcv_Interface::get_marker");
+
+		std::vector<uint8_t> marker;
+		find_handler(paramList)->getMarker(marker);
+
+		std::vector<xmlrpc_c::value> xml_rpc_marker;
+
+		for (unsigned i = 0; i < marker.size(); i++ ) {
+			xml_rpc_marker.push_back(xmlrpc_c::value_int(marker[i]));
+		}
+
+		*retvalP = xmlrpc_c::value_array(xml_rpc_marker);
+	}
+
+	GENERATE_INT_ACCESSORS(expected_unit_length, setExpectedUnitLength, getExpectedUnitLength);
+	GENERATE_INT_ACCESSORS(allowed_bit_errors, setAllowedMarkerBitErrors, getAllowedMarkerBitErrors);
+	GENERATE_BOOL_ACCESSORS(accept_inverted, setAcceptInvertedMarker, getAcceptInvertedMarker);
+	GENERATE_INT_ACCESSORS(check_threshold, setCheckThreshold, getCheckThreshold);
+	GENERATE_INT_ACCESSORS(flywheel_threshold, setFlywheelThreshold, getFlywheelThreshold);
+	GENERATE_BOOL_ACCESSORS(derandomize, setDerandomize, getDerandomize);
+	GENERATE_INT_ACCESSORS(max_errors_per_codeword, setMaxErrorsPerCodeword, getMaxErrorsPerCodeword);
+	GENERATE_INT_ACCESSORS(interleaving_depth, setInterleavingDepth, getInterleavingDepth);
+	GENERATE_INT_ACCESSORS(primitive_poly, setPrimitivePoly, getPrimitivePoly);
+	GENERATE_INT_ACCESSORS(code_length, setCodeLength, getCodeLength);
+	GENERATE_INT_ACCESSORS(bits_per_symbol, setBitsPerSymbol, getBitsPerSymbol);
+	GENERATE_INT_ACCESSORS(primitive_root_idx, setPrimitiveRootIdx, getPrimitiveRootIdx);
+	GENERATE_INT_ACCESSORS(first_consecutive_root, setFirstConsecutiveRoot, getFirstConsecutiveRoot);
+	GENERATE_BOOL_ACCESSORS(dual_basis, setDualBasis, getDualBasis);
+	GENERATE_I8_ACCESSORS(asm_count, setAsmCount, getAsmCount);
+	GENERATE_I8_ACCESSORS(asm_missed, setAsmMissedCount, getAsmMissedCount);
+	GENERATE_I8_ACCESSORS(asm_searches, setSearchCount, getSearchCount);
+	GENERATE_I8_ACCESSORS(lock_count, setLockCount, getLockCount);
+	GENERATE_I8_ACCESSORS(lock_loss_count, setLockLossCount, getLockLossCount);
+	GENERATE_I8_ACCESSORS(flywheel_count, setFlywheelCount, getFlywheelCount);
+	GENERATE_I8_ACCESSORS(corrected_error_count, setCorrectedErrorCount, getCorrectedErrorCount);
+	GENERATE_I8_ACCESSORS(uncorrected_error_count, setUncorrectedErrorCount, getUncorrectedErrorCount);
+	GENERATE_I8_ACCESSORS(errorless_unit_count, setErrorlessUnitCount, getErrorlessUnitCount);
+	GENERATE_I8_ACCESSORS(corrected_unit_count, setCorrectedUnitCount, getCorrectedUnitCount);
+	GENERATE_I8_ACCESSORS(uncorrected_unit_count, setUncorrectedUnitCount, getUncorrectedUnitCount);
+
+	/// Export specified methods via XML-RPC.
+	void register_methods(xmlrpc_c::registryPtr&);
+
+protected:
+	void get_counters_(xmlrpc_c::paramList const& paramList, modCADU_Rcv* handler,
+		xstruct& counters) {
+		ACE_TRACE("modCADU_Rcv_Interface::get_counters_");
+
+		nasaCE::TrafficHandler_Interface<modCADU_Rcv>::get_counters_(paramList, handler, counters);
+
+		counters["asmCount"] = xmlrpc_c::value_i8(handler->getAsmCount());
+		counters["asmMissedCount"] = xmlrpc_c::value_i8(handler->getAsmMissedCount());
+		counters["asmSearchCount"] = xmlrpc_c::value_i8(handler->getSearchCount());
+		counters["lockCount"] = xmlrpc_c::value_i8(handler->getLockCount());
+		counters["lockLossCount"] = xmlrpc_c::value_i8(handler->getLockLossCount());
+		counters["flywheelCount"] = xmlrpc_c::value_i8(handler->getFlywheelCount());
+		counters["syncState"] = xmlrpc_c::value_string(handler->getSyncStateName());
+		counters["correctedErrors"] = xmlrpc_c::value_i8(handler->getCorrectedErrorCount());
+		counters["uncorrectedErrors"] = xmlrpc_c::value_i8(handler->getUncorrectedErrorCount());
+		counters["errorlessUnits"] = xmlrpc_c::value_i8(handler->getErrorlessUnitCount());
+		counters["correctedUnits"] = xmlrpc_c::value_i8(handler->getCorrectedUnitCount());
+		counters["uncorrectedUnits"] = xmlrpc_c::value_i8(handler->getUncorrectedUnitCount());
+	}
+
+	void get_settings_(xmlrpc_c::paramList const& paramList, modCADU_Rcv* handler,
+		xstruct& settings) {
+		ACE_TRACE("modCADU_Rcv_Interface::get_settings_");
+
+		nasaCE::TrafficHandler_Interface<modCADU_Rcv>::get_settings_(paramList, handler, settings);
+		using namespace std;
+
+		vector<uint8_t> marker;
+		handler->getMarker(marker);
+		vector<uint8_t>::iterator pos;
+		ostringstream os;
+
+		for ( pos = marker.begin(); pos != marker.end(); ++pos )
+			os << uppercase << hex << setw(2) << setfill('0') << static_cast<int>(*pos);
+
+		settings["markerPattern"] = xmlrpc_c::value_string(os.str());
+		settings["expectedUnitLength"] = xmlrpc_c::value_int(handler->getExpectedUnitLength());
+		settings["allowedMarkerBitErrors"] = xmlrpc_c::value_int(handler->getAllowedMarkerBitErrors());
+		settings["acceptInvertedMarker"] = xmlrpc_c::value_boolean(handler->getAcceptInvertedMarker());
+		settings["checkThreshold"] = xmlrpc_c::value_int(handler->getCheckThreshold());
+		settings["flywheelThreshold"] = xmlrpc_c::value_int(handler->getFlywheelThreshold());
+		settings["derandomize"] = xmlrpc_c::value_boolean(handler->getDerandomize());
+		settings["maxErrorsPerCodeword"] = xmlrpc_c::value_int(handler->getMaxErrorsPerCodeword());
+		settings["interleavingDepth"] = xmlrpc_c::value_int(handler->getInterleavingDepth());
+		settings["primitivePoly"] = xmlrpc_c::value_int(handler->getPrimitivePoly());
+		settings["codeLength"] = xmlrpc_c::value_int(handler->getCodeLength());
+		settings["bitsPerSymbol"] = xmlrpc_c::value_int(handler->getBitsPerSymbol());
+		settings["primitiveRootIdx"] = xmlrpc_c::value_int(handler->getPrimitiveRootIdx());
+		settings["firstConsecutiveRoot"] = xmlrpc_c::value_int(handler->getFirstConsecutiveRoot());
+		settings["dualBasis"] = xmlrpc_c::value_boolean(handler->getDualBasis());
+	}
+};
+
+modCADU_Rcv_Interface* modCADU_Rcv_InterfaceP;
+
+TEMPLATE_METHOD_CLASSES(modCADU_Rcv_Interface, modCADU_Rcv_InterfaceP);
+METHOD_CLASS(set_marker, "n:A", "Sets a new attached sync marker (ASM).", modCADU_Rcv_InterfaceP);
+METHOD_CLASS(get_marker, "A:n", "Returns the current attached sync marker (ASM).", modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(expected_unit_length, i, "the length of each coded frame after its ASM.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(allowed_bit_errors, i, "the number of bit errors allowed in an ASM match.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(accept_inverted, b, "whether a complemented ASM is accepted and its frame inverted (default false).",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(check_threshold, i, "the number of markers that must follow a discovered one before lock.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(flywheel_threshold, i, "the number of consecutive missed markers tolerated in lock.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(derandomize, b, "whether frames are XORed with the pseudo-random sequence.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(max_errors_per_codeword, i, "the Reed-Solomon errors correctable per codeword, or 0 for no decoding.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(interleaving_depth, i, "the number of Reed-Solomon codewords interleaved in each frame.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(primitive_poly, i, "the field polynomial, such as 0x187 for CCSDS.", modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(code_length, i, "the number of symbols per codeword; less than 2^bitsPerSymbol - 1 for a shortened code.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(bits_per_symbol, i, "the size of each symbol, from 2 to 8 bits.", modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(primitive_root_idx, i, "the power of alpha used as the code's primitive root.", modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(first_consecutive_root, i, "the first root of the generator polynomial, or -1 to choose as CCSDS does.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(dual_basis, b, "whether symbols are sent in Berlekamp's dual basis.", modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(asm_count, i, "the grand total of ASMs that were located.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(asm_missed, i, "the tally of ASMs that were not where they were supposed to be.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(asm_searches, i, "the tally of ASM searches started.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(lock_count, i, "the tally of times the synchronizer locked.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(lock_loss_count, i, "the tally of times lock was lost.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(flywheel_count, i, "the tally of missed ASMs passed over while locked.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(corrected_error_count, i, "the tally of errors fixed.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(uncorrected_error_count, i, "the tally of errors that could not be fixed.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(errorless_unit_count, i, "the tally of frames that had no errors.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(corrected_unit_count, i, "the tally of frames that were repaired.",
+	modCADU_Rcv_InterfaceP);
+GENERATE_ACCESSOR_METHODS(uncorrected_unit_count, i, "the tally of frames that could not be repaired.",
+	modCADU_Rcv_InterfaceP);
+
+void modCADU_Rcv_Interface::register_methods(xmlrpc_c::registryPtr& rpcRegistry) {
+	ACE_TRACE("modCADU_Rcv_Interface::register_methods");
+
+	TEMPLATE_REGISTER_METHODS(modCADU_Rcv, modCADU_Rcv_Interface);
+	REGISTER_ACCESSOR_METHODS(marker, modCADU_Rcv, ASM);
+	REGISTER_ACCESSOR_METHODS(expected_unit_length, modCADU_Rcv, ExpectedUnitLength);
+	REGISTER_ACCESSOR_METHODS(allowed_bit_errors, modCADU_Rcv, AllowedMarkerBitErrors);
+	REGISTER_ACCESSOR_METHODS(accept_inverted, modCADU_Rcv, AcceptInvertedMarker);
+	REGISTER_ACCESSOR_METHODS(check_threshold, modCADU_Rcv, CheckThreshold);
+	REGISTER_ACCESSOR_METHODS(flywheel_threshold, modCADU_Rcv, FlywheelThreshold);
+	REGISTER_ACCESSOR_METHODS(derandomize, modCADU_Rcv, Derandomize);
+	REGISTER_ACCESSOR_METHODS(max_errors_per_codeword, modCADU_Rcv, MaxErrorsPerCodeword);
+	REGISTER_ACCESSOR_METHODS(interleaving_depth, modCADU_Rcv, InterleavingDepth);
+	REGISTER_ACCESSOR_METHODS(primitive_poly, modCADU_Rcv, PrimitivePoly);
+	REGISTER_ACCESSOR_METHODS(code_length, modCADU_Rcv, CodeLength);
+	REGISTER_ACCESSOR_METHODS(bits_per_symbol, modCADU_Rcv, BitsPerSymbol);
+	REGISTER_ACCESSOR_METHODS(primitive_root_idx, modCADU_Rcv, PrimitiveRootIdx);
+	REGISTER_ACCESSOR_METHODS(first_consecutive_root, modCADU_Rcv, FirstConsecutiveRoot);
+	REGISTER_ACCESSOR_METHODS(dual_basis, modCADU_Rcv, DualBasis);
+	REGISTER_ACCESSOR_METHODS(asm_count, modCADU_Rcv, ASMCount);
+	REGISTER_ACCESSOR_METHODS(asm_missed, modCADU_Rcv, ASMMissedCount);
+	REGISTER_ACCESSOR_METHODS(asm_searches, modCADU_Rcv, ASMSearches);
+	REGISTER_ACCESSOR_METHODS(lock_count, modCADU_Rcv, LockCount);
+	REGISTER_ACCESSOR_METHODS(lock_loss_count, modCADU_Rcv, LockLossCount);
+	REGISTER_ACCESSOR_METHODS(flywheel_count, modCADU_Rcv, FlywheelCount);
+	REGISTER_ACCESSOR_METHODS(corrected_error_count, modCADU_Rcv, CorrectedErrorCount);
+	REGISTER_ACCESSOR_METHODS(uncorrected_error_count, modCADU_Rcv, UncorrectedErrorCount);
+	REGISTER_ACCESSOR_METHODS(errorless_unit_count, modCADU_Rcv, ErrorlessUnitCount);
+	REGISTER_ACCESSOR_METHODS(corrected_unit_count, modCADU_Rcv, CorrectedUnitCount);
+	REGISTER_ACCESSOR_METHODS(uncorrected_unit_count, modCADU_Rcv, UncorrectedUnitCount);
+}
+
+} // namespace nCADU_Rcv
@@ -63,6 +63,30 @@ modEncapPkt_Add::~modEncapPkt_Add() {
 	MOD_DEBUG("Running ~modEncapPkt_Add().");
 }
 
+/// @brief Join a header-only packet and its payload into a complete Encapsulation Packet.
+/// If the payload has enough reserved headroom the header is written there and the
+/// payload is not copied; otherwise the payload is appended to the header.
+/// @param header A packet built without data; released if no longer needed.
+/// @param data The payload, which the caller still owns.
+/// @return The complete packet.
+template <class PacketType>
+PacketType* attachPayload(PacketType* header, NetworkData* data) {
+	// Without a length field the packet is an idle one and carries no data.
+	if ( ! header->hasData() ) return header;
+
+	PacketType* pkt = header;
+
+	if ( data->prependInPlace(header->ptrUnit(), header->getUnitLength()) ) {
+		pkt = data->wrapOuterPDU<PacketType>();
+		ndSafeRelease(header);
+	}
+	else header->append(data);
+
+	if ( pkt->hasPacketLength() ) pkt->setPacketLength(pkt->getUnitLength());
+
+	return pkt;
+}
+
 int modEncapPkt_Add::svc() {
 	svcStart_();
 
@@ -106,18 +130,20 @@ int modEncapPkt_Add::svc() {
 					ipe = data->getIPE_Header_Val();
 				}
 
-				encap_pkt = new EncapsulationPacketWithIPE();
+				EncapsulationPacketWithIPE* header = new EncapsulationPacketWithIPE();
 
-				dynamic_cast<EncapsulationPacketWithIPE*>(encap_pkt)->build(
+				header->build(
 					protocol, // Protocol Identifier
 					getLengthOfLength(), // Length of Length
-					0, // Packet Length (0 causes build() to calculate)
-					data,
+					0, // Packet Length (set by attachPayload())
+					0, // Data is attached afterward
 					ipe,
 					getUserDefinedField(),
 					getProtocolIdExt(),
 					getCcsdsDefinedField()
 				);
+
+				encap_pkt = attachPayload(header, data);
 			}
 			else {
 				if ( data->getIPE_Header_Val() == -1 ) {
@@ -139,17 +165,19 @@ int modEncapPkt_Add::svc() {
 					};
 				}
 
-				encap_pkt = new EncapsulationPacketPreIPE();
+				EncapsulationPacketPreIPE* header = new EncapsulationPacketPreIPE();
 
-				dynamic_cast<EncapsulationPacketPreIPE*>(encap_pkt)->build(
+				header->build(
 					protocol, // Protocol Identifier
 					getLengthOfLength(), // Length of Length
-					0, // Packet Length (0 causes build() to calculate)
-					data,
+					0, // Packet Length (set by attachPayload())
+					0, // Data is attached afterward
 					getUserDefinedField(),
 					getProtocolIdExt(),
 					getCcsdsDefinedField()
 				);
+
+				encap_pkt = attachPayload(header, data);
 			}
 
 			dumpUnit(encap_pkt);
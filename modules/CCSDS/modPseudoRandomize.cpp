@@ -14,31 +14,16 @@
 
 #include "modPseudoRandomize.hpp"
 #include "NetworkData.hpp"
+#include "PseudoRandomSequence.hpp"
 
 namespace nPseudoRandomize {
 
-const int modPseudoRandomize::seqBufLen = 65536;
-
 modPseudoRandomize::modPseudoRandomize(const std::string& newName, const std::string& newChannelName,
     	 const CE_DLL* newDLLPtr):
-	BaseTrafficHandler(newName, newChannelName, newDLLPtr), _seqBuf(0) {
-
-	/// Generate the sequence.
-	_seqBuf = new uint8_t[seqBufLen];
-	ACE_OS::memset(_seqBuf, 0, seqBufLen);
-
-	uint8_t gen = 0xff;
-	int col = 0;
-	uint8_t curBit = 0;
+	BaseTrafficHandler(newName, newChannelName, newDLLPtr) {
 
-	for (int x = 0; x < seqBufLen * 8; x++) {
-		curBit = gen & 1;
-		_seqBuf[x/8] |= curBit << (7 - x%8);
-		curBit ^= ((gen & 8) >> 3) ^ ((gen & 32) >> 5) ^ ((gen & 128) >> 7);
-		++col;
-		if ( x > 0 && ! x % 255 ) { gen = 255; }
-		else { gen >>= 1; gen |= curBit << 7; }
-	}
+	MOD_DEBUG("Using %s XOR with the shared pseudo-random sequence.",
+		PseudoRandomSequence::usingAVX2()? "AVX2" : "64-bit");
 }
 
 
@@ -46,47 +31,24 @@ modPseudoRandomize::~modPseudoRandomize() {
 	MOD_DEBUG("Running ~modPseudoRandomize().");
 
 	stopTraffic();
-
-	if (_seqBuf != 0) delete[] _seqBuf;
 }
 
 int modPseudoRandomize::svc() {
-	svcStart_();
-
-	while ( continueService() ) {
-		std::pair<NetworkData*, int> queueTop = getData_();
-
-		if ( msg_queue()->deactivated() ) break;
-
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
-		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
-			continue;
-		}
-
-		NetworkData* data = queueTop.first;
+	return transformLoop_();
+}
 
-		MOD_DEBUG("Received a %d-octet data unit to randomize.", data->getUnitLength());
+NetworkData* modPseudoRandomize::transformUnit_(NetworkData* data) {
+	MOD_DEBUG("Received a %d-octet data unit to randomize.", data->getTotalUnitLength());
 
-		for ( size_t x = 0; x < data->getUnitLength(); ++x ) {
-			*data->ptrUnit(x) = *data->ptrUnit(x) ^ _seqBuf[x];
-		}
+	// The sequence runs on from one part to the next.
+	size_t seqOffset = 0;
 
-		if ( links_[PrimaryOutputLink] ) {
-			MOD_DEBUG("Sending %d octets via primary output link.", data->getUnitLength());
-			links_[PrimaryOutputLink]->send(data);
-		}
-		else {
-			MOD_NOTICE("No primary output target defined yet, dropping data.");
-			ndSafeRelease(data);
-		}
+	for ( NetworkData* part = data; part; part = part->getNextPart() ) {
+		if ( part->getUnitLength() > 0 ) PseudoRandomSequence::apply(part->ptrUnit(), part->getUnitLength(), seqOffset);
+		seqOffset += part->getUnitLength();
 	}
 
-	return svcEnd_();
-
+	return data;
 }
 
 }
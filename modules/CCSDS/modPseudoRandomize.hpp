@@ -24,12 +24,12 @@ namespace nPseudoRandomize {
 	@class modPseudoRandomize
 	@author Tad Kollar  
 	@brief XOR incoming units w/sequence in CCSDS TM Sync/Channel Coding Blue Book.
+
+	The sequence itself is shared by every instance; see PseudoRandomSequence.
 */
 //=============================================================================
 class modPseudoRandomize: public BaseTrafficHandler {
 public:
-	static const int seqBufLen;
-
 	/// Primary constructor.
 	/// @param newName An identifier for the module that's unique within the channel.
 	/// @param newChannelName An identifier for the containing channel.
@@ -43,6 +43,12 @@ public:
 	/// Read in a data unit, perform the XOR, then send it via the primary output.
 	int svc();
 
+	/// The XOR depends only on the unit itself.
+	bool supportsInline() const { return true; }
+
+	/// Each part of a chained unit is XORed where it is.
+	bool acceptsChainedUnits() const { return true; }
+
 	/// Return the MRU of the primary output if it exists.
 	/// Otherwise, return the local MRU setting, which is otherwise meaningless.
 	size_t getMRU() const {
@@ -57,13 +63,14 @@ public:
 		else return BaseTrafficHandler::getMTU();
 	}
 
+protected:
+	/// XOR the unit with the pseudo-random sequence in place.
+	NetworkData* transformUnit_(NetworkData* data);
+
 private:
 	/// Disable default constructor.
 	modPseudoRandomize();
 
-	/// The length of the buffer to generate the repeating bit sequence into.
-	uint8_t* _seqBuf;
-
 }; // class modPseudoRandomize
 
 } // namespace nPseudoRandomize
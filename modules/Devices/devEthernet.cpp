@@ -105,6 +105,7 @@ devEthernet::devEthernet(const std::string& newName /* = "" */,
 		setSnapLen(static_cast<int>(getMTU() + 30));
 		MOD_DEBUG("SnapLen set to %d.", getSnapLen());
 	}
+	else setSnapLen(getSnapLen()); // Register the configured length.
 
 	MOD_DEBUG("Connecting netlink socket.");
 	_netlinkSocket = Linux::nl_socket_alloc();
@@ -18,6 +18,7 @@
 #include "CE_Device.hpp"
 #include "CE_Macros.hpp"
 #include "EthernetFrame.hpp"
+#include "NetworkDataPool.hpp"
 #include "SettingsManager.hpp"
 #include "utils.hpp"
 
@@ -217,8 +218,11 @@ public:
 	/// Override CE_Device::getType to return "Ethernet".
 	std::string getType() const { return "Ethernet"; }
 
-	/// Write-only accessor to _snapLen.
-	void setSnapLen(const int newVal) { _snapLen = newVal; }
+	/// Write-only accessor to _snapLen. Also registers the length with the NetworkData buffer pool.
+	void setSnapLen(const int newVal) {
+		_snapLen = newVal;
+		if ( newVal > 0 ) NetworkDataPool::instance()->addSizeClass(newVal);
+	}
 
 	/// Read-only accessor to _snapLen.
 	int getSnapLen() const { return _snapLen; }
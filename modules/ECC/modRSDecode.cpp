@@ -14,21 +14,20 @@
 
 #include "modRSDecode.hpp"
 
-namespace nRSDecode {
-
-const int modRSDecode::primitivePoly = 0x187;
-
-const std::size_t modRSDecode::codeLength = 255;
-
-const std::size_t modRSDecode::bitsPerSymbol = 8;
+#include <ace/Guard_T.h>
+#include <ace/Thread_Manager.h>
 
-const Sym modRSDecode::primitiveRootIdx = 11;
-
-const bool modRSDecode::doBasisTransform = true;
+namespace nRSDecode {
 
 modRSDecode::modRSDecode(const std::string& newName, const std::string& newChannelName,
     	 const CE_DLL* newDLLPtr):
 	BaseTrafficHandler(newName, newChannelName, newDLLPtr),
+	_primitivePolySetting(CEcfg::instance()->getOrAddInt(cfgKey("primitivePoly"), 0x187)),
+	_codeLengthSetting(CEcfg::instance()->getOrAddInt(cfgKey("codeLength"), 255)),
+	_bitsPerSymbolSetting(CEcfg::instance()->getOrAddInt(cfgKey("bitsPerSymbol"), 8)),
+	_primitiveRootIdxSetting(CEcfg::instance()->getOrAddInt(cfgKey("primitiveRootIdx"), 11)),
+	_firstConsecutiveRootSetting(CEcfg::instance()->getOrAddInt(cfgKey("firstConsecutiveRoot"), -1)),
+	_dualBasisSetting(CEcfg::instance()->getOrAddBool(cfgKey("dualBasis"), true)),
 	_maxErrorsPerCodeword(16),
 	_maxErrorsPerCodewordSetting(CEcfg::instance()->getOrAddInt(cfgKey("maxErrorsPerCodeword"), _maxErrorsPerCodeword)),
 	_interleavingDepth(1),
@@ -39,10 +38,28 @@ modRSDecode::modRSDecode(const std::string& newName, const std::string& newChann
 	_errorlessUnitCount(0),
 	_correctedUnitCount(0),
 	_uncorrectedUnitCount(0),
-	_rsDecoder(0) {
+	_decodedCodewordCount(0),
+	_decodeNsec(0),
+	_rsDecoder(0),
+	_decodeWorkers(1),
+	_decodeWorkersSetting(CEcfg::instance()->getOrAddInt(cfgKey("decodeWorkers"), _decodeWorkers)),
+	_decoderGeneration(0),
+	_jobReady(_parallelLock),
+	_slotFree(_parallelLock),
+	_nextArrivalSeq(0),
+	_nextSendSeq(0),
+	_maxReorderDepth(0),
+	_stopWorkers(false),
+	_flushing(false) {
 
+	setPrimitivePoly(_primitivePolySetting);
+	setCodeLength(_codeLengthSetting);
+	setBitsPerSymbol(_bitsPerSymbolSetting);
+	setPrimitiveRootIdx(_primitiveRootIdxSetting);
+	setFirstConsecutiveRoot(_firstConsecutiveRootSetting);
 	setMaxErrorsPerCodeword(_maxErrorsPerCodewordSetting);
 	setInterleavingDepth(_interleavingDepthSetting);
+	setDecodeWorkers(_decodeWorkersSetting);
 
 	rebuildDecoder();
 }
@@ -56,9 +73,9 @@ modRSDecode::~modRSDecode() {
 
 int modRSDecode::svc() {
 	svcStart_();
-	NetworkData *correctedData;
-	std::size_t dataLen, errs;
-	SymVec corrected;
+
+	const bool parallel = ( _decodeWorkers > 1 );
+	if ( parallel ) _startWorkers();
 
 	while ( continueService() ) {
 		std::pair<NetworkData*, int> queueTop = getData_();
@@ -75,70 +92,330 @@ int modRSDecode::svc() {
 		}
 
 		NetworkData* data = queueTop.first;
-		dataLen = data->getUnitLength();
 
-		MOD_DEBUG("Received %d octets to decode", dataLen);
+		MOD_DEBUG("Received %d octets to decode", data->getUnitLength());
+
+		if ( ! links_[PrimaryOutputLink] ) {
+			MOD_NOTICE("No output target defined yet, dropping data.");
+			ndSafeRelease(data);
+		}
+		else if ( parallel ) {
+			_queueJob(data);
+		}
+		else if ( (data = _decodeUnit(data, _rsDecoder)) ) {
+			MOD_DEBUG("Now sending %d octets.", data->getUnitLength());
+			links_[PrimaryOutputLink]->send(data);
+		}
+	}
+
+	if ( parallel ) _stopAllWorkers();
+
+	return svcEnd_();
+}
+
+NetworkData* modRSDecode::_decodeUnit(NetworkData* data, RSDecoder* decoder) {
+	const std::size_t dataLen = data->getUnitLength();
+
+	if ( dataLen > decoder->getCodeLength() * decoder->getInterleaveDepth() ) {
+		MOD_WARNING("Encoded unit length %d is greater than maximum interleaved codeword length %d, dropping.",
+			dataLen, decoder->getCodeLength() * decoder->getInterleaveDepth());
+		ndSafeRelease(data);
+		return 0;
+	}
+
+	if ( dataLen <= decoder->getTotalParityLength() ) {
+		MOD_WARNING("Encoded unit length %d is too short to hold %d parity symbols, dropping.",
+			dataLen, decoder->getTotalParityLength());
+		ndSafeRelease(data);
+		return 0;
+	}
+
+	const ACE_INT64 decodeStart = ClockService::instance()->preciseNowNsec();
 
-		if ( links_[PrimaryOutputLink] ) {
-			if ( dataLen > codeLength * _interleavingDepth ) {
-				MOD_WARNING("Encoded unit length %d is greater than maximum interleaved codeword length %d, dropping.",
-					dataLen, codeLength * _interleavingDepth);
+	try {
+		std::size_t errs = 0;
+
+		if ( ! decoder->syndromesClear(data->ptrUnit(), dataLen) ) {
+			// Corrections are written into the buffer, which must not be shared.
+			if ( data->reference_count() > 1 ) {
+				NetworkData* copy = new NetworkData(data, true, data->ptrUnit() - data->ptrBuffer(), dataLen);
 				ndSafeRelease(data);
+				data = copy;
 			}
-			else {
-				try {
-					corrected = _rsDecoder->decode(data);
-					correctedData = new NetworkData(corrected.size(), &corrected[0]);
-
-					errs = _rsDecoder->getLastCorrectedErrors();
-					if ( errs == 0 ) ++_errorlessUnitCount;
-					else ++_correctedUnitCount;
-
-					_correctedErrorCount += errs;
-					MOD_DEBUG("Corrected %d errors. Now sending %d octets.", errs, correctedData->getUnitLength());
-					links_[PrimaryOutputLink]->send(correctedData);
-				}
-				catch (RSDecoder::TooManyErrors& tme) {
-					++_uncorrectedUnitCount;
-					_uncorrectedErrorCount += tme.errors;
-					MOD_NOTICE("Failed to decode: %s. Dropping data.", tme.what());
-				}
-				catch (std::logic_error& e) {
-					MOD_WARNING("Failed to decode: %s. Dropping data.\nMax errors/codeword: %d\nInterleaving depth: %d\nMessage length: %d",
-						e.what(), _maxErrorsPerCodeword, _interleavingDepth, data->getUnitLength());
-				}
 
-				ndSafeRelease(data);
+			errs = decoder->correctInPlace(data->ptrUnit(), dataLen);
+		}
+
+		_countDecodeTime(decodeStart);
+
+		if ( errs == 0 ) __sync_fetch_and_add(&_errorlessUnitCount, 1);
+		else __sync_fetch_and_add(&_correctedUnitCount, 1);
+
+		__sync_fetch_and_add(&_correctedErrorCount, errs);
+
+		// Drop the parity; the message itself stays where it is.
+		data->setUnitLength(dataLen - decoder->getTotalParityLength(), true);
+
+		MOD_DEBUG("Corrected %d errors.", errs);
+		return data;
+	}
+	catch (RSDecoder::TooManyErrors& tme) {
+		_countDecodeTime(decodeStart);
+		__sync_fetch_and_add(&_uncorrectedUnitCount, 1);
+		__sync_fetch_and_add(&_uncorrectedErrorCount, tme.errors);
+		MOD_NOTICE("Failed to decode: %s. Dropping data.", tme.what());
+	}
+	catch (std::logic_error& e) {
+		MOD_WARNING("Failed to decode: %s. Dropping data.\nMax errors/codeword: %d\nInterleaving depth: %d\nMessage length: %d",
+			e.what(), decoder->getParityLength() / 2, decoder->getInterleaveDepth(), dataLen);
+	}
+
+	ndSafeRelease(data);
+	return 0;
+}
+
+void modRSDecode::_startWorkers() {
+	ACE_Guard<ACE_Thread_Mutex> guard(_parallelLock);
+
+	_stopWorkers = false;
+	_flushing = false;
+	_nextArrivalSeq = _nextSendSeq = 0;
+
+	for ( int idx = 0; idx < _decodeWorkers; ++idx ) {
+		DecodeWorker* worker = new DecodeWorker;
+		worker->owner = this;
+		worker->decoderGeneration = _decoderGeneration;
+
+		try { worker->decoder = _newDecoder(); }
+		catch (const nd_error& e) {
+			MOD_ERROR("Cannot construct a decoder for thread %d, it will drop data until the settings change: %s", idx, e.what());
+			worker->decoder = 0;
+		}
+		worker->startNsec = ClockService::instance()->preciseNowNsec();
+		worker->busyNsec = 0;
+
+		if ( ACE_Thread_Manager::instance()->spawn(_decodeWorkerLoop, worker, THR_JOINABLE | THR_SCOPE_SYSTEM,
+			&worker->threadID) == -1 ) {
+			MOD_ERROR("Unable to spawn decoding thread %d.", idx);
+			delete worker->decoder;
+			delete worker;
+			continue;
+		}
+
+		_workers.push_back(worker);
+	}
+
+	MOD_INFO("Decoding with %d threads.", _workers.size());
+}
+
+void modRSDecode::_stopAllWorkers() {
+	std::vector<DecodeWorker*> workers;
+
+	{
+		ACE_Guard<ACE_Thread_Mutex> guard(_parallelLock);
+		_stopWorkers = true;
+		_jobReady.broadcast();
+		workers = _workers;
+	}
+
+	for ( std::size_t idx = 0; idx < workers.size(); ++idx )
+		ACE_Thread_Manager::instance()->join(workers[idx]->threadID);
+
+	ACE_Guard<ACE_Thread_Mutex> guard(_parallelLock);
+
+	for ( std::size_t idx = 0; idx < _workers.size(); ++idx ) {
+		delete _workers[idx]->decoder;
+		delete _workers[idx];
+	}
+
+	_workers.clear();
+
+	// Every queued unit was decoded and flushed before the workers exited.
+	_reorder.clear();
+}
+
+void modRSDecode::_queueJob(NetworkData* data) {
+	ACE_Guard<ACE_Thread_Mutex> guard(_parallelLock);
 
+	if ( _workers.empty() ) {
+		MOD_ERROR("No decoding threads are running, dropping data.");
+		ndSafeRelease(data);
+		return;
+	}
+
+	// Bound the reorder buffer; a slow unit holds up everything behind it.
+	const uint64_t maxInFlight = 4 * _workers.size();
+	const ACE_Time_Value recheck(0, 100000);
+
+	while ( _nextArrivalSeq - _nextSendSeq >= maxInFlight && continueService() ) {
+		ACE_Time_Value deadline(ClockService::instance()->preciseNow() + recheck);
+		_slotFree.wait(&deadline);
+	}
+
+	_jobs.push_back(std::make_pair(_nextArrivalSeq++, data));
+	_jobReady.signal();
+}
+
+void modRSDecode::_flushReorder(ACE_Guard<ACE_Thread_Mutex>& guard) {
+	// One thread sends at a time so units leave in order; the others only add to _reorder.
+	if ( _flushing ) return;
+	_flushing = true;
+
+	std::vector<NetworkData*> ready;
+	std::map<uint64_t, NetworkData*>::iterator pos;
+
+	while ( ! _reorder.empty() && (pos = _reorder.begin())->first == _nextSendSeq ) {
+		while ( ! _reorder.empty() && (pos = _reorder.begin())->first == _nextSendSeq ) {
+			if ( pos->second ) ready.push_back(pos->second);
+			_reorder.erase(pos);
+			++_nextSendSeq;
+		}
+
+		_slotFree.broadcast();
+
+		// Send without holding up the decoding threads and svc().
+		guard.release();
+		_sendDecoded(ready);
+		guard.acquire();
+	}
+
+	_flushing = false;
+}
+
+void modRSDecode::_sendDecoded(std::vector<NetworkData*>& ready) {
+	for ( std::size_t idx = 0; idx < ready.size(); ++idx ) {
+		NetworkData* data = ready[idx];
+
+		if ( ! links_[PrimaryOutputLink] ) {
+			MOD_NOTICE("No output target defined anymore, dropping data.");
+			ndSafeRelease(data);
+			continue;
+		}
+
+		try {
+			MOD_DEBUG("Now sending %d octets.", data->getUnitLength());
+			links_[PrimaryOutputLink]->send(data);
+		}
+		catch (const HandlerLink::DisconnectedLink& e) {
+			MOD_NOTICE("Output disconnected, dropping data: %s", e.what());
+			ndSafeRelease(data);
+		}
+		catch (const std::exception& e) {
+			// An inline target may already have released the unit.
+			MOD_ERROR("Failed to send decoded data: %s", e.what());
+		}
+	}
+
+	ready.clear();
+}
+
+ACE_THR_FUNC_RETURN modRSDecode::_decodeWorkerLoop(void* arg) {
+	DecodeWorker* worker = static_cast<DecodeWorker*>(arg);
+	modRSDecode* self = worker->owner;
+
+	// Decoding threads run where the segment's own thread was asked to.
+	std::string problems;
+	if ( ! self->getPlacement().isDefault() ) self->getPlacement().applyToSelf(problems);
+
+	while ( true ) {
+		std::pair<uint64_t, NetworkData*> job;
+		RSDecoder* rebuilt = 0;
+		bool rebuild = false;
+
+		{
+			ACE_Guard<ACE_Thread_Mutex> guard(self->_parallelLock);
+			while ( self->_jobs.empty() && ! self->_stopWorkers ) self->_jobReady.wait();
+			if ( self->_jobs.empty() ) break;
+
+			job = self->_jobs.front();
+			self->_jobs.pop_front();
+
+			// rebuildDecoder() changes the generation under this lock, after the settings.
+			if ( worker->decoderGeneration != self->_decoderGeneration ) {
+				worker->decoderGeneration = self->_decoderGeneration;
+				rebuild = true;
+
+				try { rebuilt = self->_newDecoder(); }
+				catch (const nd_error& e) {
+					ND_ERROR("[%s] Cannot rebuild a decoding thread's decoder, dropping data until the settings change: %s\n",
+						self->getName().c_str(), e.what());
+				}
 			}
 		}
+
+		const ACE_INT64 start = ClockService::instance()->preciseNowNsec();
+
+		// Left null if the new settings don't make a valid code.
+		if ( rebuild ) {
+			delete worker->decoder;
+			worker->decoder = rebuilt;
+		}
+
+		// Every job gets a _reorder entry, even a dropped one, so the units behind it aren't held up.
+		NetworkData* decoded = 0;
+
+		if ( ! worker->decoder ) {
+			ndSafeRelease(job.second);
+		}
 		else {
-			MOD_NOTICE("No output target defined yet, dropping data.");
-			ndSafeRelease(data);
+			try { decoded = self->_decodeUnit(job.second, worker->decoder); }
+			catch (const std::exception& e) {
+				// The unit may already have been released.
+				ND_ERROR("[%s] Failed to decode, dropping data: %s\n", self->getName().c_str(), e.what());
+			}
 		}
 
+		worker->busyNsec += ClockService::instance()->preciseNowNsec() - start;
+
+		ACE_Guard<ACE_Thread_Mutex> guard(self->_parallelLock);
+
+		self->_reorder[job.first] = decoded;
+		if ( self->_reorder.size() > self->_maxReorderDepth ) self->_maxReorderDepth = self->_reorder.size();
+
+		self->_flushReorder(guard);
 	}
 
-	return svcEnd_();
+	return 0;
+}
+
+std::size_t modRSDecode::getReorderDepth() {
+	ACE_Guard<ACE_Thread_Mutex> guard(_parallelLock);
+	return _reorder.size();
+}
+
+void modRSDecode::getWorkerUtilization(std::vector<double>& utilization) {
+	ACE_Guard<ACE_Thread_Mutex> guard(_parallelLock);
+	const ACE_INT64 now = ClockService::instance()->preciseNowNsec();
+
+	utilization.clear();
+
+	for ( std::size_t idx = 0; idx < _workers.size(); ++idx ) {
+		const ACE_INT64 elapsed = now - _workers[idx]->startNsec;
+		utilization.push_back(( elapsed > 0 )? 100.0 * _workers[idx]->busyNsec / elapsed : 0.0);
+	}
+}
+
+RSDecoder* modRSDecode::_newDecoder() const {
+	return new RSDecoder(getPrimitivePoly(),
+		_maxErrorsPerCodeword * 2,
+		getCodeLength(),
+		getBitsPerSymbol(),
+		getPrimitiveRootIdx(),
+		getFirstConsecutiveRoot(),
+		_interleavingDepth,
+		getDualBasis());
 }
 
 void modRSDecode::rebuildDecoder() {
 	_resetLengths();
 
 	MOD_DEBUG("Constructing a RS(%d,%d) code with an interleaving depth of %d.",
-		codeLength, _dataLength, _interleavingDepth);
+		getCodeLength(), _dataLength, _interleavingDepth);
 
-	if ( _maxErrorsPerCodeword != 8 && _maxErrorsPerCodeword != 16)
-		throw BadValue(BadValue::msg("Max errors per codeword", _maxErrorsPerCodeword));
+	_rsDecoder = _newDecoder();
 
-	_rsDecoder = new RSDecoder(primitivePoly,
-		_maxErrorsPerCodeword * 2,
-		codeLength,
-		bitsPerSymbol,
-		primitiveRootIdx,
-		(_maxErrorsPerCodeword == 8)? 120 : 112 ,
-		_interleavingDepth,
-		doBasisTransform);
+	ACE_Guard<ACE_Thread_Mutex> guard(_parallelLock);
+	++_decoderGeneration;
 }
 
 }
@@ -19,12 +19,24 @@
 #include "RSDecoder.hpp"
 #include "nd_error.hpp"
 
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Guard_T.h>
+#include <ace/Thread_Mutex.h>
+#include <deque>
+#include <map>
+#include <vector>
+
 namespace nRSDecode {
 
 //=============================================================================
 /**
  * @class modRSDecode
  * @brief Extract messages from Reed-Solomon codewords for incoming data blocks.
+ *
+ * With decodeWorkers above 1, the svc() thread only numbers the incoming
+ * units and queues them for a private set of decoding threads, each with its
+ * own RSDecoder. Decoded units wait in a reorder buffer until every unit that
+ * arrived before them has been sent or dropped, so output order is unchanged.
  */
 //=============================================================================
 class modRSDecode : public BaseTrafficHandler {
@@ -42,10 +54,11 @@ public:
 	/// Reads in data, extracts a portion, and sends it to the output handler.
 	int svc();
 
-	/// Write-only accessor to _maxErrorsPerCodeword/_maxErrorsPerCodewordSetting.
-	/// @throw BadValue If newVal is other than 8 or 16.
+	/// @brief Write-only accessor to _maxErrorsPerCodeword/_maxErrorsPerCodewordSetting.
+	/// CCSDS uses 8 or 16; whether it fits the code length is checked when the decoder is rebuilt.
+	/// @throw ValueOutOfRange If newVal is not between 1 and 127.
 	void setMaxErrorsPerCodeword(const int& newVal) {
-		if ( newVal != 8 && newVal != 16 ) throw BadValue(BadValue::msg("Max errors per codeword", newVal));
+		if ( newVal < 1 || newVal > 127 ) throw ValueOutOfRange(ValueOutOfRange::msg("Max errors per codeword", newVal, 1, 127));
 		_maxErrorsPerCodewordSetting = static_cast<int>(newVal);
 		_maxErrorsPerCodeword = newVal;
 	}
@@ -62,10 +75,37 @@ public:
 	/// Read-only accessor to _interleavingDepth/_interleavingDepthSetting.
 	int getInterleavingDepth() const { return _interleavingDepth; }
 
-	/// If interleave depth or max errors have changed, this must be called for the
-	/// changes to take effect.
+	/// If interleave depth, max errors, or any code parameter has changed, this must be
+	/// called for the changes to take effect.
+	/// @throw nd_error If the parameters do not describe a valid code; see RSBase::RSBase().
 	void rebuildDecoder();
 
+	/// @brief Write-only accessor to _decodeWorkers/_decodeWorkersSetting.
+	/// Takes effect the next time the segment starts.
+	/// @throw ValueOutOfRange If newVal is not between 1 and maxDecodeWorkers.
+	void setDecodeWorkers(const int newVal) {
+		if ( newVal < 1 || newVal > maxDecodeWorkers )
+			throw ValueOutOfRange(ValueOutOfRange::msg("Decode workers", newVal, 1, maxDecodeWorkers));
+		_decodeWorkersSetting = newVal;
+		_decodeWorkers = newVal;
+	}
+
+	/// Read-only accessor to _decodeWorkers.
+	int getDecodeWorkers() const { return _decodeWorkers; }
+
+	/// The number of decoded units currently held back waiting for earlier ones.
+	std::size_t getReorderDepth();
+
+	/// Read-only accessor to _maxReorderDepth.
+	uint64_t getMaxReorderDepth() const { return _maxReorderDepth; }
+
+	/// @brief Report how busy each decoding thread has been since it started.
+	/// @param utilization Receives one percentage per thread; empty if not running in parallel.
+	void getWorkerUtilization(std::vector<double>& utilization);
+
+	/// The most decoding threads a segment may have.
+	static const int maxDecodeWorkers = 64;
+
 	/// Write-only accessor to _correctedErrorCount.
 	void setCorrectedErrorCount(const uint64_t& newVal) {
 		_correctedErrorCount = newVal;
@@ -116,24 +156,118 @@ public:
 		return _uncorrectedUnitCount;
 	}
 
-	/// Encoder attribute that will not change.
-	static const int primitivePoly;
+	/// Write-only accessor to _decodedCodewordCount.
+	void setDecodedCodewordCount(const uint64_t& newVal) {
+		_decodedCodewordCount = newVal;
+	}
+
+	/// Read-only accessor to _decodedCodewordCount.
+	uint64_t getDecodedCodewordCount() const {
+		return _decodedCodewordCount;
+	}
+
+	/// Write-only accessor to _decodeNsec.
+	void setDecodeNsec(const uint64_t& newVal) {
+		_decodeNsec = newVal;
+	}
 
-	/// Encoder attribute that will not change.
-	static const std::size_t codeLength;
+	/// Read-only accessor to _decodeNsec.
+	uint64_t getDecodeNsec() const {
+		return _decodeNsec;
+	}
 
-	/// Encoder attribute that will not change.
-	static const std::size_t bitsPerSymbol;
+	/// The mean time spent checking and correcting each codeword, in nanoseconds.
+	uint64_t getDecodeNsecPerCodeword() const {
+		return ( _decodedCodewordCount )? _decodeNsec / _decodedCodewordCount : 0;
+	}
 
-	/// Encoder attribute that will not change.
-	static const Sym primitiveRootIdx;
+	/// @brief Write-only accessor to _primitivePolySetting.
+	/// Whether it is actually primitive is checked when the decoder is rebuilt.
+	/// @throw ValueOutOfRange If newVal is not a polynomial of degree 2 through 8.
+	void setPrimitivePoly(const int newVal) {
+		if ( newVal < 0x4 || newVal > 0x1ff )
+			throw ValueOutOfRange(ValueOutOfRange::msg("Primitive polynomial", newVal, 0x4, 0x1ff));
+		_primitivePolySetting = newVal;
+	}
 
-	/// Encoder attribute that will not change.
-	static const bool doBasisTransform;
+	/// Read-only accessor to _primitivePolySetting.
+	int getPrimitivePoly() const { return _primitivePolySetting; }
+
+	/// @brief Write-only accessor to _codeLengthSetting. Values below 2^bitsPerSymbol - 1
+	/// select a shortened code.
+	/// @throw ValueOutOfRange If newVal is not between 3 and 255.
+	void setCodeLength(const int newVal) {
+		if ( newVal < 3 || newVal > 255 ) throw ValueOutOfRange(ValueOutOfRange::msg("Code length", newVal, 3, 255));
+		_codeLengthSetting = newVal;
+	}
+
+	/// Read-only accessor to _codeLengthSetting.
+	int getCodeLength() const { return _codeLengthSetting; }
+
+	/// Write-only accessor to _bitsPerSymbolSetting.
+	/// @throw ValueOutOfRange If newVal is not between 2 and 8.
+	void setBitsPerSymbol(const int newVal) {
+		if ( newVal < 2 || newVal > 8 ) throw ValueOutOfRange(ValueOutOfRange::msg("Bits per symbol", newVal, 2, 8));
+		_bitsPerSymbolSetting = newVal;
+	}
+
+	/// Read-only accessor to _bitsPerSymbolSetting.
+	int getBitsPerSymbol() const { return _bitsPerSymbolSetting; }
+
+	/// Write-only accessor to _primitiveRootIdxSetting.
+	/// @throw ValueOutOfRange If newVal is not between 1 and 254.
+	void setPrimitiveRootIdx(const int newVal) {
+		if ( newVal < 1 || newVal > 254 ) throw ValueOutOfRange(ValueOutOfRange::msg("Primitive root index", newVal, 1, 254));
+		_primitiveRootIdxSetting = newVal;
+	}
+
+	/// Read-only accessor to _primitiveRootIdxSetting.
+	int getPrimitiveRootIdx() const { return _primitiveRootIdxSetting; }
+
+	/// @brief Write-only accessor to _firstConsecutiveRootSetting.
+	/// @param newVal The power of the primitive root that is the generator's first root,
+	/// or -1 to choose it as CCSDS does.
+	/// @throw ValueTooLarge If newVal is over 254.
+	void setFirstConsecutiveRoot(const int newVal) {
+		if ( newVal > 254 ) throw ValueTooLarge(ValueTooLarge::msg("First consecutive root", newVal, 254));
+		_firstConsecutiveRootSetting = ( newVal < 0 )? -1 : newVal;
+	}
+
+	/// @brief The first consecutive root in use. If none was set, it is the one that
+	/// makes the generator symmetric, 2^(bitsPerSymbol - 1) - E, giving the CCSDS
+	/// values of 120 for E=8 and 112 for E=16.
+	int getFirstConsecutiveRoot() const {
+		const int fcr = _firstConsecutiveRootSetting;
+		return ( fcr >= 0 )? fcr : ( 1 << (getBitsPerSymbol() - 1) ) - _maxErrorsPerCodeword;
+	}
+
+	/// Write-only accessor to _dualBasisSetting.
+	void setDualBasis(const bool newVal) { _dualBasisSetting = newVal; }
+
+	/// Read-only accessor to _dualBasisSetting.
+	bool getDualBasis() const { return _dualBasisSetting; }
 
 private:
+	/// The field polynomial; 0x187 for CCSDS.
+	Setting& _primitivePolySetting;
+
+	/// Symbols per codeword, data plus parity; 255 for CCSDS.
+	Setting& _codeLengthSetting;
+
+	/// The size of each symbol; 8 for CCSDS.
+	Setting& _bitsPerSymbolSetting;
+
+	/// The power of alpha used as the code's primitive root; 11 for CCSDS.
+	Setting& _primitiveRootIdxSetting;
+
+	/// The first root of the generator as a power of the primitive root, or -1 for automatic.
+	Setting& _firstConsecutiveRootSetting;
+
+	/// Whether symbols are sent in Berlekamp's dual basis, as CCSDS does.
+	Setting& _dualBasisSetting;
+
 	/// Reed-Solomon error correction capability, in symbols, within an R-S codeword.
-	/// May be selected to be 16 or 8 R-S symbols.
+	/// CCSDS selects 16 or 8 R-S symbols.
 	int _maxErrorsPerCodeword;
 
 	/// The config file setting for _maxErrorsPerCodeword.
@@ -149,9 +283,9 @@ private:
 	/// The size of the data area in the codeword.
 	int _dataLength;
 
-	/// Recompute _fecLength and _dataLength based on _maxErrorsPerCodeword and codeLength.
+	/// Recompute _dataLength based on _maxErrorsPerCodeword and the code length.
 	void _resetLengths() {
-		_dataLength = codeLength - (_maxErrorsPerCodeword * 2 * _interleavingDepth);
+		_dataLength = getCodeLength() - (_maxErrorsPerCodeword * 2);
 	}
 
 	/// The total number of errors fixed by the module.
@@ -169,9 +303,104 @@ private:
 	/// The total number of received units that were unrepaired.
 	uint64_t _uncorrectedUnitCount;
 
+	/// The total number of codewords checked, with or without errors.
+	uint64_t _decodedCodewordCount;
+
+	/// The total time spent checking and correcting those codewords.
+	uint64_t _decodeNsec;
+
+	/// Add the time since start to _decodeNsec and count one unit's codewords.
+	void _countDecodeTime(const ACE_INT64 start) {
+		__sync_fetch_and_add(&_decodeNsec, ClockService::instance()->preciseNowNsec() - start);
+		__sync_fetch_and_add(&_decodedCodewordCount, _interleavingDepth);
+	}
+
 	/// Pointer to the object that will actually handle the decoding.
 	RSDecoder* _rsDecoder;
 
+	/// Construct a decoder with the current settings.
+	RSDecoder* _newDecoder() const;
+
+	/// @brief Check a unit's length, then correct it and strip the parity.
+	/// Updates the counters, and may be called from several threads at once.
+	/// @param data The received unit, which is consumed.
+	/// @param decoder The decoder belonging to the calling thread.
+	/// @return The decoded unit, or null if it was dropped.
+	NetworkData* _decodeUnit(NetworkData* data, RSDecoder* decoder);
+
+	/// The number of threads decoding units; 1 means svc() does it all.
+	int _decodeWorkers;
+
+	/// The config file setting for _decodeWorkers.
+	Setting& _decodeWorkersSetting;
+
+	/// Incremented by rebuildDecoder() so decoding threads know to rebuild theirs.
+	volatile int _decoderGeneration;
+
+	/// State for one decoding thread.
+	struct DecodeWorker {
+		modRSDecode* owner;
+		ACE_thread_t threadID;
+		RSDecoder* decoder;
+		int decoderGeneration;
+		ACE_INT64 startNsec;
+		volatile ACE_INT64 busyNsec;
+	};
+
+	/// The decoding threads, present only while svc() runs them.
+	std::vector<DecodeWorker*> _workers;
+
+	/// Guards _jobs, _reorder, the sequence numbers, _flushing, _workers, and changes to _decoderGeneration.
+	ACE_Thread_Mutex _parallelLock;
+
+	/// Signaled when a unit is queued in _jobs or the workers should stop.
+	ACE_Condition_Thread_Mutex _jobReady;
+
+	/// Signaled when a unit leaves the reorder buffer.
+	ACE_Condition_Thread_Mutex _slotFree;
+
+	/// Units waiting for a decoding thread, with their arrival sequence numbers.
+	std::deque<std::pair<uint64_t, NetworkData*> > _jobs;
+
+	/// Decoded units (null if dropped) that arrived after one still being decoded.
+	std::map<uint64_t, NetworkData*> _reorder;
+
+	/// The sequence number for the next arriving unit.
+	uint64_t _nextArrivalSeq;
+
+	/// The sequence number of the next unit to send.
+	uint64_t _nextSendSeq;
+
+	/// The largest reorder buffer seen.
+	uint64_t _maxReorderDepth;
+
+	/// Tells the decoding threads to exit once _jobs is empty.
+	bool _stopWorkers;
+
+	/// True while a decoding thread is sending units from the reorder buffer.
+	bool _flushing;
+
+	/// Spawn the decoding threads.
+	void _startWorkers();
+
+	/// Let the decoding threads finish the queued units, then join them.
+	void _stopAllWorkers();
+
+	/// Queue a unit for the decoding threads, waiting while too many are in flight.
+	void _queueJob(NetworkData* data);
+
+	/// @brief Send every unit at the front of the reorder buffer that is next in sequence.
+	/// Does nothing if another thread is already sending, since it will pick them up.
+	/// @param guard The caller's hold on _parallelLock, which is let go while sending.
+	void _flushReorder(ACE_Guard<ACE_Thread_Mutex>& guard);
+
+	/// Send units taken from the reorder buffer, dropping them if the output is gone.
+	/// @param ready The units to send, in order; emptied on return.
+	void _sendDecoded(std::vector<NetworkData*>& ready);
+
+	/// The main loop of each decoding thread.
+	static ACE_THR_FUNC_RETURN _decodeWorkerLoop(void* arg);
+
 }; // class modRSDecode
 
 } // namespace nRSDecode
@@ -36,11 +36,20 @@ public:
 
 	GENERATE_INT_ACCESSORS(maxErrorsPerCodeWord, setMaxErrorsPerCodeword, getMaxErrorsPerCodeword);
 	GENERATE_INT_ACCESSORS(interleavingDepth, setInterleavingDepth, getInterleavingDepth);
+	GENERATE_INT_ACCESSORS(primitivePoly, setPrimitivePoly, getPrimitivePoly);
+	GENERATE_INT_ACCESSORS(codeLength, setCodeLength, getCodeLength);
+	GENERATE_INT_ACCESSORS(bitsPerSymbol, setBitsPerSymbol, getBitsPerSymbol);
+	GENERATE_INT_ACCESSORS(primitiveRootIdx, setPrimitiveRootIdx, getPrimitiveRootIdx);
+	GENERATE_INT_ACCESSORS(firstConsecutiveRoot, setFirstConsecutiveRoot, getFirstConsecutiveRoot);
+	GENERATE_BOOL_ACCESSORS(dualBasis, setDualBasis, getDualBasis);
 	GENERATE_I8_ACCESSORS(correctedErrorCount, setCorrectedErrorCount, getCorrectedErrorCount);
 	GENERATE_I8_ACCESSORS(uncorrected_error_count, setUncorrectedErrorCount, getUncorrectedErrorCount);
 	GENERATE_I8_ACCESSORS(errorless_unit_count, setErrorlessUnitCount, getErrorlessUnitCount);
 	GENERATE_I8_ACCESSORS(corrected_unit_count, setCorrectedUnitCount, getCorrectedUnitCount);
 	GENERATE_I8_ACCESSORS(set_uncorrected_unit_count, setUncorrectedUnitCount, getUncorrectedUnitCount);
+	GENERATE_I8_ACCESSORS(decoded_codeword_count, setDecodedCodewordCount, getDecodedCodewordCount);
+	GENERATE_I8_ACCESSORS(decode_nsec, setDecodeNsec, getDecodeNsec);
+	GENERATE_INT_ACCESSORS(decode_workers, setDecodeWorkers, getDecodeWorkers);
 
 	void rebuild_decoder(xmlrpc_c::paramList const& paramList, xmlrpc_c::value* retvalP) {
 		ACE_TRACE("modRSDecode_Interface::rebuild_decoder");
@@ -65,6 +74,19 @@ protected:
 		counters["errorlessUnits"] = xmlrpc_c::value_i8(handler->getErrorlessUnitCount());
 		counters["correctedUnits"] = xmlrpc_c::value_i8(handler->getCorrectedUnitCount());
 		counters["uncorrectedUnits"] = xmlrpc_c::value_i8(handler->getUncorrectedUnitCount());
+		counters["decodedCodewords"] = xmlrpc_c::value_i8(handler->getDecodedCodewordCount());
+		counters["decodeNsecPerCodeword"] = xmlrpc_c::value_i8(handler->getDecodeNsecPerCodeword());
+		counters["reorderDepth"] = xmlrpc_c::value_i8(handler->getReorderDepth());
+		counters["maxReorderDepth"] = xmlrpc_c::value_i8(handler->getMaxReorderDepth());
+
+		std::vector<double> utilization;
+		handler->getWorkerUtilization(utilization);
+
+		std::vector<xmlrpc_c::value> xmlUtilization;
+		for ( std::size_t idx = 0; idx < utilization.size(); ++idx )
+			xmlUtilization.push_back(xmlrpc_c::value_double(utilization[idx]));
+
+		counters["workerUtilization"] = xmlrpc_c::value_array(xmlUtilization);
 	}
 
 	void get_settings_(xmlrpc_c::paramList const& paramList, modRSDecode* handler,
@@ -76,6 +98,13 @@ protected:
 		// Build a map of associated settings
 		settings["maxErrorsPerCodeWord"] = xmlrpc_c::value_int(handler->getMaxErrorsPerCodeword());
 		settings["interleavingDepth"] = xmlrpc_c::value_int(handler->getInterleavingDepth());
+		settings["primitivePoly"] = xmlrpc_c::value_int(handler->getPrimitivePoly());
+		settings["codeLength"] = xmlrpc_c::value_int(handler->getCodeLength());
+		settings["bitsPerSymbol"] = xmlrpc_c::value_int(handler->getBitsPerSymbol());
+		settings["primitiveRootIdx"] = xmlrpc_c::value_int(handler->getPrimitiveRootIdx());
+		settings["firstConsecutiveRoot"] = xmlrpc_c::value_int(handler->getFirstConsecutiveRoot());
+		settings["dualBasis"] = xmlrpc_c::value_boolean(handler->getDualBasis());
+		settings["decodeWorkers"] = xmlrpc_c::value_int(handler->getDecodeWorkers());
 	}
 };
 
@@ -86,12 +115,24 @@ GENERATE_ACCESSOR_METHODS(maxErrorsPerCodeWord, i, "the Reed-Solomon error corre
 	modRSDecode_InterfaceP);
 GENERATE_ACCESSOR_METHODS(interleavingDepth, i, "the number of codewords to expect for decoding.",
 	modRSDecode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(primitivePoly, i, "the field polynomial, such as 0x187 for CCSDS.", modRSDecode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(codeLength, i, "the number of symbols per codeword; less than 2^bitsPerSymbol - 1 for a shortened code.",
+	modRSDecode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(bitsPerSymbol, i, "the size of each symbol, from 2 to 8 bits.", modRSDecode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(primitiveRootIdx, i, "the power of alpha used as the code's primitive root.", modRSDecode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(firstConsecutiveRoot, i, "the first root of the generator polynomial, or -1 to choose as CCSDS does.",
+	modRSDecode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(dualBasis, b, "whether symbols are sent in Berlekamp's dual basis.", modRSDecode_InterfaceP);
 GENERATE_ACCESSOR_METHODS(correctedErrorCount, i, "the tally of errors corrected.",
 	modRSDecode_InterfaceP);
 GENERATE_ACCESSOR_METHODS(uncorrected_error_count, i, "the tally of uncorrectable errors.", modRSDecode_InterfaceP);
 GENERATE_ACCESSOR_METHODS(errorless_unit_count, i, "the tally of units with no errors.", modRSDecode_InterfaceP);
 GENERATE_ACCESSOR_METHODS(corrected_unit_count, i, "the tally of units with correctable errors.", modRSDecode_InterfaceP);
 GENERATE_ACCESSOR_METHODS(set_uncorrected_unit_count, i, "the tally of units with uncorrectable errors.", modRSDecode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(decoded_codeword_count, i, "the tally of codewords checked.", modRSDecode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(decode_nsec, i, "the total nanoseconds spent checking and correcting codewords.", modRSDecode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(decode_workers, i, "the number of threads decoding in parallel, effective at the next start.",
+	modRSDecode_InterfaceP);
 METHOD_CLASS(rebuild_decoder, "n:n",
 	"After settings have been changed, rebuild the decoder function.", modRSDecode_InterfaceP);
 
@@ -101,11 +142,20 @@ void modRSDecode_Interface::register_methods(xmlrpc_c::registryPtr& rpcRegistry)
 	TEMPLATE_REGISTER_METHODS(modRSDecode, modRSDecode_Interface);
 	REGISTER_ACCESSOR_METHODS(maxErrorsPerCodeWord, modRSDecode, MaxErrorsPerCodeWord);
 	REGISTER_ACCESSOR_METHODS(interleavingDepth, modRSDecode, InterleavingDepth);
+	REGISTER_ACCESSOR_METHODS(primitivePoly, modRSDecode, PrimitivePoly);
+	REGISTER_ACCESSOR_METHODS(codeLength, modRSDecode, CodeLength);
+	REGISTER_ACCESSOR_METHODS(bitsPerSymbol, modRSDecode, BitsPerSymbol);
+	REGISTER_ACCESSOR_METHODS(primitiveRootIdx, modRSDecode, PrimitiveRootIdx);
+	REGISTER_ACCESSOR_METHODS(firstConsecutiveRoot, modRSDecode, FirstConsecutiveRoot);
+	REGISTER_ACCESSOR_METHODS(dualBasis, modRSDecode, DualBasis);
 	REGISTER_ACCESSOR_METHODS(correctedErrorCount, modRSDecode, CorrectedErrorCount);
 	REGISTER_ACCESSOR_METHODS(uncorrected_error_count, modRSDecode, UncorrectedErrorCount);
 	REGISTER_ACCESSOR_METHODS(errorless_unit_count, modRSDecode, ErrorlessUnitCount);
 	REGISTER_ACCESSOR_METHODS(corrected_unit_count, modRSDecode, CorrectedUnitCount);
 	REGISTER_ACCESSOR_METHODS(set_uncorrected_unit_count, modRSDecode, UncorrectedUnitCount);
+	REGISTER_ACCESSOR_METHODS(decoded_codeword_count, modRSDecode, DecodedCodewordCount);
+	REGISTER_ACCESSOR_METHODS(decode_nsec, modRSDecode, DecodeNsec);
+	REGISTER_ACCESSOR_METHODS(decode_workers, modRSDecode, DecodeWorkers);
 	REGISTER_METHOD(rebuild_decoder, "modRSDecode.rebuildDecoder");
 }
 
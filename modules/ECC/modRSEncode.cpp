@@ -16,25 +16,26 @@
 
 namespace nRSEncode {
 
-const int modRSEncode::primitivePoly = 0x187;
-
-const std::size_t modRSEncode::codeLength = 255;
-
-const std::size_t modRSEncode::bitsPerSymbol = 8;
-
-const Sym modRSEncode::primitiveRootIdx = 11;
-
-const bool modRSEncode::doBasisTransform = true;
-
 modRSEncode::modRSEncode(const std::string& newName, const std::string& newChannelName,
     	 const CE_DLL* newDLLPtr):
 	BaseTrafficHandler(newName, newChannelName, newDLLPtr),
+	_primitivePolySetting(CEcfg::instance()->getOrAddInt(cfgKey("primitivePoly"), 0x187)),
+	_codeLengthSetting(CEcfg::instance()->getOrAddInt(cfgKey("codeLength"), 255)),
+	_bitsPerSymbolSetting(CEcfg::instance()->getOrAddInt(cfgKey("bitsPerSymbol"), 8)),
+	_primitiveRootIdxSetting(CEcfg::instance()->getOrAddInt(cfgKey("primitiveRootIdx"), 11)),
+	_firstConsecutiveRootSetting(CEcfg::instance()->getOrAddInt(cfgKey("firstConsecutiveRoot"), -1)),
+	_dualBasisSetting(CEcfg::instance()->getOrAddBool(cfgKey("dualBasis"), true)),
 	_maxErrorsPerCodeword(16),
 	_maxErrorsPerCodewordSetting(CEcfg::instance()->getOrAddInt(cfgKey("maxErrorsPerCodeword"), _maxErrorsPerCodeword)),
 	_interleavingDepth(1),
 	_interleavingDepthSetting(CEcfg::instance()->getOrAddInt(cfgKey("interleavingDepth"), _interleavingDepth)),
 	_dataLength(0), _rsEncoder(0) {
 
+	setPrimitivePoly(_primitivePolySetting);
+	setCodeLength(_codeLengthSetting);
+	setBitsPerSymbol(_bitsPerSymbolSetting);
+	setPrimitiveRootIdx(_primitiveRootIdxSetting);
+	setFirstConsecutiveRoot(_firstConsecutiveRootSetting);
 	setMaxErrorsPerCodeword(_maxErrorsPerCodewordSetting);
 	setInterleavingDepth(_interleavingDepthSetting);
 
@@ -51,7 +52,6 @@ modRSEncode::~modRSEncode() {
 int modRSEncode::svc() {
 	svcStart_();
 	int dataLen;
-	SymVec parity;
 
 	while ( continueService() ) {
 		std::pair<NetworkData*, int> queueTop = getData_();
@@ -79,8 +79,7 @@ int modRSEncode::svc() {
 				ndSafeRelease(data);
 			}
 			else {
-				parity = _rsEncoder->encode(data);
-				data->append(&parity[0], parity.size());
+				_rsEncoder->appendParity(data);
 
 				MOD_DEBUG("Sending %d octets.", data->getUnitLength());
 				links_[PrimaryOutputLink]->send(data);
@@ -99,20 +98,20 @@ int modRSEncode::svc() {
 void modRSEncode::rebuildEncoder() {
 	_resetLengths();
 
-	MOD_DEBUG("Constructing a CCSDS RS(%d,%d) encoder with an interleaving depth of %d.",
-		codeLength,	_dataLength, _interleavingDepth);
-
-	if (_maxErrorsPerCodeword != 8 && _maxErrorsPerCodeword != 16)
-		throw BadValue(BadValue::msg("Max errors per codeword", _interleavingDepth));
+	MOD_DEBUG("Constructing a RS(%d,%d) encoder with an interleaving depth of %d.",
+		getCodeLength(), _dataLength, _interleavingDepth);
 
-	_rsEncoder = new RSEncoder(primitivePoly,
+	_rsEncoder = new RSEncoder(getPrimitivePoly(),
 		_maxErrorsPerCodeword * 2,
-		codeLength,
-		bitsPerSymbol,
-		primitiveRootIdx,
-		(_maxErrorsPerCodeword == 8)? 120 : 112 ,
+		getCodeLength(),
+		getBitsPerSymbol(),
+		getPrimitiveRootIdx(),
+		getFirstConsecutiveRoot(),
 		_interleavingDepth,
-		doBasisTransform);
+		getDualBasis());
+
+	MOD_DEBUG("Encoder is using %s GF kernels.",
+		RSBase::simdLevelToStr(_rsEncoder->getSimdLevel()).c_str());
 
 }
 
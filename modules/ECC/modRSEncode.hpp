@@ -43,10 +43,11 @@ public:
 	/// Reads in data, extracts a portion, and sends it to the output handler.
 	int svc();
 
-	/// Write-only accessor to _maxErrorsPerCodeword/_maxErrorsPerCodewordSetting.
-	/// @throw BadValue If newVal is other than 8 or 16.
+	/// @brief Write-only accessor to _maxErrorsPerCodeword/_maxErrorsPerCodewordSetting.
+	/// CCSDS uses 8 or 16; whether it fits the code length is checked when the encoder is rebuilt.
+	/// @throw ValueOutOfRange If newVal is not between 1 and 127.
 	void setMaxErrorsPerCodeword(const int& newVal) {
-		if ( newVal != 8 && newVal != 16 ) throw BadValue(BadValue::msg("Max errors per codeword", newVal));
+		if ( newVal < 1 || newVal > 127 ) throw ValueOutOfRange(ValueOutOfRange::msg("Max errors per codeword", newVal, 1, 127));
 		_maxErrorsPerCodewordSetting = static_cast<int>(newVal);
 		_maxErrorsPerCodeword = newVal;
 	}
@@ -63,28 +64,98 @@ public:
 	/// Read-only accessor to _interleavingDepth/_interleavingDepthSetting.
 	int getInterleavingDepth() const { return _interleavingDepth; }
 
-	/// If interleave depth or max errors have changed, this must be called for the
-	/// changes to take effect.
+	/// If interleave depth, max errors, or any code parameter has changed, this must be
+	/// called for the changes to take effect.
+	/// @throw nd_error If the parameters do not describe a valid code; see RSBase::RSBase().
 	void rebuildEncoder();
 
-	/// Encoder attribute that will not change.
-	static const int primitivePoly;
+	/// @brief Write-only accessor to _primitivePolySetting.
+	/// Whether it is actually primitive is checked when the encoder is rebuilt.
+	/// @throw ValueOutOfRange If newVal is not a polynomial of degree 2 through 8.
+	void setPrimitivePoly(const int newVal) {
+		if ( newVal < 0x4 || newVal > 0x1ff )
+			throw ValueOutOfRange(ValueOutOfRange::msg("Primitive polynomial", newVal, 0x4, 0x1ff));
+		_primitivePolySetting = newVal;
+	}
+
+	/// Read-only accessor to _primitivePolySetting.
+	int getPrimitivePoly() const { return _primitivePolySetting; }
+
+	/// @brief Write-only accessor to _codeLengthSetting. Values below 2^bitsPerSymbol - 1
+	/// select a shortened code.
+	/// @throw ValueOutOfRange If newVal is not between 3 and 255.
+	void setCodeLength(const int newVal) {
+		if ( newVal < 3 || newVal > 255 ) throw ValueOutOfRange(ValueOutOfRange::msg("Code length", newVal, 3, 255));
+		_codeLengthSetting = newVal;
+	}
+
+	/// Read-only accessor to _codeLengthSetting.
+	int getCodeLength() const { return _codeLengthSetting; }
 
-	/// Encoder attribute that will not change.
-	static const std::size_t codeLength;
+	/// Write-only accessor to _bitsPerSymbolSetting.
+	/// @throw ValueOutOfRange If newVal is not between 2 and 8.
+	void setBitsPerSymbol(const int newVal) {
+		if ( newVal < 2 || newVal > 8 ) throw ValueOutOfRange(ValueOutOfRange::msg("Bits per symbol", newVal, 2, 8));
+		_bitsPerSymbolSetting = newVal;
+	}
 
-	/// Encoder attribute that will not change.
-	static const std::size_t bitsPerSymbol;
+	/// Read-only accessor to _bitsPerSymbolSetting.
+	int getBitsPerSymbol() const { return _bitsPerSymbolSetting; }
 
-	/// Encoder attribute that will not change.
-	static const Sym primitiveRootIdx;
+	/// Write-only accessor to _primitiveRootIdxSetting.
+	/// @throw ValueOutOfRange If newVal is not between 1 and 254.
+	void setPrimitiveRootIdx(const int newVal) {
+		if ( newVal < 1 || newVal > 254 ) throw ValueOutOfRange(ValueOutOfRange::msg("Primitive root index", newVal, 1, 254));
+		_primitiveRootIdxSetting = newVal;
+	}
 
-	/// Encoder attribute that will not change.
-	static const bool doBasisTransform;
+	/// Read-only accessor to _primitiveRootIdxSetting.
+	int getPrimitiveRootIdx() const { return _primitiveRootIdxSetting; }
+
+	/// @brief Write-only accessor to _firstConsecutiveRootSetting.
+	/// @param newVal The power of the primitive root that is the generator's first root,
+	/// or -1 to choose it as CCSDS does.
+	/// @throw ValueTooLarge If newVal is over 254.
+	void setFirstConsecutiveRoot(const int newVal) {
+		if ( newVal > 254 ) throw ValueTooLarge(ValueTooLarge::msg("First consecutive root", newVal, 254));
+		_firstConsecutiveRootSetting = ( newVal < 0 )? -1 : newVal;
+	}
+
+	/// @brief The first consecutive root in use. If none was set, it is the one that
+	/// makes the generator symmetric, 2^(bitsPerSymbol - 1) - E, giving the CCSDS
+	/// values of 120 for E=8 and 112 for E=16.
+	int getFirstConsecutiveRoot() const {
+		const int fcr = _firstConsecutiveRootSetting;
+		return ( fcr >= 0 )? fcr : ( 1 << (getBitsPerSymbol() - 1) ) - _maxErrorsPerCodeword;
+	}
+
+	/// Write-only accessor to _dualBasisSetting.
+	void setDualBasis(const bool newVal) { _dualBasisSetting = newVal; }
+
+	/// Read-only accessor to _dualBasisSetting.
+	bool getDualBasis() const { return _dualBasisSetting; }
 
 private:
+	/// The field polynomial; 0x187 for CCSDS.
+	Setting& _primitivePolySetting;
+
+	/// Symbols per codeword, data plus parity; 255 for CCSDS.
+	Setting& _codeLengthSetting;
+
+	/// The size of each symbol; 8 for CCSDS.
+	Setting& _bitsPerSymbolSetting;
+
+	/// The power of alpha used as the code's primitive root; 11 for CCSDS.
+	Setting& _primitiveRootIdxSetting;
+
+	/// The first root of the generator as a power of the primitive root, or -1 for automatic.
+	Setting& _firstConsecutiveRootSetting;
+
+	/// Whether symbols are sent in Berlekamp's dual basis, as CCSDS does.
+	Setting& _dualBasisSetting;
+
 	/// Reed-Solomon error correction capability, in symbols, within an R-S codeword.
-	/// May be selected to be 16 or 8 R-S symbols.
+	/// CCSDS selects 16 or 8 R-S symbols.
 	int _maxErrorsPerCodeword;
 
 	/// The config file setting for _maxErrorsPerCodeword.
@@ -100,9 +171,9 @@ private:
 	/// The size of the data area in the codeword.
 	int _dataLength;
 
-	/// Recompute _dataLength based on _maxErrorsPerCodeword and codeLength.
+	/// Recompute _dataLength based on _maxErrorsPerCodeword and the code length.
 	void _resetLengths() {
-		_dataLength = codeLength - (_maxErrorsPerCodeword * 2);
+		_dataLength = getCodeLength() - (_maxErrorsPerCodeword * 2);
 	}
 
 	/// Pointer to the object that will actually handle the encoding.
@@ -36,6 +36,12 @@ public:
 	
 	GENERATE_INT_ACCESSORS(maxErrorsPerCodeWord, setMaxErrorsPerCodeword, getMaxErrorsPerCodeword);
 	GENERATE_INT_ACCESSORS(interleavingDepth, setInterleavingDepth, getInterleavingDepth);
+	GENERATE_INT_ACCESSORS(primitivePoly, setPrimitivePoly, getPrimitivePoly);
+	GENERATE_INT_ACCESSORS(codeLength, setCodeLength, getCodeLength);
+	GENERATE_INT_ACCESSORS(bitsPerSymbol, setBitsPerSymbol, getBitsPerSymbol);
+	GENERATE_INT_ACCESSORS(primitiveRootIdx, setPrimitiveRootIdx, getPrimitiveRootIdx);
+	GENERATE_INT_ACCESSORS(firstConsecutiveRoot, setFirstConsecutiveRoot, getFirstConsecutiveRoot);
+	GENERATE_BOOL_ACCESSORS(dualBasis, setDualBasis, getDualBasis);
 		
 	void rebuild_encoder(xmlrpc_c::paramList const& paramList, xmlrpc_c::value* retvalP) {
 		ACE_TRACE("modRSEncode_Interface::rebuild_encoder");
@@ -58,6 +64,12 @@ protected:
 		// Build a map of associated settings
 		settings["maxErrorsPerCodeWord"] = xmlrpc_c::value_int(handler->getMaxErrorsPerCodeword());		
 		settings["interleavingDepth"] = xmlrpc_c::value_int(handler->getInterleavingDepth());		
+		settings["primitivePoly"] = xmlrpc_c::value_int(handler->getPrimitivePoly());
+		settings["codeLength"] = xmlrpc_c::value_int(handler->getCodeLength());
+		settings["bitsPerSymbol"] = xmlrpc_c::value_int(handler->getBitsPerSymbol());
+		settings["primitiveRootIdx"] = xmlrpc_c::value_int(handler->getPrimitiveRootIdx());
+		settings["firstConsecutiveRoot"] = xmlrpc_c::value_int(handler->getFirstConsecutiveRoot());
+		settings["dualBasis"] = xmlrpc_c::value_boolean(handler->getDualBasis());
 	}
 };
 
@@ -68,6 +80,14 @@ GENERATE_ACCESSOR_METHODS(maxErrorsPerCodeWord, i, "the Reed-Solomon error corre
 	modRSEncode_InterfaceP);
 GENERATE_ACCESSOR_METHODS(interleavingDepth, i, "the number of codewords to use for encoding.",
 	modRSEncode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(primitivePoly, i, "the field polynomial, such as 0x187 for CCSDS.", modRSEncode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(codeLength, i, "the number of symbols per codeword; less than 2^bitsPerSymbol - 1 for a shortened code.",
+	modRSEncode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(bitsPerSymbol, i, "the size of each symbol, from 2 to 8 bits.", modRSEncode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(primitiveRootIdx, i, "the power of alpha used as the code's primitive root.", modRSEncode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(firstConsecutiveRoot, i, "the first root of the generator polynomial, or -1 to choose as CCSDS does.",
+	modRSEncode_InterfaceP);
+GENERATE_ACCESSOR_METHODS(dualBasis, b, "whether symbols are sent in Berlekamp's dual basis.", modRSEncode_InterfaceP);
 METHOD_CLASS(rebuild_encoder, "n:n",
 	"After settings have been changed, rebuild the encoder function.", modRSEncode_InterfaceP);
 	
@@ -77,6 +97,12 @@ void modRSEncode_Interface::register_methods(xmlrpc_c::registryPtr& rpcRegistry)
 	TEMPLATE_REGISTER_METHODS(modRSEncode, modRSEncode_Interface);
 	REGISTER_ACCESSOR_METHODS(maxErrorsPerCodeWord, modRSEncode, MaxErrorsPerCodeWord);
 	REGISTER_ACCESSOR_METHODS(interleavingDepth, modRSEncode, InterleavingDepth);	
+	REGISTER_ACCESSOR_METHODS(primitivePoly, modRSEncode, PrimitivePoly);
+	REGISTER_ACCESSOR_METHODS(codeLength, modRSEncode, CodeLength);
+	REGISTER_ACCESSOR_METHODS(bitsPerSymbol, modRSEncode, BitsPerSymbol);
+	REGISTER_ACCESSOR_METHODS(primitiveRootIdx, modRSEncode, PrimitiveRootIdx);
+	REGISTER_ACCESSOR_METHODS(firstConsecutiveRoot, modRSEncode, FirstConsecutiveRoot);
+	REGISTER_ACCESSOR_METHODS(dualBasis, modRSEncode, DualBasis);
 	REGISTER_METHOD(rebuild_encoder, "modRSEncode.rebuildEncoder");
 }
 
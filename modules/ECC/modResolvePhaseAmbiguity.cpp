@@ -13,14 +13,11 @@
 //=============================================================================
 
 #include "modResolvePhaseAmbiguity.hpp"
-#include <bitset>
 
 using namespace nasaCE;
 
 namespace nResolvePhaseAmbiguity {
 
-const size_t modResolvePhaseAmbiguity::_markerTableRows = 16;
-
 modResolvePhaseAmbiguity::modResolvePhaseAmbiguity(const std::string& newName, const std::string& newChannelName,
     	 const CE_DLL* newDLLPtr /* = 0 */):
 	BaseTrafficHandler(newName, newChannelName, newDLLPtr),
@@ -31,17 +28,19 @@ modResolvePhaseAmbiguity::modResolvePhaseAmbiguity(const std::string& newName, c
 	_waitForNewDataInterval(ACE_Time_Value::zero),
 	_maxUsecsForNewData(CEcfg::instance()->getOrAddInt(cfgKey("maxUsecsForNewData"), -1)),
 	_marker(CEcfg::instance()->getOrAddArray(cfgKey("markerPattern"))),
-	_rebuildMarkerTable(true),
-	_markerTable(0),
-	_markerLen(0),
+	_rebuildMarker(true),
+	_locked(false),
+	_markerPeriodBits(0),
+	_nextMarkerBit(0),
+	_haveLastMarker(false),
+	_lastMarkerBit(0),
+	_shiftChangeCount(0),
+	_markerMissCount(0),
 	_detectShift(true),
 	_detectShiftSetting(CEcfg::instance()->getOrAddBool(cfgKey("detectShift"), _detectShift)),
 	_allowedMarkerBitErrors(0),
 	_allowedMarkerBitErrorsSetting(CEcfg::instance()->getOrAddInt(cfgKey("allowedMarkerBitErrors"), _allowedMarkerBitErrors)) {
 
-	_markerTable = new ACE_UINT8*[_markerTableRows];
-	ACE_OS::memset(_markerTable, 0, _markerTableRows);
-
 	setLeftShiftBits(_leftShiftBitsSetting);
 	_invert = _invertSetting;
 
@@ -65,15 +64,6 @@ modResolvePhaseAmbiguity::modResolvePhaseAmbiguity(const std::string& newName, c
 modResolvePhaseAmbiguity::~modResolvePhaseAmbiguity() {
 	MOD_DEBUG("Running ~modResolvePhaseAmbiguity().");
 	stopTraffic();
-
-	if (_markerTable[0]) {
-		for ( size_t i = 0; i < _markerTableRows; ++i ) {
-			delete _markerTable[i];
-			_markerTable[i] = 0;
-		}
-	}
-
-	delete[] _markerTable;
 }
 
 void modResolvePhaseAmbiguity::setMarker(const uint8_t* asmBuf, const int bufLen) {
@@ -86,7 +76,7 @@ void modResolvePhaseAmbiguity::setMarker(const uint8_t* asmBuf, const int bufLen
 	// Eliminate extra slots
 	while (_marker.getLength() > bufLen) _marker.remove(bufLen);
 
-	_rebuildMarkerTable = true;
+	_rebuildMarker = true;
 }
 
 void modResolvePhaseAmbiguity::setMarker(const std::vector<uint8_t>& newMarker) {
@@ -102,7 +92,7 @@ void modResolvePhaseAmbiguity::setMarker(const std::vector<uint8_t>& newMarker)
 	while (static_cast<unsigned>(_marker.getLength()) > newMarker.size())
 		_marker.remove(newMarker.size());
 
-	_rebuildMarkerTable = true;
+	_rebuildMarker = true;
 }
 
 void modResolvePhaseAmbiguity::getMarker(std::vector<uint8_t>& marker) const {
@@ -112,156 +102,103 @@ void modResolvePhaseAmbiguity::getMarker(std::vector<uint8_t>& marker) const {
 		marker.push_back(static_cast<int>(_marker[i]) & 0xFF);
 }
 
-void modResolvePhaseAmbiguity::_updateMarkerTable() {
-	if ( ! _rebuildMarkerTable ) return;
+void modResolvePhaseAmbiguity::_updateMarker() {
+	if ( ! _rebuildMarker ) return;
 
-	_markerLen = _marker.getLength();
+	std::vector<uint8_t> marker;
+	getMarker(marker);
 
-	if (_markerTable[0]) {
-		for ( size_t i = 0; i < _markerTableRows; ++i ) {
-			delete _markerTable[i];
-			_markerTable[i] = 0;
-		}
-	}
-
-	size_t row, leftShiftBits, rightShiftBits;
-
-	for ( row = 0; row < _markerTableRows/2; ++row ) {
-		_markerTable[row] = new ACE_UINT8[_markerLen];
-		_markerTable[row+8] = new ACE_UINT8[_markerLen];
+	if ( ! marker.empty() ) _correlator.setPattern(&marker[0], marker.size());
+	else _correlator.setPattern(0, 0);
 
-		leftShiftBits = row;
-		rightShiftBits = 8 - leftShiftBits;
-		for ( size_t offset = 0; offset < _markerLen; ++offset ) {
-			if ( leftShiftBits == 0 ) { // no shift
-				_markerTable[row][offset] = static_cast<int>(_marker[offset]) & 0xff;
-			}
-			else if ( offset < _markerLen - 1 ) { // shift first octets
-				_markerTable[row][offset] = (static_cast<int>(_marker[offset]) & 0xff) << leftShiftBits |
-					(static_cast<int>(_marker[offset + 1]) & 0xff) >> rightShiftBits;
-			}
-			else { // shift last octet
-				_markerTable[row][offset] = (static_cast<int>(_marker[offset]) & 0xff) << leftShiftBits;
-			}
+	_locked = false;
+	_haveLastMarker = false;
+	_rebuildMarker = false;
 
-			_markerTable[row+8][offset] = ~(_markerTable[row][offset]); // make another row for inverted values
-		}
-	}
-
-	_rebuildMarkerTable = false;
-
-	#ifdef DEFINE_DEBUG
-
-	std::ostringstream s;
-	for ( row = 0; row < _markerTableRows; ++row ) {
-		s << "Row " << std::setw(2) << std::setfill(' ') << std::dec << row << ": ";
-		for ( unsigned offset = 0; offset < _markerLen; ++offset ) {
-			s	<< std::hex << std::setw(2) << std::setfill('0')
-				<< static_cast<int>(_markerTable[row][offset]) << ' ';
-		}
-		s << std::endl;
-	}
-
-	std::string tableStr(s.str());
-	MOD_DEBUG("Marker table:\n%s", tableStr.c_str());
-
-	#endif
-
-	MOD_DEBUG("Updated shifted marker table with %d-octet marker.", _markerLen);
+	MOD_DEBUG("Correlating the first %d octets of a %d-octet marker.", _correlator.getPatternLen(),
+		marker.size());
 }
 
-bool modResolvePhaseAmbiguity::_inTableAt(const ACE_UINT8* buffer,
-	const uint8_t& leftShiftBits, const bool isInverted) {
-
-	size_t offset = 0;
-	const size_t row = isInverted? leftShiftBits + 8 : leftShiftBits;
-	const uint8_t finalOctetMask = 0xff << leftShiftBits;
-	int currentBitErrors = 0;
-
-	// Compare markerLen - 1 full octets
-	for ( offset = 0; offset < _markerLen - 1; ++offset ) {
-		if ( _markerTable[row][offset] != buffer[offset] && _allowedMarkerBitErrors == 0 ) return false;
+bool modResolvePhaseAmbiguity::_checkMarkers(const ACE_UINT8* buf, const size_t len) {
+	const ACE_INT64 blockBits = static_cast<ACE_INT64>(len) * 8;
+	const ACE_INT64 patternBits = _correlator.getPatternLen() * 8;
+	const unsigned allowedBitErrors = _correlator.getAllowedBitErrors();
 
-		// Use XOR to get mismatched bits.
-		std::bitset<8> testOctet(buffer[offset] ^ _markerTable[row][offset]);
-		currentBitErrors += testOctet.count();
-
-		if ( currentBitErrors > _allowedMarkerBitErrors ) return false;
-	}
-
-	// Compare 1-8 bits in final octet
-	if ( _allowedMarkerBitErrors == 0 ) {
-		if ( ( _markerTable[row][offset] & finalOctetMask ) != ( buffer[offset] & finalOctetMask)) return false;
+	for ( ; _nextMarkerBit < blockBits; _nextMarkerBit += _markerPeriodBits ) {
+		if ( _nextMarkerBit >= 0 && _nextMarkerBit + patternBits <= blockBits &&
+			_correlator.bitErrorsAt(buf, len, _nextMarkerBit, _invert) > allowedBitErrors ) return false;
 	}
-	else {
-		std::bitset<8> testOctet(( buffer[offset] & finalOctetMask) ^ ( _markerTable[row][offset] & finalOctetMask ));
-		currentBitErrors += testOctet.count();
-
-		if ( currentBitErrors > _allowedMarkerBitErrors ) return false;
-	}
-
-	MOD_DEBUG("_inTableAt: Bit left shift is %d, inversion is %s (ASM table row %d). %d bit errors.",
-		leftShiftBits, isInverted? "true" : "false", row, currentBitErrors);
 
+	_nextMarkerBit -= blockBits;
 	return true;
 }
 
-bool modResolvePhaseAmbiguity::_findInTable(const ACE_UINT8* buffer,
-	uint8_t& leftShiftBits, uint8_t& isInverted) {
+bool modResolvePhaseAmbiguity::_findShift(const ACE_UINT8* buf, const size_t len, const size_t startOctet) {
+	const ACE_INT64 patternBits = _correlator.getPatternLen() * 8;
+	AsmCorrelator::Match match;
+	size_t offset = startOctet;
+
+	while ( offset < len && _correlator.search(buf + offset, len - offset, match) ) {
+		offset += match.endOctet + 1;
+
+		// The marker ends match.shift bits into its last octet, or at its end if zero.
+		const ACE_INT64 markerBit = static_cast<ACE_INT64>(offset) * 8 -
+			( match.shift? 8 - match.shift : 0 ) - patternBits;
+		const int leftShiftBits = ( 8 - match.shift ) % 8;
+
+		if ( _haveLastMarker && leftShiftBits == _leftShiftBits && match.inverted == _invert &&
+			markerBit - _lastMarkerBit >= patternBits ) {
+			_markerPeriodBits = markerBit - _lastMarkerBit;
+			_nextMarkerBit = markerBit + _markerPeriodBits;
+			_locked = true;
+			_haveLastMarker = false;
+
+			MOD_DEBUG("_findShift: Locked with bit left shift %d, inversion %s, marker period %d bits.",
+				leftShiftBits, _invert? "true" : "false", static_cast<int>(_markerPeriodBits));
+			return true;
+		}
 
-	// First try with given values
-	if ( _inTableAt(buffer, leftShiftBits, isInverted)) return true;
+		if ( leftShiftBits != _leftShiftBits || match.inverted != _invert ) {
+			setLeftShiftBits(leftShiftBits);
+			setInversion(match.inverted);
+			++_shiftChangeCount;
 
-	// That didn't succeed, so check every permutation.
-	uint8_t testLeftShiftBits, testIsInverted;
+			MOD_DEBUG("_findShift: Bit left shift is %d, inversion is %s.",
+				leftShiftBits, match.inverted? "true" : "false");
+		}
 
-	for ( testLeftShiftBits = 0; testLeftShiftBits < 8; ++testLeftShiftBits )
-		for ( testIsInverted = 0; testIsInverted < 2; ++testIsInverted )
-			if ( _inTableAt(buffer, testLeftShiftBits, testIsInverted)) {
-				leftShiftBits = testLeftShiftBits;
-				isInverted = testIsInverted;
-				return true;
-			}
+		_lastMarkerBit = markerBit;
+		_haveLastMarker = true;
+	}
 
-	// Failed to find anything so reset the values
 	return false;
 }
 
-void modResolvePhaseAmbiguity::_findShift(NetworkData*& data) {
-	uint8_t leftShiftBits, isInverted;
-	int counters[8][2] = {{0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}};
-	bool foundSomething = false;
+void modResolvePhaseAmbiguity::_trackMarkers(const ACE_UINT8* buf, const size_t len) {
+	_updateMarker();
+	_correlator.setAllowedBitErrors(( _allowedMarkerBitErrors > 0 )? _allowedMarkerBitErrors : 0);
 
-	for ( size_t offset = 0; offset < data->getUnitLength() - _markerLen; ++offset ) {
-		// Set these to configured/previously found values to hopefully skip a few iterations
-		leftShiftBits = getLeftShiftBits();
-		isInverted = getInversion();
+	size_t searchFrom = 0;
 
-		if ( _findInTable(data->ptrUnit() + offset, leftShiftBits, isInverted ) ) {
-			++counters[leftShiftBits][isInverted];
-			foundSomething = true;
-		}
-	}
+	while ( true ) {
+		if ( _locked ) {
+			if ( _checkMarkers(buf, len) ) return;
 
-	if ( ! foundSomething ) {
-		MOD_NOTICE("_findShift: Could not locate a shifted and/or inverted ASM in the data block.");
-		return;
-	}
-
-	uint8_t mostLeftShiftBits = 0, mostIsInverted = 0;
+			MOD_NOTICE("Marker missing at bit %d of the block, searching again.",
+				static_cast<int>(_nextMarkerBit));
+			++_markerMissCount;
+			_locked = false;
 
-	for ( leftShiftBits = 0; leftShiftBits < 8; ++leftShiftBits )
-		for ( isInverted = 0; isInverted < 2; ++isInverted )
-			if ( counters[leftShiftBits][isInverted] > counters[mostLeftShiftBits][mostIsInverted] ) {
-				mostLeftShiftBits = leftShiftBits;
-				mostIsInverted = isInverted;
-			}
+			// The search restarts mid-stream, so earlier bits must not be correlated with what follows.
+			searchFrom = _nextMarkerBit / 8;
+			_correlator.reset();
+		}
 
-	setLeftShiftBits(mostLeftShiftBits);
-	setInversion(mostIsInverted);
+		if ( ! _findShift(buf, len, searchFrom) ) break;
+	}
 
-	MOD_DEBUG("_findShift: Bit left shift is %d, inversion is %s.",
-		mostLeftShiftBits, mostIsInverted? "true" : "false");
+	// The correlator keeps the end of this block, so a marker split across blocks is found too.
+	_lastMarkerBit -= static_cast<ACE_INT64>(len) * 8;
 }
 
 int modResolvePhaseAmbiguity::svc() {
@@ -269,7 +206,7 @@ int modResolvePhaseAmbiguity::svc() {
 
 	ACE_Time_Value timeToWaitUntil;
 	ACE_Message_Block* mb = 0;
-	ACE_UINT8 carry = 0; // Bits left over from the previous data unit.
+	ACE_UINT8 carry = 0; // The last octet of the previous data unit.
 	bool haveCarry = false;
 
 	while ( continueService() ) {
@@ -292,75 +229,48 @@ int modResolvePhaseAmbiguity::svc() {
 		MOD_DEBUG("Received %d octets to shift and/or invert.", incomingBlockLen);
 
 		if ( incomingBlockLen && links_[PrimaryOutputLink] ) {
-			if ( getDetectShift() ) {
-				_updateMarkerTable();
-				_findShift(data);
-			}
+			if ( getDetectShift() ) _trackMarkers(data->ptrUnit(), incomingBlockLen);
 
-			NetworkData* shifted = new NetworkData(incomingBlockLen + 1);
-			MOD_DEBUG("Created %d octet buffer to shift into.", shifted->getUnitLength());
-
-			ACE_UINT8 rightShiftBits = 8 - _leftShiftBits;
-			int carryOffset = 0;
-
-			for (unsigned offset = 0; offset < incomingBlockLen; ++offset ) {
-				if ( _leftShiftBits > 0 ) {
-
-					if ( offset == 0 ) { // first octet
-						if ( haveCarry ) {
-							*(shifted->ptrUnit()) = carry | (*(data->ptrUnit()) >> _leftShiftBits);
-							carry = 0;
-							haveCarry = false;
-							carryOffset = 0;
-						}
-						else {
-							MOD_DEBUG("First octet, no carry, changing unit length to %d.",
-								incomingBlockLen - 1);
-							carryOffset = -1;
-							shifted->setUnitLength(incomingBlockLen - 1, true);
-							continue;
-						}
-					}
-					else {
-						*(shifted->ptrUnit() + offset + carryOffset) =
-							(*(data->ptrUnit() + offset - 1) << rightShiftBits) |
-							(*(data->ptrUnit() + offset) >> _leftShiftBits);
-					}
+			// Output octet i begins shift bits into input octet i - 1.
+			const unsigned shift = ( 8 - _leftShiftBits ) % 8;
+			NetworkData* shifted = data;
+
+			if ( shift || _invert ) {
+				// Shift in place unless another segment is still holding the same buffer.
+				if ( data->reference_count() > 1 ) {
+					shifted = new NetworkData(incomingBlockLen, NetworkData::noFill);
+					MOD_DEBUG("Created %d octet buffer to shift into.", shifted->getUnitLength());
 				}
-				else *(shifted->ptrUnit() + offset + carryOffset) = *(data->ptrUnit() + offset);
 
-				if ( _invert ) *(shifted->ptrUnit() + offset + carryOffset) =
-					~ *(shifted->ptrUnit() + offset + carryOffset);
-			}
+				AsmCorrelator::realign(shifted->ptrUnit(), data->ptrUnit(), incomingBlockLen, shift,
+					_invert, carry);
 
-			if ( _leftShiftBits > 0 ) {
-				carry = *(data->ptrUnit() + incomingBlockLen - 1 ) << rightShiftBits;
-				haveCarry = true;
+				// Without the previous block's last octet, the first output octet is incomplete.
+				if ( shift && ! haveCarry ) {
+					MOD_DEBUG("First octet, no carry, changing unit length to %d.", incomingBlockLen - 1);
+					shifted->rd_ptr(1);
+				}
 			}
 
+			haveCarry = ( shift > 0 );
+			if ( shifted == data ) data = 0;
+
 			// Before sending, peek into the queue for up to the configured microseconds.
-			// If nothing shows up, send the carry with the current block; otherwise
-			// save it for the next.
+			// If nothing shows up, the carry can't be completed, so drop it; otherwise
+			// save it for the next block.
 			timeToWaitUntil = _getWaitUntilTime();
-			if ( _leftShiftBits > 0 && msg_queue()->peek_dequeue_head(mb, &timeToWaitUntil) == -1 ) {
-				MOD_DEBUG("Including carry on current block after not seeing a new block for %d microseconds.",
+			if ( haveCarry && msg_queue()->peek_dequeue_head(mb, &timeToWaitUntil) == -1 ) {
+				MOD_DEBUG("Dropping carry after not seeing a new block for %d microseconds.",
 					getMaxUsecsForNewData());
-
-				// Nothing else is coming, drop the carry.
-				// *(shifted->ptrUnit() + shifted->getUnitLength() - 1 + carryOffset) = _invert? ~carry : carry;
-				carry = 0;
 				haveCarry = false;
 			}
 
-			if (shifted->getUnitLength() > incomingBlockLen) {
-				// Either there's no left shift, or another block is waiting, send the carry with it.
-				// Reduce the size of the unit by 1 octet (buffer size is unmodified).
-				shifted->setUnitLength(incomingBlockLen, true);
+			if ( shifted->getUnitLength() ) {
+				MOD_DEBUG("Sending %d unit/%d buffer octets.", shifted->getUnitLength(),
+					shifted->getBufferSize());
+				links_[PrimaryOutputLink]->send(shifted);
 			}
-
-			MOD_DEBUG("Sending %d unit/%d buffer octets.", shifted->getUnitLength(),
-				shifted->getBufferSize());
-			links_[PrimaryOutputLink]->send(shifted);
+			else ndSafeRelease(shifted);
 		}
 		else {
 			if ( incomingBlockLen )
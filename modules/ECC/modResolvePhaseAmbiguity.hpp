@@ -16,6 +16,7 @@
 #define _MOD_EMULATE_PHASE_AMBIGUITY_HPP_
 
 #include <BaseTrafficHandler.hpp>
+#include "AsmCorrelator.hpp"
 #include <ace/Event_Handler.h>
 
 namespace nResolvePhaseAmbiguity {
@@ -25,6 +26,11 @@ namespace nResolvePhaseAmbiguity {
  * @class modResolvePhaseAmbiguity
  * @author Tad Kollar  
  * @brief Detect phase ambiguity by ASM and bit shifts and/or inverts to correct.
+ *
+ * Once two markers with the same alignment have been found, the distance between
+ * them is taken as the marker period and later markers are only checked where
+ * the period predicts them. The stream is searched again only when one of those
+ * checks fails, so a locked stream costs one comparison per frame.
  */
 //=============================================================================
 class modResolvePhaseAmbiguity : public BaseTrafficHandler {
@@ -104,9 +110,10 @@ public:
 	/// @param marker A vector to copy _marker into.
 	void getMarker(std::vector<uint8_t>& marker) const;
 
-	/// Write-only accessor to _detectShift and _detectShiftSetting.
+	/// Write-only accessor to _detectShift and _detectShiftSetting; restarts the search.
 	void setDetectShift(bool newVal) {
 		_detectShift = newVal;
+		_rebuildMarker = true; // Marker positions were not tracked while off.
 		_detectShiftSetting = newVal;
 	}
 
@@ -124,6 +131,21 @@ public:
 		return _allowedMarkerBitErrors;
 	}
 
+	/// Write-only accessor to _shiftChangeCount.
+	void setShiftChangeCount(const uint64_t& newVal) { _shiftChangeCount = newVal; }
+
+	/// Read-only accessor to _shiftChangeCount.
+	uint64_t getShiftChangeCount() const { return _shiftChangeCount; }
+
+	/// Write-only accessor to _markerMissCount.
+	void setMarkerMissCount(const uint64_t& newVal) { _markerMissCount = newVal; }
+
+	/// Read-only accessor to _markerMissCount.
+	uint64_t getMarkerMissCount() const { return _markerMissCount; }
+
+	/// Read-only accessor to _locked.
+	bool isLocked() const { return _locked; }
+
 private:
 	/// The number of bits the data has been shifted by, 0 - 7.
 	int _leftShiftBits;
@@ -145,48 +167,62 @@ private:
 
 	/// Add _waitForNewDataInterval to the current time.
 	ACE_Time_Value _getWaitUntilTime() const {
-		return ACE_High_Res_Timer::gettimeofday_hr() + _waitForNewDataInterval;
+		return ClockService::instance()->preciseNow() + _waitForNewDataInterval;
 	}
 
 	/// The type of ASM marker.
 	Setting& _marker;
 
-	/// Whether _marker has been updated or the ASM buffer otherwise needs to be (re)created.
-	bool _rebuildMarkerTable;
-
-	static const size_t _markerTableRows;
-
-	/// The two-dimensional array that holds the ASM in row 0, the ASM left-shifted 1 bit
-	/// in row 1, etc, up to row 7. Row 8 is row 0 inverted, row 9 is row 1 inverted, etc.
-	ACE_UINT8** _markerTable;
-
-	/// The number of octets in the ASM.
-	size_t _markerLen;
-
-	/// Create a buffer with the contents of the new marker.
-	void _updateMarkerTable();
-
-	/// Determine whether the contents of the supplied buffer match the contents
-	/// of the marker table row that's been subjected to the specified shifting
-	/// and inversion.
-	/// @param buffer The data to compare to the table.
-	/// @param leftShiftBits Number of bits to shift, 0-7.
-	/// @param isInverted Whether all the bits are flipped.
-	/// @return True if the buffer matches.
-	bool _inTableAt(const ACE_UINT8* buffer, const uint8_t& leftShiftBits, const bool isInverted);
-
-	/// Check through each row in the ASM table to determine the shift/version values.
-	/// @param buffer The data to compare to the table.
-	/// @param leftShiftBits Returned with the number of bits in the shift, 0-7. Value supplied by the call is tried first.
-	/// @param isInverted Returned with the value of the inversion. Value supplied by the call is tried first.
-	/// @return True if the buffer was found in the table.
-	bool _findInTable(const ACE_UINT8* buffer, uint8_t& leftShiftBits, uint8_t& isInverted);
-
-	/// Iterate through the data block looking for shifted/inverted ASMs and count them.
-	/// Whichever left shift/inversion count is the highest indicates the way the entire
-	/// block will be right shifted and/or inverted to correct the problem.
-	/// @param data The block to be searched for ASMs (not modified at this time).
-	void _findShift(NetworkData*& data);
+	/// Whether _marker has been updated and _correlator needs the new pattern.
+	bool _rebuildMarker;
+
+	/// Finds shifted and/or inverted markers in the raw stream.
+	AsmCorrelator _correlator;
+
+	/// Give _correlator the current marker if it has changed.
+	void _updateMarker();
+
+	/// True if the marker period is known and markers are only checked where expected.
+	bool _locked;
+
+	/// The distance in bits from the start of one marker to the start of the next.
+	ACE_INT64 _markerPeriodBits;
+
+	/// While locked, where the next marker should start, in bits from the start of the current block.
+	ACE_INT64 _nextMarkerBit;
+
+	/// Whether _lastMarkerBit holds the position of a marker found while unlocked.
+	bool _haveLastMarker;
+
+	/// Where the most recently found marker starts, in bits from the start of the current block.
+	ACE_INT64 _lastMarkerBit;
+
+	/// The number of times detection changed the shift or inversion.
+	uint64_t _shiftChangeCount;
+
+	/// The number of times a marker was missing where the period predicted it.
+	uint64_t _markerMissCount;
+
+	/// Check the marker positions predicted in this block, and move on to the next block.
+	/// If the marker is missing, search again from there.
+	/// @param buf The block as received.
+	/// @param len The number of octets in buf.
+	void _trackMarkers(const ACE_UINT8* buf, const size_t len);
+
+	/// Compare the stream with the marker at each predicted position in the block.
+	/// A marker running past the end of the block is assumed to be present.
+	/// @param buf The block as received.
+	/// @param len The number of octets in buf.
+	/// @return True if all were found; if not, _nextMarkerBit is left on the missing one.
+	bool _checkMarkers(const ACE_UINT8* buf, const size_t len);
+
+	/// Search for shifted/inverted ASMs, adopting the shift and inversion of each
+	/// one found. Two in a row with the same alignment set the marker period and lock.
+	/// @param buf The block as received.
+	/// @param len The number of octets in buf.
+	/// @param startOctet Where in buf to begin searching.
+	/// @return True if the search ended by locking on.
+	bool _findShift(const ACE_UINT8* buf, const size_t len, const size_t startOctet);
 
 	/// If true, try to detect the shift/inversion ourselves via finding ASMs.
 	bool _detectShift;
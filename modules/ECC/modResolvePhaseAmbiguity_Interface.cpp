@@ -38,6 +38,8 @@ public:
 	GENERATE_INT_ACCESSORS(usecs_to_wait, setMaxUsecsForNewData, getMaxUsecsForNewData);
 	GENERATE_BOOL_ACCESSORS(detect_shift, setDetectShift, getDetectShift);
 	GENERATE_INT_ACCESSORS(allowed_bit_errors, setAllowedMarkerBitErrors, getAllowedMarkerBitErrors);
+	GENERATE_I8_ACCESSORS(shift_change_count, setShiftChangeCount, getShiftChangeCount);
+	GENERATE_I8_ACCESSORS(marker_miss_count, setMarkerMissCount, getMarkerMissCount);
 	
 	void set_marker(xmlrpc_c::paramList const& paramList, xmlrpc_c::value* retvalP) {
 		ACE_TRACE("modResolvePhaseAmbiguity::set_marker");
@@ -73,6 +75,17 @@ public:
 	void register_methods(xmlrpc_c::registryPtr&);
 	
 protected:
+	void get_counters_(xmlrpc_c::paramList const& paramList, modResolvePhaseAmbiguity* handler,
+		xstruct& counters) {
+		ACE_TRACE("modResolvePhaseAmbiguity_Interface::get_counters_");
+
+		nasaCE::TrafficHandler_Interface<modResolvePhaseAmbiguity>::get_counters_(paramList, handler, counters);
+
+		counters["shiftChangeCount"] = xmlrpc_c::value_i8(handler->getShiftChangeCount());
+		counters["markerMissCount"] = xmlrpc_c::value_i8(handler->getMarkerMissCount());
+		counters["locked"] = xmlrpc_c::value_boolean(handler->isLocked());
+	}
+
 	void get_settings_(xmlrpc_c::paramList const& paramList, modResolvePhaseAmbiguity* handler,
 		xstruct& settings) {
 		ACE_TRACE("modResolvePhaseAmbiguity_Interface::get_settings_");
@@ -113,6 +126,10 @@ GENERATE_ACCESSOR_METHODS(detect_shift, b, "whether to auto detect phase shift/i
 	modResolvePhaseAmbiguity_InterfaceP);
 GENERATE_ACCESSOR_METHODS(allowed_bit_errors, i, "the number of bit errors allowed in an ASM match.",
 	modResolvePhaseAmbiguity_InterfaceP);	
+GENERATE_ACCESSOR_METHODS(shift_change_count, i, "the tally of times detection changed the shift or inversion.",
+	modResolvePhaseAmbiguity_InterfaceP);
+GENERATE_ACCESSOR_METHODS(marker_miss_count, i, "the tally of markers missing where the marker period predicted them.",
+	modResolvePhaseAmbiguity_InterfaceP);
 METHOD_CLASS(set_marker, "n:A", "Sets a new attached sync marker (ASM).", modResolvePhaseAmbiguity_InterfaceP);
 METHOD_CLASS(get_marker, "A:n", "Returns the current attached sync marker (ASM).", modResolvePhaseAmbiguity_InterfaceP);
 	
@@ -125,6 +142,8 @@ void modResolvePhaseAmbiguity_Interface::register_methods(xmlrpc_c::registryPtr&
 	REGISTER_ACCESSOR_METHODS(usecs_to_wait, modResolvePhaseAmbiguity, MaxUsecsForNewData);
 	REGISTER_ACCESSOR_METHODS(detect_shift, modResolvePhaseAmbiguity, DetectShift);	
 	REGISTER_ACCESSOR_METHODS(allowed_bit_errors, modResolvePhaseAmbiguity, AllowedBitErrors);
+	REGISTER_ACCESSOR_METHODS(shift_change_count, modResolvePhaseAmbiguity, ShiftChangeCount);
+	REGISTER_ACCESSOR_METHODS(marker_miss_count, modResolvePhaseAmbiguity, MarkerMissCount);
 	REGISTER_ACCESSOR_METHODS(marker, modResolvePhaseAmbiguity, ASM);	
 }
 
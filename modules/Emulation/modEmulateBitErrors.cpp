@@ -13,8 +13,10 @@
 //=============================================================================
 
 #include "modEmulateBitErrors.hpp"
+#include <ace/Guard_T.h>
 #include <limits>
 #include <cstdlib>
+#include <cmath>
 
 namespace nEmulateBitErrors {
 
@@ -31,7 +33,10 @@ modEmulateBitErrors::modEmulateBitErrors(const std::string& newName, const std::
 	_protectedTrailerBitsSetting(CEcfg::instance()->getOrAddInt(cfgKey("protectedTrailerBits"), _protectedTrailerBits)),
 	_unitsWithErrors(0), _totalErrors(0), _timeLine(0),
 	_timeLineCycleSecs(0.0),
-	_timeLineCycleSecsSetting(CEcfg::instance()->getOrAddFloat(cfgKey("timeLineCycleSecs"), _timeLineCycleSecs)) {
+	_timeLineCycleSecsSetting(CEcfg::instance()->getOrAddFloat(cfgKey("timeLineCycleSecs"), _timeLineCycleSecs)),
+	_useBitErrorRate(false),
+	_useBitErrorRateSetting(CEcfg::instance()->getOrAddBool(cfgKey("useBitErrorRate"), _useBitErrorRate)),
+	_bitsToNextError(0), _gapErrorRate(-1.0) {
 
 	if ( getErrorProbability() > 1.0 ) setErrorProbability(1.0);
 	else if ( getErrorProbability() < 0.0 ) setErrorProbability(0.0);
@@ -40,6 +45,7 @@ modEmulateBitErrors::modEmulateBitErrors(const std::string& newName, const std::
 	_maxErrorsPerUnit = _maxErrorsPerUnitSetting;
 	_protectedHeaderBits = _protectedHeaderBitsSetting;
 	_protectedTrailerBits = _protectedTrailerBitsSetting;
+	_useBitErrorRate = _useBitErrorRateSetting;
 
 	if (CEcfg::instance()->exists(cfgKey("timeLine"))) {
 		Setting& timeLineSetting = CEcfg::instance()->get(cfgKey("timeLine"));
@@ -69,69 +75,112 @@ modEmulateBitErrors::~modEmulateBitErrors()
 }
 
 int modEmulateBitErrors::svc() {
-	svcStart_();
-
-	while ( continueService() ) {
-		std::pair<NetworkData*, int> queueTop = getData_();
+	return transformLoop_();
+}
 
-		if ( msg_queue()->deactivated() ) break;
+NetworkData* modEmulateBitErrors::transformUnit_(NetworkData* data) {
+	MOD_DEBUG("Received %d bytes to possibly introduce bit errors into.", data->getTotalUnitLength());
 
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
-		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
-			continue;
-		}
+	if ( getUseBitErrorRate() ) _injectBitErrorRate(data);
+	else _injectPerUnitErrors(data);
 
-		NetworkData* data = queueTop.first;
+	return data;
+}
 
-		MOD_DEBUG("Received %d bytes to possibly introduce bit errors into.", data->getUnitLength());
+void modEmulateBitErrors::_flipBit(NetworkData* data, const ACE_UINT64 bitIdx) {
+	ACE_UINT64 byteIdx = bitIdx / 8;
 
-		if ( links_[PrimaryOutputLink] ) {
+	// Find the part that holds the octet.
+	while ( byteIdx >= data->getUnitLength() ) {
+		byteIdx -= data->getUnitLength();
+		data = data->getNextPart();
+	}
 
-			bool madeError = false;
+	*(data->ptrUnit() + byteIdx) ^= (0x80 >> (bitIdx % 8));
+}
 
-			for ( int error_tests = 0; error_tests < getMaxErrorsPerUnit(); ++error_tests ) {
+void modEmulateBitErrors::_injectPerUnitErrors(NetworkData* data) {
+	bool madeError = false;
 
-				if ( drand48() <= getErrorProbability() ) {
-					int errorZoneBitLen = ((data->getUnitLength() * 8) - getProtectedHeaderBits()) -
-						getProtectedTrailerBits();
+	for ( int error_tests = 0; error_tests < getMaxErrorsPerUnit(); ++error_tests ) {
 
-					// Randomly select which bit in the buffer to flip.
-					unsigned long bitIdx = (lrand48() % errorZoneBitLen) + getProtectedHeaderBits();
+		if ( drand48() <= getErrorProbability() ) {
+			int errorZoneBitLen = ((data->getTotalUnitLength() * 8) - getProtectedHeaderBits()) -
+				getProtectedTrailerBits();
 
-					// Calculate the octet to place the bit error in.
-					unsigned long byteIdx = bitIdx / 8;
+			// Randomly select which bit in the buffer to flip.
+			unsigned long bitIdx = (lrand48() % errorZoneBitLen) + getProtectedHeaderBits();
 
-					// Calculate the bit within the octet to flip.
-					ACE_UINT8 bitWithinByteIdx = bitIdx % 8;
+			// Calculate the octet to place the bit error in.
+			unsigned long byteIdx = bitIdx / 8;
 
-					MOD_INFO("Flipping bit %d of %d (#%d at octet index %d of %d).", bitIdx,
-						data->getUnitLength()*8, bitWithinByteIdx, byteIdx, data->getUnitLength());
+			// Calculate the bit within the octet to flip.
+			ACE_UINT8 bitWithinByteIdx = bitIdx % 8;
 
-					*(data->ptrUnit() + byteIdx) ^=  (0x80 >> bitWithinByteIdx);
+			MOD_INFO("Flipping bit %d of %d (#%d at octet index %d of %d).", bitIdx,
+				data->getTotalUnitLength()*8, bitWithinByteIdx, byteIdx, data->getTotalUnitLength());
 
-					if ( ! madeError ) {
-						madeError = true;
-						incUnitsWithErrors();
-					}
+			_flipBit(data, bitIdx);
 
-					incTotalErrors();
-				}
+			if ( ! madeError ) {
+				madeError = true;
+				incUnitsWithErrors();
 			}
 
-			links_[PrimaryOutputLink]->send(data);
-		}
-		else {
-			MOD_NOTICE("No output target defined yet, dropping data.");
-			ndSafeRelease(data);
+			incTotalErrors();
 		}
 	}
+}
+
+ACE_UINT64 modEmulateBitErrors::_drawErrorGap(const double ber) {
+	if ( ber <= 0.0 ) return std::numeric_limits<ACE_UINT64>::max();
+	if ( ber >= 1.0 ) return 0;
+
+	// Invert the geometric CDF; 1 - drand48() keeps the log argument in (0, 1].
+	const double gap = std::floor(std::log(1.0 - drand48()) / log1p(-ber));
+
+	return ( gap >= static_cast<double>(std::numeric_limits<ACE_UINT64>::max()) )?
+		std::numeric_limits<ACE_UINT64>::max() : static_cast<ACE_UINT64>(gap);
+}
+
+void modEmulateBitErrors::_injectBitErrorRate(NetworkData* data) {
+	const long errorZoneBitLen = (static_cast<long>(data->getTotalUnitLength()) * 8 - getProtectedHeaderBits()) -
+		getProtectedTrailerBits();
+
+	if ( errorZoneBitLen <= 0 ) return;
+
+	ACE_Guard<ACE_Thread_Mutex> guard(_gapLock);
+
+	// Gaps are memoryless, so when the time line changes the BER a new one can be drawn right here.
+	const double ber = getErrorProbability();
+	if ( ber != _gapErrorRate ) {
+		_bitsToNextError = _drawErrorGap(ber);
+		_gapErrorRate = ber;
+	}
+
+	// The max errors per unit doesn't apply here; a cap would lower the delivered BER.
+	const ACE_UINT64 zoneLen = static_cast<ACE_UINT64>(errorZoneBitLen);
+	ACE_UINT64 pos = 0;
+	int errorCount = 0;
+
+	while ( _bitsToNextError < zoneLen - pos ) {
+		pos += _bitsToNextError;
+
+		const ACE_UINT64 bitIdx = pos + getProtectedHeaderBits();
+
+		MOD_DEBUG("Flipping bit %d of %d.", static_cast<int>(bitIdx), data->getTotalUnitLength() * 8);
+		_flipBit(data, bitIdx);
+
+		++errorCount;
+		incTotalErrors();
+
+		++pos;
+		_bitsToNextError = _drawErrorGap(ber);
+	}
 
-	return svcEnd_();
+	_bitsToNextError -= zoneLen - pos;
 
+	if ( errorCount ) incUnitsWithErrors();
 }
 
 void modEmulateBitErrors::setErrorProbability(const double& newBer,
@@ -19,6 +19,8 @@
 #include "TimeLine.hpp"
 #include "Time_Handler.hpp"
 
+#include <ace/Thread_Mutex.h>
+
 namespace nEmulateBitErrors {
 
 typedef std::pair<double, int> ErrRateAndMaxT;
@@ -46,6 +48,12 @@ public:
 	/// Reads in data, possibly introduces error(s), and sends it to the output handler.
 	int svc();
 
+	/// Each unit is corrupted on its own; in bit error rate mode only the gap carries over, under a lock.
+	bool supportsInline() const { return true; }
+
+	/// Bits are flipped in whichever part of a chained unit they fall in.
+	bool acceptsChainedUnits() const { return true; }
+
 	/// Read-only accessor to _errorProbability.
 	double getErrorProbability() const {
 		return ( _timeLine ) ?
@@ -121,6 +129,16 @@ public:
 	/// Read-only accessor to _protectedTrailerBits.
 	int getProtectedTrailerBits() const { return _protectedTrailerBits; }
 
+	/// Write-only accessor to _useBitErrorRate and _useBitErrorRateSetting.
+	/// When set, the max errors per unit is ignored.
+	void setUseBitErrorRate(const bool newVal) {
+		_useBitErrorRate = newVal;
+		_useBitErrorRateSetting = newVal;
+	}
+
+	/// Read-only accessor to _useBitErrorRate.
+	bool getUseBitErrorRate() const { return _useBitErrorRate; }
+
 	/// Read-only accessor to _timeLineCycleSecs.
 	double getTimeLineCycleSecs() const { return _timeLineCycleSecs; }
 
@@ -136,10 +154,14 @@ public:
 	/// Erase the delay time line and only use _delaySeconds.
 	void clearTimeLine();
 
+protected:
+	/// Possibly flip some bits in the unit, in place.
+	NetworkData* transformUnit_(NetworkData* data);
+
 private:
 
 	/// Double-precision floating point value between 0.0 and 1.0 that determines the chance
-	/// for each data unit to have errors.
+	/// for each data unit to have errors, or for each bit if _useBitErrorRate is set.
 	double _errorProbability;
 
 	/// Config file reference to _errorProbability.
@@ -177,6 +199,40 @@ private:
 
 	/// Config file reference to _timeLineCycleLen.
 	Setting& _timeLineCycleSecsSetting;
+
+	/// If true, the error probability applies to each bit instead of to each check of a unit.
+	bool _useBitErrorRate;
+
+	/// Config file reference to _useBitErrorRate.
+	Setting& _useBitErrorRateSetting;
+
+	/// In bit error rate mode, the unprotected bits left to pass before the next error.
+	/// Carries over from one unit to the next.
+	ACE_UINT64 _bitsToNextError;
+
+	/// The bit error rate that _bitsToNextError was drawn with; negative if none was drawn yet.
+	double _gapErrorRate;
+
+	/// Guards _bitsToNextError and _gapErrorRate, since units may arrive on more than one thread.
+	ACE_Thread_Mutex _gapLock;
+
+	/// @brief Pick the number of error-free bits before the next error.
+	/// The gaps between independent bit errors are geometrically distributed.
+	/// @param ber The probability that any one bit is in error.
+	static ACE_UINT64 _drawErrorGap(const double ber);
+
+	/// @brief Flip one bit of the unit, counting from the start of its first part.
+	/// @param data The unit, which may be made of several parts.
+	/// @param bitIdx The bit to flip, which must be within the total unit length.
+	static void _flipBit(NetworkData* data, const ACE_UINT64 bitIdx);
+
+	/// Do up to getMaxErrorsPerUnit() checks with the error probability, one bit flipped per hit.
+	void _injectPerUnitErrors(NetworkData* data);
+
+	/// Flip bits wherever the gaps fall, treating the unprotected bits of all units as one stream.
+	/// There is no limit on the errors per unit.
+	void _injectBitErrorRate(NetworkData* data);
+
 }; // class modEmulateBitErrors
 
 } // namespace nEmulateBitErrors
@@ -129,6 +129,7 @@ public:
 	GENERATE_INT_ACCESSORS(protected_trailer_bits, setProtectedTrailerBits, getProtectedTrailerBits);
 	GENERATE_INT_ACCESSORS(total_errors, setTotalErrors, getTotalErrors);
 	GENERATE_FLOAT_ACCESSORS(timeline_cycle_secs, setTimeLineCycleSecs, getTimeLineCycleSecs);
+	GENERATE_BOOL_ACCESSORS(use_bit_error_rate, setUseBitErrorRate, getUseBitErrorRate);
 
 	/// Export specified methods via XML-RPC.
 	void register_methods(xmlrpc_c::registryPtr&);
@@ -157,6 +158,7 @@ protected:
 		settings["protectedHeaderBits"] = xmlrpc_c::value_int(handler->getProtectedHeaderBits());
 		settings["protectedTrailerBits"] = xmlrpc_c::value_int(handler->getProtectedTrailerBits());
 		settings["timeLineCycleSecs"] = xmlrpc_c::value_double(handler->getTimeLineCycleSecs());
+		settings["useBitErrorRate"] = xmlrpc_c::value_boolean(handler->getUseBitErrorRate());
 	}
 };
 
@@ -186,6 +188,8 @@ GENERATE_ACCESSOR_METHODS(total_errors, i, "the tally of all errors introduced,
 	modEmulateBitErrors_InterfaceP);
 GENERATE_ACCESSOR_METHODS(timeline_cycle_secs, d, "the number of seconds before the time line begins to repeat.",
 	modEmulateBitErrors_InterfaceP);
+GENERATE_ACCESSOR_METHODS(use_bit_error_rate, b, "whether the error probability applies to each bit of a continuous stream.",
+	modEmulateBitErrors_InterfaceP);
 
 void modEmulateBitErrors_Interface::register_methods(xmlrpc_c::registryPtr& rpcRegistry) {
 	ACE_TRACE("modEmulateBitErrors_Interface::register_methods");
@@ -199,6 +203,7 @@ void modEmulateBitErrors_Interface::register_methods(xmlrpc_c::registryPtr& rpcR
 	REGISTER_ACCESSOR_METHODS(protected_trailer_bits, modEmulateBitErrors, ProtectedTrailerBits);
 	REGISTER_ACCESSOR_METHODS(total_errors, modEmulateBitErrors, TotalErrors);
 	REGISTER_ACCESSOR_METHODS(timeline_cycle_secs, modEmulateBitErrors, TimeLineCycleSecs);
+	REGISTER_ACCESSOR_METHODS(use_bit_error_rate, modEmulateBitErrors, UseBitErrorRate);
 }
 
 } // namespace nEmulateBitErrors
\ No newline at end of file
@@ -39,6 +39,9 @@ modEmulateDelay::modEmulateDelay(const std::string& newName, const std::string&
 	_timeLineCycleSecs(0.0),
 	_timeLineCycleSecsSetting(CEcfg::instance()->getOrAddFloat(cfgKey("timeLineCycleSecs"), _timeLineCycleSecs)) {
 
+	// Jittered units may be reordered by deadline, which a ring can't do.
+	useRingQueue_(false);
+
 	_delaySeconds = ( static_cast<double>(_delaySecondsSetting) < 0.0 )? 0.0 : _delaySecondsSetting;
 	_jitterSeconds = ( static_cast<double>(_jitterSecondsSetting) < 0.0 )? 0.0 : _jitterSecondsSetting;
 	setAllowJitterReorder(_allowJitterReorderSetting);
@@ -166,7 +169,7 @@ int modEmulateDelay::putData(NetworkData* data,
 	MOD_DEBUG("Generating delay of %d.%ds for %d-octet %s.",
 		delaySecs.sec(), delaySecs.usec(), data->getUnitLength(), data->typeStr().c_str());
 
-	ACE_Time_Value sendTime((getUseTimeStamp()? data->getTimeStamp() : ACE_High_Res_Timer::gettimeofday_hr()) +
+	ACE_Time_Value sendTime((getUseTimeStamp()? data->getTimeStamp() : ClockService::instance()->preciseNow()) +
 		delaySecs);
 
 	mblk->msg_deadline_time(sendTime);
@@ -196,7 +199,7 @@ std::pair<NetworkData*, int> modEmulateDelay::getData_(
 	if (mblk) {
 		data = dynamic_cast<NetworkData*>(mblk);
 
-		ACE_Time_Value sleepSecs = mblk->msg_deadline_time() - ACE_High_Res_Timer::gettimeofday_hr();
+		ACE_Time_Value sleepSecs = mblk->msg_deadline_time() - ClockService::instance()->preciseNow();
 		MOD_DEBUG("Sleeping %d.%ds before sending this %s unit (deadline is %d.%d).",
 			sleepSecs.sec(), sleepSecs.usec(), data->typeStr().c_str(),
 			mblk->msg_deadline_time().sec(), mblk->msg_deadline_time().usec());
@@ -68,7 +68,7 @@ int modEmulatePhaseAmbiguity::svc() {
 		MOD_DEBUG("Received %d octets to shift and/or invert.", incomingBlockLen);
 
 		if ( incomingBlockLen && links_[PrimaryOutputLink] ) {
-			NetworkData* shifted = new NetworkData(incomingBlockLen + 1);
+			NetworkData* shifted = new NetworkData(incomingBlockLen + 1, NetworkData::noFill);
 			MOD_DEBUG("Created %d octet buffer to shift into.", shifted->getUnitLength());
 
 			ACE_UINT8 rightShiftBits = 8 - _leftShiftBits;
@@ -109,7 +109,7 @@ private:
 	
 	/// Add _waitForNewDataInterval to the current time.
 	ACE_Time_Value _getWaitUntilTime() const {
-		return ACE_High_Res_Timer::gettimeofday_hr() + _waitForNewDataInterval;
+		return ClockService::instance()->preciseNow() + _waitForNewDataInterval;
 	}
 
 }; // class modEmulatePhaseAmbiguity
@@ -91,17 +91,32 @@ int modEthFrame_Add::svc() {
 					MOD_ERROR("Ethernet frame header template does not exist, closing service loop.");
 					break;
 				}
+				EthernetFrame* frame;
+
+				// Must be determined before the payload gains a header.
+				const ACE_UINT16 payloadType = payload->enetType();
+
 				_frameHeaderCreation.acquire();
 
-				// Allocate configured frame type.
-				EthernetFrame* frame = new EthernetFrame(_frameHeader->getUnitLength() + payload->getUnitLength(),
-					getFrameType(), EthernetFrame::typeNormalLen);
+				if ( payload->prependInPlace(_frameHeader->ptrUnit(), _frameHeader->getUnitLength()) ) {
+					_frameHeaderCreation.release();
 
-				frame->copyUnit(frame->ptrUnit(), _frameHeader);
+					// The header went into reserved headroom, so the payload is already in place.
+					frame = new EthernetFrame(payload, false, 0, payload->getUnitLength(),
+						getFrameType(), EthernetFrame::typeNormalLen);
+					frame->setEtherType(payloadType);
+				}
+				else {
+					// Allocate configured frame type.
+					frame = new EthernetFrame(_frameHeader->getUnitLength() + payload->getUnitLength(),
+						getFrameType(), EthernetFrame::typeNormalLen);
 
-				_frameHeaderCreation.release();
+					frame->copyUnit(frame->ptrUnit(), _frameHeader);
 
-				frame->setPayload(payload);
+					_frameHeaderCreation.release();
+
+					frame->setPayload(payload);
+				}
 
 				// If defaultPayloadType setting > 0, use that instead of the length parameter
 				if ( frame->getEtherType() <= 1500 && getDefaultPayloadType() )
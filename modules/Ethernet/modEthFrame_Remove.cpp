@@ -31,81 +31,60 @@ modEthFrame_Remove::~modEthFrame_Remove() {
 
 
 int modEthFrame_Remove::svc() {
-	svcStart_();
-
-	while ( continueService() ) {
-		std::pair<NetworkData*, int> queueTop = getData_();
-		if ( msg_queue()->deactivated() ) break;
-
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
-		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
-			continue;
-		}
-
-		EthernetFrame* frame = dynamic_cast<EthernetFrame*>(queueTop.first);
-
-		if ( ! frame ) {
-			MOD_DEBUG("Received data (%s) that was not an Ethernet frame.", queueTop.first->typeStr().c_str());
-			ndSafeRelease(queueTop.first);
-			queueTop.first = 0;
-			continue;
-		}
-
-		MOD_DEBUG("Received a %d-octet Ethernet Frame.", frame->getUnitLength());
-
-		if ( links_[PrimaryOutputLink] ) {
-			NetworkData* payload = 0;
-
-			switch ( frame->getEtherType() ) {
-				case EthernetFrame::Eth_IPv4:
-					MOD_DEBUG("Frame contains an IPv4 Packet.");
-					payload = frame->wrapInnerPDU<IPv4Packet>();
-
-					if (dynamic_cast<IPv4Packet*>(payload)->getProtocol() == IPv4Packet::UDP) {
-						payload->release();
-						MOD_DEBUG("Packet is an IPv4 UDP datagram.");
-						payload = frame->wrapInnerPDU<IPv4_UDP_Datagram>();
-					}
-					#ifdef DEFINE_DEBUG
-					else if (dynamic_cast<IPv4Packet*>(payload)->getProtocol() == IPv4Packet::TCP) {
-						MOD_DEBUG("Packet is an IPv4 TCP packet.");
-					}
-					else if (dynamic_cast<IPv4Packet*>(payload)->getProtocol() == IPv4Packet::ICMP) {
-						MOD_DEBUG("Packet is an IPv4 ICMP packet.");
-					}
-					else { MOD_DEBUG("Packet is an unrecognized IPv4 type."); }
-					#endif
-					break;
-				case EthernetFrame::Eth_ARP:
-					MOD_DEBUG("Frame contains an ARP Packet.");
-					payload = frame->wrapInnerPDU<ArpPacket>();
-					break;
-				case EthernetFrame::Eth_AOS:
-					MOD_DEBUG("Frame contains an AOS Transfer Frame.");
-					payload = frame->wrapInnerPDU<AOS_Transfer_Frame>();
-					break;
-				default:
-					MOD_DEBUG("Frame contains unrecognized data type.");
-					payload = frame->wrapInnerPDU<NetworkData>();
-					break;
-			}
+	return transformLoop_();
+}
+
+NetworkData* modEthFrame_Remove::transformUnit_(NetworkData* data) {
+	EthernetFrame* frame = dynamic_cast<EthernetFrame*>(data);
+
+	if ( ! frame ) {
+		MOD_DEBUG("Received data (%s) that was not an Ethernet frame.", data->typeStr().c_str());
+		ndSafeRelease(data);
+		return 0;
+	}
 
-			MOD_DEBUG("Sending %d octets.", payload->getUnitLength());
-			links_[PrimaryOutputLink]->send(payload);
-		}
-		else {
-			MOD_NOTICE("No output target defined yet, dropping data.");
-		}
+	MOD_DEBUG("Received a %d-octet Ethernet Frame.", frame->getUnitLength());
 
-		ndSafeRelease(frame);
+	NetworkData* payload = 0;
 
+	switch ( frame->getEtherType() ) {
+		case EthernetFrame::Eth_IPv4:
+			MOD_DEBUG("Frame contains an IPv4 Packet.");
+			payload = frame->wrapInnerPDU<IPv4Packet>();
+
+			if (dynamic_cast<IPv4Packet*>(payload)->getProtocol() == IPv4Packet::UDP) {
+				payload->release();
+				MOD_DEBUG("Packet is an IPv4 UDP datagram.");
+				payload = frame->wrapInnerPDU<IPv4_UDP_Datagram>();
+			}
+			#ifdef DEFINE_DEBUG
+			else if (dynamic_cast<IPv4Packet*>(payload)->getProtocol() == IPv4Packet::TCP) {
+				MOD_DEBUG("Packet is an IPv4 TCP packet.");
+			}
+			else if (dynamic_cast<IPv4Packet*>(payload)->getProtocol() == IPv4Packet::ICMP) {
+				MOD_DEBUG("Packet is an IPv4 ICMP packet.");
+			}
+			else { MOD_DEBUG("Packet is an unrecognized IPv4 type."); }
+			#endif
+			break;
+		case EthernetFrame::Eth_ARP:
+			MOD_DEBUG("Frame contains an ARP Packet.");
+			payload = frame->wrapInnerPDU<ArpPacket>();
+			break;
+		case EthernetFrame::Eth_AOS:
+			MOD_DEBUG("Frame contains an AOS Transfer Frame.");
+			payload = frame->wrapInnerPDU<AOS_Transfer_Frame>();
+			break;
+		default:
+			MOD_DEBUG("Frame contains unrecognized data type.");
+			payload = frame->wrapInnerPDU<NetworkData>();
+			break;
 	}
 
-	return svcEnd_();
+	ndSafeRelease(frame);
+
+	MOD_DEBUG("Sending %d octets.", payload->getUnitLength());
+	return payload;
 }
 
 } // namespace nEthFrame_Remove
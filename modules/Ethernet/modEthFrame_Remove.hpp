@@ -38,6 +38,9 @@ public:
 
 	/// Read in Ethernet Frames, extract the payload, and send it on.
 	int svc();
+
+	/// Each frame is unwrapped on its own.
+	bool supportsInline() const { return true; }
 	
 	/// Return the string version of the provided frame type.
 	/// @param frameType One of PCap, LinuxTap, IEEE.
@@ -66,6 +69,10 @@ public:
 		return frameType2Str(_frameType);
 	}	
 
+protected:
+	/// Replace the frame with a wrapper around its payload.
+	NetworkData* transformUnit_(NetworkData* data);
+
 private:
 	/// The type of EthernetFrame we should expect to receive.
 	EthernetFrame::SupportedFrameTypes _frameType;
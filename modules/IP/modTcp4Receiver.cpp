@@ -70,7 +70,8 @@ int modTcp4Receiver::handle_input(ACE_HANDLE fd /* = ACE_INVALID_HANDLE */) {
 			incReceivedOctetCount(receivedOctets, HandlerLink::PrimaryInput);
 
 			if ( links_[PrimaryOutputLink] ) {
-				NetworkData* data = new NetworkData(receivedOctets, _buffer);
+				NetworkData* data = new NetworkData(receivedOctets, _buffer,
+					getReservedHeadroom(), getReservedTailroom());
 				links_[PrimaryOutputLink]->send(data);
 			}
 			else {
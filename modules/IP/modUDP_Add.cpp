@@ -66,8 +66,19 @@ int modUDP_Add::svc() {
 		MOD_DEBUG("Received %d bytes to make into a UDP datagram.", data->getUnitLength());
 
 		if ( links_[PrimaryOutputLink] ) {
-			IPv4_UDP_Datagram* dgm = new IPv4_UDP_Datagram(_dgmHeader);
-			dgm->setData(data);
+			IPv4_UDP_Datagram* dgm;
+
+			if ( data->prependInPlace(_dgmHeader->ptrUnit(), _dgmHeader->getHeaderLength()) ) {
+				// The headers went into reserved headroom; only the lengths need updating.
+				dgm = data->wrapOuterPDU<IPv4_UDP_Datagram>();
+				dgm->setTotalLength(dgm->getUnitLength());
+				dgm->setUDPLength(dgm->getUnitLength() - dgm->IPv4Packet::getHeaderLength());
+			}
+			else {
+				dgm = new IPv4_UDP_Datagram(_dgmHeader);
+				dgm->setData(data);
+			}
+
 			dgm->setChecksum(dgm->computeChecksum());
 			if (isComputingCRC()) dgm->setUDPChecksum(dgm->computeUDPChecksum());
 
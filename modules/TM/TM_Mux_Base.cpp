@@ -25,6 +25,9 @@ TM_Mux_Base::TM_Mux_Base(const std::string& newName, const std::string& newChann
 		defaultPriority_(CEcfg::instance()->getOrAddInt(cfgKey("defaultMuxPriority"), 1000)),
 		priorities_(CEcfg::instance()->getOrAddList(cfgKey("channelID_Priorities"))) {
 
+	// Many inputs feed one queue in priority order, which a ring can't do.
+	useRingQueue_(false);
+
 	rebuildIdleUnitTemplate_();
 }
 
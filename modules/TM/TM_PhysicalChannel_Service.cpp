@@ -30,6 +30,8 @@ TM_PhysicalChannel_Service::TM_PhysicalChannel_Service(const std::string& newNam
 	// Update if it was set in the config file.
 	_dropBadFrames = _dropBadFramesSetting;
 
+	registerFrameSize_();
+
 	if ( idlePattern_.getLength() == 0 ) {
 		uint8_t defaultPattern[] = { 0xAA, 0xBB, 0xCC };
 		setIdlePattern(defaultPattern, 3);
@@ -44,8 +44,8 @@ public:
 	/// Destructor
     virtual ~TM_PhysicalChannel_Service();
 
-	/// Write-only accessor to _frameSize.
-	void setFrameSize(const int newVal) { _frameSize = newVal; rebuildPersistentUnits_(); }
+	/// Write-only accessor to _frameSize. Also registers the frame buffer size with the NetworkData buffer pool.
+	void setFrameSize(const int newVal) { _frameSize = newVal; registerFrameSize_(); rebuildPersistentUnits_(); }
 
 	/// Read-only accessor to _frameSize.
 	ssize_t getFrameSize() const { return _frameSize; }
@@ -140,6 +140,12 @@ public:
 
 protected:
 
+	/// Register the size of a frame buffer, with the channel's reserved room, as a NetworkData buffer pool size class.
+	void registerFrameSize_() {
+		if ( getFrameSize() > 0 )
+			NetworkDataPool::instance()->addSizeClass(getReservedHeadroom() + getFrameSizeU() + getReservedTailroom());
+	}
+
 	/// When settings change that affect the structure of the transfer frame, rebuild
 	/// the templates that can be stored by subclasses.
 	virtual void rebuildPersistentUnits_() { updateTemplate_(); rebuildIdleUnitTemplate_(); }
@@ -35,50 +35,58 @@ int modTM_MC_Demux::svc() {
 
 	TM_Transfer_Frame* frame = 0;
 	HandlerLinkMap::iterator outputLink;
+	std::vector<NetworkData*> batch;
+	HandlerLinkBatch outputs;
 
 	while ( continueService() ) {
-		ndSafeRelease(frame);
-
-		std::pair<NetworkData*, int> queueTop = getData_();
-
-		if ( msg_queue()->deactivated() ) break;
+		const int queued = getDataBatch_(batch, getMaxBatchUnits());
 
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
+		if ( msg_queue()->deactivated() ) {
+			releaseBatch_(batch);
+			break;
 		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
+
+		if ( queued < 0 ) {
+			MOD_ERROR("getDataBatch_() call failed.");
 			continue;
 		}
 
-		frame = dynamic_cast<TM_Transfer_Frame*>(queueTop.first);
+		for ( size_t idx = 0; idx < batch.size(); ++idx ) {
+			ndSafeRelease(frame);
 
-		if ( !frame ) {
-			MOD_ERROR("Received %d-octet buffer in %s wrapper (not TM_Transfer_Frame)! Must discard.",
-				queueTop.first->getUnitLength(), queueTop.first->typeStr().c_str());
-			ndSafeRelease(queueTop.first);
-			continue;
-		}
+			frame = dynamic_cast<TM_Transfer_Frame*>(batch[idx]);
 
-		MOD_DEBUG("Received %d octets to demultiplex.", frame->getTotalUnitLength());
+			if ( !frame ) {
+				MOD_ERROR("Received %d-octet buffer in %s wrapper (not TM_Transfer_Frame)! Must discard.",
+					batch[idx]->getUnitLength(), batch[idx]->typeStr().c_str());
+				ndSafeRelease(batch[idx]);
+				continue;
+			}
 
-		// Test expected values.
-		if ( ! validateFrame(frame) ) {
-			if ( getDropBadFrames() ) continue;
-		}
-		else incValidFrameCount();
+			MOD_DEBUG("Received %d octets to demultiplex.", frame->getTotalUnitLength());
 
-		if ( ( outputLink = primaryOutputLinks_.find(frame->getMCID())) != primaryOutputLinks_.end() ) {
+			// Test expected values.
+			if ( ! validateFrame(frame) ) {
+				if ( getDropBadFrames() ) continue;
+			}
+			else incValidFrameCount();
 
-			MOD_DEBUG("Sending %d octets.", frame->getTotalUnitLength());
+			if ( ( outputLink = primaryOutputLinks_.find(frame->getMCID())) != primaryOutputLinks_.end() ) {
 
-			outputLink->second->send(frame);
-			frame = 0; // important
-		}
-		else {
-			MOD_NOTICE("No output target defined for MCID %d, dropping data.", frame->getMCID());
+				MOD_DEBUG("Sending %d octets.", frame->getTotalUnitLength());
+
+				outputs.add(outputLink->second, frame);
+				frame = 0; // important
+			}
+			else {
+				MOD_NOTICE("No output target defined for MCID %d, dropping data.", frame->getMCID());
+			}
 		}
+
+		// Release the last unit if it was dropped, and pass on what's pending.
+		ndSafeRelease(frame);
+		batch.clear();
+		outputs.flush();
 	}
 
 	return svcEnd_();
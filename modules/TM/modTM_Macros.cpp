@@ -22,14 +22,14 @@ namespace nTM_Macros {
 
 newTMChannelProps::newTMChannelProps(): frameLength(256), packetSvcCount(1),
 	vcAccessSvcCount(0), vcFrameSvcCount(1), mcFrameSvcCount(1),masterChannelCount(1), maxErrorsReedSolomon(8),
-	useFrameEC(false), useASM(true), usePseudoRandomize(true), minimize(false),
+	useFrameEC(false), useASM(true), usePseudoRandomize(true), fuseCoding(false), minimize(false),
 	segNamePrefix(""), segNameSuffix("") {
 
 }
 
 newTMChannelProps::newTMChannelProps(const xmlrpc_c::value_struct& settingsStruct): frameLength(256),
 	packetSvcCount(0), vcAccessSvcCount(0), vcFrameSvcCount(0), mcFrameSvcCount(0), masterChannelCount(1),
-	maxErrorsReedSolomon(0), 	useFrameEC(false), useASM(true), usePseudoRandomize(true), minimize(false),
+	maxErrorsReedSolomon(0), 	useFrameEC(false), useASM(true), usePseudoRandomize(true), fuseCoding(false), minimize(false),
 	segNamePrefix(""), segNameSuffix("") {
 
 	const xstruct settingsMap(settingsStruct);
@@ -46,6 +46,7 @@ newTMChannelProps::newTMChannelProps(const xmlrpc_c::value_struct& settingsStruc
 		else if (pos->first == "useFrameEC") useFrameEC = xmlrpc_c::value_boolean(pos->second);
 		else if (pos->first == "useASM") useASM = xmlrpc_c::value_boolean(pos->second);
 		else if (pos->first == "usePseudoRandomize") usePseudoRandomize = xmlrpc_c::value_boolean(pos->second);
+		else if (pos->first == "fuseCoding") fuseCoding = xmlrpc_c::value_boolean(pos->second);
 		else if (pos->first == "minimize") minimize = xmlrpc_c::value_boolean(pos->second);
 		else if (pos->first == "segNamePrefix") segNamePrefix = xmlrpc_c::value_string(pos->second);
 		else if (pos->first == "segNameSuffix") segNameSuffix = xmlrpc_c::value_string(pos->second);
@@ -164,40 +165,68 @@ void modTM_Macros::newForwardChannel(const std::string& channelName, const newTM
 	// Build the channel starting at the end of the stream so that segments
 	// have something to output to.
 
-	if ( props.useASM ) {
-		// Insert modASM_Add
-		segName = _getUniqueSegName(channel, props.makeSegName("asmAdd"));
-		dllName = "modASM_Add";
+	const bool useRS = ( props.maxErrorsReedSolomon == 8 || props.maxErrorsReedSolomon == 16 );
+
+	if ( props.fuseCoding && props.useASM && ( useRS || props.usePseudoRandomize ) ) {
+		// Insert modCADU_Gen in place of modASM_Add, modPseudoRandomize, and modRSEncode
+		segName = _getUniqueSegName(channel, props.makeSegName("caduGen"));
+		dllName = "modCADU_Gen";
+		const size_t maxErrorsPerCodeWord(useRS? props.maxErrorsReedSolomon : 0);
+		const size_t interleavingDepth(ceil(static_cast<double>(props.frameLength) / static_cast<double>((255 - (2 * maxErrorsPerCodeWord)))));
 		_addBasicSettings(channelPath, dllName, segName);
-		channel->add(dllName, segName);
-		lastSegName = segName;
-	}
+		CEcfg::instance()->getOrAddBool(channelPath + "." + segName + ".randomize", props.usePseudoRandomize);
+		CEcfg::instance()->getOrAddInt(channelPath + "." + segName + ".maxErrorsPerCodeword", maxErrorsPerCodeWord);
+		if ( useRS ) {
+			ND_INFO("[modTM_Macros] Calculated %d as the interleaving depth for RS(255, %d) with TM Transfer Frame length of %d.\n",
+					interleavingDepth, 255 - 2 * maxErrorsPerCodeWord, props.frameLength);
+			CEcfg::instance()->getOrAddInt(channelPath + "." + segName + ".interleavingDepth", interleavingDepth);
+		}
 
-	if ( props.usePseudoRandomize ) {
-		// Insert modPseudoRandomize
-		segName = _getUniqueSegName(channel, props.makeSegName("randomize"));
+		// Have the frame generators leave room for the ASM and the parity, so CADUs are built in place.
+		// modCADU_Gen attaches the 4-octet CCSDS ASM if no pattern is configured.
+		const int markerLen(CEcfg::instance()->getOrAddArray(channelPath + "." + segName + ".markerPattern").getLength());
+		CEcfg::instance()->getOrAddInt(channelPath + ".reservedHeadroom", markerLen? markerLen : 4);
+		CEcfg::instance()->getOrAddInt(channelPath + ".reservedTailroom", interleavingDepth * maxErrorsPerCodeWord * 2);
 
-		dllName = "modPseudoRandomize";
-		_addBasicSettings(channelPath, dllName, segName);
-		_addPrimaryOutput(channelPath, segName, lastSegName);
 		channel->add(dllName, segName);
 		lastSegName = segName;
 	}
+	else {
+		if ( props.useASM ) {
+			// Insert modASM_Add
+			segName = _getUniqueSegName(channel, props.makeSegName("asmAdd"));
+			dllName = "modASM_Add";
+			_addBasicSettings(channelPath, dllName, segName);
+			channel->add(dllName, segName);
+			lastSegName = segName;
+		}
 
-	if ( props.maxErrorsReedSolomon == 8 || props.maxErrorsReedSolomon == 16) {
-		// Insert modRSEncode
-		segName = _getUniqueSegName(channel, props.makeSegName("rsEncode"));
-		dllName = "modRSEncode";
-		const size_t maxErrorsPerCodeWord(props.maxErrorsReedSolomon);
-		const size_t interleavingDepth(ceil(static_cast<double>(props.frameLength) / static_cast<double>((255 - (2 * maxErrorsPerCodeWord)))));
-		ND_INFO("[modTM_Macros] Calculated %d as the interleaving depth for RS(255, %d) with TM Transfer Frame length of %d.\n",
-				interleavingDepth, 255 - 2 * maxErrorsPerCodeWord, props.frameLength);
-		_addBasicSettings(channelPath, dllName, segName);
-		CEcfg::instance()->getOrAddInt(channelPath + "." + segName + ".maxErrorsPerCodeword", maxErrorsPerCodeWord);
-		CEcfg::instance()->getOrAddInt(channelPath + "." + segName + ".interleavingDepth", interleavingDepth);
-		if ( props.useASM ) _addPrimaryOutput(channelPath, segName, lastSegName);
-		channel->add(dllName, segName);
-		lastSegName = segName;
+		if ( props.usePseudoRandomize ) {
+			// Insert modPseudoRandomize
+			segName = _getUniqueSegName(channel, props.makeSegName("randomize"));
+
+			dllName = "modPseudoRandomize";
+			_addBasicSettings(channelPath, dllName, segName);
+			_addPrimaryOutput(channelPath, segName, lastSegName);
+			channel->add(dllName, segName);
+			lastSegName = segName;
+		}
+
+		if ( useRS ) {
+			// Insert modRSEncode
+			segName = _getUniqueSegName(channel, props.makeSegName("rsEncode"));
+			dllName = "modRSEncode";
+			const size_t maxErrorsPerCodeWord(props.maxErrorsReedSolomon);
+			const size_t interleavingDepth(ceil(static_cast<double>(props.frameLength) / static_cast<double>((255 - (2 * maxErrorsPerCodeWord)))));
+			ND_INFO("[modTM_Macros] Calculated %d as the interleaving depth for RS(255, %d) with TM Transfer Frame length of %d.\n",
+					interleavingDepth, 255 - 2 * maxErrorsPerCodeWord, props.frameLength);
+			_addBasicSettings(channelPath, dllName, segName);
+			CEcfg::instance()->getOrAddInt(channelPath + "." + segName + ".maxErrorsPerCodeword", maxErrorsPerCodeWord);
+			CEcfg::instance()->getOrAddInt(channelPath + "." + segName + ".interleavingDepth", interleavingDepth);
+			if ( props.useASM ) _addPrimaryOutput(channelPath, segName, lastSegName);
+			channel->add(dllName, segName);
+			lastSegName = segName;
+		}
 	}
 
 	// Insert modTM_AF_Gen
@@ -378,8 +407,31 @@ void modTM_Macros::newReturnChannel(const std::string& channelName, const newTMC
 
 	const size_t maxErrorsPerCodeWord(props.maxErrorsReedSolomon);
 	const size_t interleavingDepth(ceil(static_cast<double>(props.frameLength) / static_cast<double>((255 - (2 * maxErrorsPerCodeWord)))));
+	const bool useRS = ( props.maxErrorsReedSolomon == 8 || props.maxErrorsReedSolomon == 16 );
+
+	if ( props.fuseCoding && props.useASM && ( useRS || props.usePseudoRandomize ) ) {
+		// Insert modCADU_Rcv in place of modRSDecode, modPseudoRandomize, and modASM_Remove
+		segName = _getUniqueSegName(channel, props.makeSegName("caduRcv"));
+
+		dllName = "modCADU_Rcv";
+		_addBasicSettings(channelPath, dllName, segName);
+		const size_t expectedUnitLength = props.frameLength + ( useRS? interleavingDepth * maxErrorsPerCodeWord * 2 : 0 );
+		CEcfg::instance()->getOrAddInt(channelPath + "." + segName + ".expectedUnitLength", expectedUnitLength);
+		CEcfg::instance()->getOrAddBool(channelPath + "." + segName + ".derandomize", props.usePseudoRandomize);
+		CEcfg::instance()->getOrAddInt(channelPath + "." + segName + ".maxErrorsPerCodeword", useRS? maxErrorsPerCodeWord : 0);
+		if ( useRS ) {
+			ND_INFO("[modTM_Macros] Calculated %d as the interleaving depth for RS(255, %d) with TM Transfer Frame length of %d.\n",
+					interleavingDepth, 255 - 2 * maxErrorsPerCodeWord, props.frameLength);
+			CEcfg::instance()->getOrAddInt(channelPath + "." + segName + ".interleavingDepth", interleavingDepth);
+		}
+		ND_INFO("[modTM_Macros] CADU receive segment will expect unit length to be %d.\n", expectedUnitLength);
+
+		_addPrimaryOutput(channelPath, segName, lastSegName);
+		channel->add(dllName, segName);
+		return;
+	}
 
-	if ( props.maxErrorsReedSolomon == 8 || props.maxErrorsReedSolomon == 16 ) {
+	if ( useRS ) {
 		// Insert modRSDecode
 		segName = _getUniqueSegName(channel, props.makeSegName("rsDecode"));
 		dllName = "modRSDecode";
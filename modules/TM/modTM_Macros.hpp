@@ -42,6 +42,7 @@ public:
 	bool useFrameEC;
 	bool useASM;
 	bool usePseudoRandomize;
+	bool fuseCoding;
 	bool minimize; // If true, don't insert unnecessary modules
 	std::string segNamePrefix;
 	std::string segNameSuffix;
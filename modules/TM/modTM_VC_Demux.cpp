@@ -34,58 +34,66 @@ int modTM_VC_Demux::svc() {
 	svcStart_();
 	HandlerLinkMap::iterator outputLink;
 	TM_Transfer_Frame* frame = 0;
+	std::vector<NetworkData*> batch;
+	HandlerLinkBatch outputs;
 
 	while ( continueService() ) {
-		ndSafeRelease(frame);
-		bool frameIsValid = true;
-
-		std::pair<NetworkData*, int> queueTop = getData_();
+		const int queued = getDataBatch_(batch, getMaxBatchUnits());
 
-		if ( msg_queue()->deactivated() ) break;
-
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
+		if ( msg_queue()->deactivated() ) {
+			releaseBatch_(batch);
+			break;
 		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
-			continue;
-		}
-
-		frame = dynamic_cast<TM_Transfer_Frame*>(queueTop.first);
 
-		if ( ! frame ) {
-			MOD_ERROR("Received %d-octet buffer in %s wrapper (not TM_Transfer_Frame)! Must discard.",
-				queueTop.first->getUnitLength(), queueTop.first->typeStr().c_str());
-			ndSafeRelease(queueTop.first);
+		if ( queued < 0 ) {
+			MOD_ERROR("getDataBatch_() call failed.");
 			continue;
 		}
 
-		MOD_DEBUG("Received %d-octet frame to demultiplex.", frame->getTotalUnitLength());
-
-		// Test expected values.
-		if ( ! validateFrame(frame) ) {
-			frameIsValid = false;
-			if ( getDropBadFrames() ) continue;
-		}
-
-		if ( frame->getMCID() != getMCID() ) {
-			MOD_WARNING("Received Frame with wrong MCID, 0x%X instead of 0x%X.", frame->getMCID(), getMCID());
-			frameIsValid = false;
-			incBadMCIDCount();
-			if ( getDropBadFrames() ) continue;
+		for ( size_t idx = 0; idx < batch.size(); ++idx ) {
+			ndSafeRelease(frame);
+			bool frameIsValid = true;
+
+			frame = dynamic_cast<TM_Transfer_Frame*>(batch[idx]);
+
+			if ( ! frame ) {
+				MOD_ERROR("Received %d-octet buffer in %s wrapper (not TM_Transfer_Frame)! Must discard.",
+					batch[idx]->getUnitLength(), batch[idx]->typeStr().c_str());
+				ndSafeRelease(batch[idx]);
+				continue;
+			}
+
+			MOD_DEBUG("Received %d-octet frame to demultiplex.", frame->getTotalUnitLength());
+
+			// Test expected values.
+			if ( ! validateFrame(frame) ) {
+				frameIsValid = false;
+				if ( getDropBadFrames() ) continue;
+			}
+
+			if ( frame->getMCID() != getMCID() ) {
+				MOD_WARNING("Received Frame with wrong MCID, 0x%X instead of 0x%X.", frame->getMCID(), getMCID());
+				frameIsValid = false;
+				incBadMCIDCount();
+				if ( getDropBadFrames() ) continue;
+			}
+
+			if ( frameIsValid ) incValidFrameCount();
+
+			if ( ( outputLink = primaryOutputLinks_.find(frame->getVCID())) != primaryOutputLinks_.end() ) {
+				MOD_DEBUG("Sending %d-octet buffer.", frame->getTotalUnitLength());
+				outputs.add(outputLink->second, frame);
+				frame = 0; // important
+			}
+			else {
+				MOD_NOTICE("No output target defined for VCID %d, dropping data.", frame->getVCID());
+			}
 		}
 
-		if ( frameIsValid ) incValidFrameCount();
-
-		if ( ( outputLink = primaryOutputLinks_.find(frame->getVCID())) != primaryOutputLinks_.end() ) {
-			MOD_DEBUG("Sending %d-octet buffer.", frame->getTotalUnitLength());
-			outputLink->second->send(frame);
-			frame = 0; // important
-		}
-		else {
-			MOD_NOTICE("No output target defined for VCID %d, dropping data.", frame->getVCID());
-		}
+		// Release the last unit if it was dropped, and pass on what's pending.
+		ndSafeRelease(frame);
+		batch.clear();
+		outputs.flush();
 	}
 
 	return svcEnd_();
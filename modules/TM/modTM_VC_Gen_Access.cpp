@@ -67,7 +67,9 @@ int modTM_VC_Gen_Access::svc() {
 			0, // we have the contents the data zone, but no TF header/trailer yet
 			getUseOperationalControl(), // existance of OCF is VC dependent
 			getUseFrameErrorControl(), // all frames in MC have frame CRC, or not
-			getFSHSize() // size of secondary header
+			getFSHSize(), // size of secondary header
+			getReservedHeadroom(), // room for layers added later in the channel
+			getReservedTailroom()
 		);
 
 		if ( ! frame ) {
@@ -174,7 +174,9 @@ void modTM_VC_Gen_Packet::_processData(NetworkData* netdata) {
 				0, // we have the contents the data zone, but no TF header/trailer yet
 				getUseOperationalControl(), // existance of OCF is VC dependent
 				getUseFrameErrorControl(), // all frames in PC have frame CRC, or not
-				getFSHSize() // length of TF frame secondary header
+				getFSHSize(), // length of TF frame secondary header
+				getReservedHeadroom(), // room for layers added later in the channel
+				getReservedTailroom()
 			);
 
 			if ( ! frame ) {
@@ -249,7 +251,7 @@ void modTM_VC_Gen_Packet::_processData(NetworkData* netdata) {
 	if ( frame && frameCount ) {
 		TM_Transfer_Frame* lastFrame = frame;
 
-		ACE_Time_Value timeToWaitUntil(ACE_High_Res_Timer::gettimeofday_hr() + getWaitForNextPacket());
+		ACE_Time_Value timeToWaitUntil(ClockService::instance()->preciseNow() + getWaitForNextPacket());
 		_unfilledFrame = lastFrame;
 		_unfilledFrameIdx = frameIdx;
 		--frameCount;
@@ -32,55 +32,30 @@ modExtractor::~modExtractor() {
 }
 
 int modExtractor::svc() {
-	svcStart_();
-
-	while ( continueService() ) {
-		std::pair<NetworkData*, int> queueTop = getData_();
-
-		if ( msg_queue()->deactivated() ) break;
-
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
-		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
-			continue;
-		}
-
-		NetworkData* data = queueTop.first;
-
-		MOD_DEBUG("Received %d octets to extract from.", data->getUnitLength());
-
-		if ( links_[PrimaryOutputLink] ) {
-			if ( data->getUnitLength() < static_cast<unsigned>( getHeaderLength() + getTrailerLength() ) ) {
-				MOD_INFO("%d-octet unit is too small to extract, sending unchanged.", data->getUnitLength());
-				incStubCount();
-			}
-			else {
-				size_t newUnitLength = data->getUnitLength() - getHeaderLength() - getTrailerLength();
+	return transformLoop_();
+}
 
-				char* startPtr = data->rd_ptr();
-				data->rd_ptr(startPtr + getHeaderLength());
-				data->setUnitLength(newUnitLength);
+NetworkData* modExtractor::transformUnit_(NetworkData* data) {
+	MOD_DEBUG("Received %d octets to extract from.", data->getUnitLength());
 
-				MOD_DEBUG("New unit length is now %d octets.", data->getUnitLength());
+	if ( data->getUnitLength() < static_cast<unsigned>( getHeaderLength() + getTrailerLength() ) ) {
+		MOD_INFO("%d-octet unit is too small to extract, sending unchanged.", data->getUnitLength());
+		incStubCount();
+	}
+	else {
+		size_t newUnitLength = data->getUnitLength() - getHeaderLength() - getTrailerLength();
 
-				incHeaderOctetCount(getHeaderLength());
-				incTrailerOctetCount(getTrailerLength());
-			}
+		char* startPtr = data->rd_ptr();
+		data->rd_ptr(startPtr + getHeaderLength());
+		data->setUnitLength(newUnitLength);
 
-			MOD_DEBUG("Sending %d octets.", data->getUnitLength());
-			links_[PrimaryOutputLink]->send(data);
-		}
-		else {
-			MOD_NOTICE("No output target defined yet, dropping data.");
-		}
+		MOD_DEBUG("New unit length is now %d octets.", data->getUnitLength());
 
+		incHeaderOctetCount(getHeaderLength());
+		incTrailerOctetCount(getTrailerLength());
 	}
 
-	return svcEnd_();
-
+	return data;
 }
 
 }
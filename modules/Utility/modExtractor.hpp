@@ -40,6 +40,9 @@ public:
 	/// Reads in data, extracts a portion, and sends it to the output handler.
 	int svc();
 
+	/// Extraction only adjusts each unit's own pointers.
+	bool supportsInline() const { return true; }
+
 	/// Write-only accessor to _headerLength.
 	void setHeaderLength(const int& newVal) {	_headerLength = newVal;	}
 	
@@ -81,7 +84,11 @@ public:
 	/// Increase _stubCount by the specified amount.
 	int incStubCount(const int& step = 1) const {
 		return ( _stubCount = getStubCount() + step ) ; }
-		
+
+protected:
+	/// Trim the header and trailer from the unit, in place.
+	NetworkData* transformUnit_(NetworkData* data);
+
 private:
 	Setting& _headerLength; /// Number of octets to remove from the front.
 	
@@ -13,6 +13,8 @@
 //=============================================================================
 
 #include "modFdTransmitter.hpp"
+#include <ace/OS_NS_sys_uio.h>
+#include <vector>
 
 namespace nFdTransmitter {
 
@@ -47,10 +49,10 @@ int modFdTransmitter::svc() {
 
 		NetworkData* data = queueTop.first;
 
-		MOD_DEBUG("Received %d bytes to write to a descriptor.", data->getUnitLength());
+		MOD_DEBUG("Received %d bytes to write to a descriptor.", data->getTotalUnitLength());
 
 		if ( _device) {
-			int octetsToWrite = data->getUnitLength();
+			int octetsToWrite = data->getTotalUnitLength();
 
 			if ( _device->getHandle() == ACE_INVALID_HANDLE ) {
 				MOD_ERROR("Target device %s has invalid descriptor.",
@@ -60,7 +62,21 @@ int modFdTransmitter::svc() {
 				continue;
 			}
 
-			int writeCount = ACE_OS::write(_device->getHandle(), data->ptrUnit(), octetsToWrite);
+			int writeCount;
+
+			if ( data->getNextPart() ) {
+				std::vector<iovec> parts;
+
+				for ( NetworkData* part = data; part; part = part->getNextPart() ) {
+					iovec vec;
+					vec.iov_base = reinterpret_cast<char*>(part->ptrUnit());
+					vec.iov_len = part->getUnitLength();
+					parts.push_back(vec);
+				}
+
+				writeCount = ACE_OS::writev(_device->getHandle(), &parts[0], parts.size());
+			}
+			else writeCount = ACE_OS::write(_device->getHandle(), data->ptrUnit(), octetsToWrite);
 
 			if ( writeCount < 0 ) {
 				int err = errno;
@@ -43,6 +43,9 @@ public:
 	/// Get data from our FIFO and write it to the device that we connect to.
 	int svc();
 
+	/// Units made of several parts are written with a single writev().
+	bool acceptsChainedUnits() const { return true; }
+
 	/// Select the pre-configured device to write frames to.
 	/// @param device A EthernetDevice pointer polymorphed as a CE_Device.
  	void connectDevice(CE_Device* device);
@@ -28,43 +28,45 @@ modSplitter::~modSplitter() {
 
 int modSplitter::svc() {
 	svcStart_();
+	std::vector<NetworkData*> batch, dupBatch;
 
 	while ( continueService() ) {
-		std::pair<NetworkData*, int> queueTop = getData_();
+		const int queued = getDataBatch_(batch, getMaxBatchUnits());
 
-		if ( msg_queue()->deactivated() ) break;
-
-		if ( queueTop.second < 0 ) {
-			MOD_ERROR("getData_() call failed.");
-			continue;
+		if ( msg_queue()->deactivated() ) {
+			releaseBatch_(batch);
+			break;
 		}
-		else if ( ! queueTop.first ) {
-			MOD_ERROR("getData_() returned with null data.");
+
+		if ( queued < 0 ) {
+			MOD_ERROR("getDataBatch_() call failed.");
 			continue;
 		}
 
-		NetworkData* data = queueTop.first;
+		for ( size_t idx = 0; idx < batch.size(); ++idx ) {
+			NetworkData* data = batch[idx];
 
-		MOD_DEBUG("Received a %d-octet data unit to split.", data->getUnitLength());
+			MOD_DEBUG("Received a %d-octet data unit to split.", data->getUnitLength());
 
-		NetworkData* dupData = data->wrapInnerPDU<NetworkData>(data->getUnitLength(), data->ptrUnit());
+			dupBatch.push_back(data->wrapInnerPDU<NetworkData>(data->getUnitLength(), data->ptrUnit()));
+		}
 
 		if ( links_[PrimaryOutputLink] ) {
-			MOD_DEBUG("Sending %d octets via primary output link.", data->getUnitLength());
-			links_[PrimaryOutputLink]->send(data);
+			MOD_DEBUG("Sending %d units via primary output link.", batch.size());
+			links_[PrimaryOutputLink]->sendBatch(batch);
 		}
 		else {
-			MOD_NOTICE("No primary output target defined yet, dropping data.");
-			ndSafeRelease(data);
+			MOD_NOTICE("No primary output target defined yet, dropping %d units.", batch.size());
+			releaseBatch_(batch);
 		}
 
 		if ( links_[AuxOutputLink] ) {
-			MOD_DEBUG("Sending %d octets via auxiliary output link.", dupData->getUnitLength());
-			links_[AuxOutputLink]->send(dupData);
+			MOD_DEBUG("Sending %d units via auxiliary output link.", dupBatch.size());
+			links_[AuxOutputLink]->sendBatch(dupBatch);
 		}
 		else {
-			MOD_NOTICE("No auxiliary output target defined yet, dropping data copy.");
-			ndSafeRelease(dupData);
+			MOD_NOTICE("No auxiliary output target defined yet, dropping %d unit copies.", dupBatch.size());
+			releaseBatch_(dupBatch);
 		}
 	}
 
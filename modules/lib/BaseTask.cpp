@@ -103,6 +103,18 @@ void BaseTask::svcStart_() {
 	MOD_DEBUG("Entering svc thread.");
 	svcThreadID_ = ACE_Thread::self();
 	svcDone_ = false;
+
+	if ( ! placement_.isDefault() ) {
+		std::string problems;
+		if ( ! placement_.applyToSelf(problems) )
+			MOD_WARNING("Thread placement was only partly applied: %s", problems.c_str());
+	}
+
+	effectivePlacement_ = ThreadPlacement::current(placement_);
+
+	MOD_DEBUG("Service thread running on CPUs %s with %s scheduling at priority %d.",
+		effectivePlacement_.getCpuList().c_str(), effectivePlacement_.getPolicyStr().c_str(),
+		effectivePlacement_.getPriority());
 }
 
 int BaseTask::svcEnd_() {
@@ -17,6 +17,7 @@
 
 #include "CE_Config.hpp"
 #include "utilityMacros.hpp"
+#include "ThreadPlacement.hpp"
 #include <ace/OS_main.h>
 #include <ace/Task.h>
 #include <ace/Message_Queue_T.h>
@@ -100,6 +101,12 @@ public:
 	/// Sets the file descriptor associated with this task.
 	void set_handle(ACE_HANDLE newVal);
 
+	/// Read-only accessor to placement_.
+	const ThreadPlacement& getPlacement() const { return placement_; }
+
+	/// Read-only accessor to effectivePlacement_.
+	const ThreadPlacement& getEffectivePlacement() const { return effectivePlacement_; }
+
 	/// Make the stored handle invalid.
 	void unset_handle();
 
@@ -116,7 +123,14 @@ protected:
 	/// Whether svc() is active or not.
 	bool svcDone_;
 
-	/// Set svcThreadID_ to the correct thread ID and set svcDone_ to false.
+	/// CPU, scheduling, and NUMA placement to apply when the svc() thread starts.
+	ThreadPlacement placement_;
+
+	/// Where the svc() thread actually ended up; default until the thread starts.
+	ThreadPlacement effectivePlacement_;
+
+	/// Set svcThreadID_ to the correct thread ID, set svcDone_ to false,
+	/// and apply placement_ to the thread.
 	void svcStart_();
 
 	/// Set svcDone_ to true and exit the thread.
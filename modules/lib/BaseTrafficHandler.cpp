@@ -17,6 +17,7 @@
 
 const int BaseTrafficHandler::defaultLowWaterMark = 0x300000;
 const int BaseTrafficHandler::defaultHighWaterMark = 0x400000;
+const int BaseTrafficHandler::defaultMaxBatchUnits = 32;
 
 BaseTrafficHandler::BaseTrafficHandler(const std::string& newName,
 	const std::string& newChannelName,
@@ -28,8 +29,31 @@ BaseTrafficHandler::BaseTrafficHandler(const std::string& newName,
 	mruSetting_(CEcfg::instance()->getOrAddInt(cfgKey("MRU"), MRU_)),
 	MTU_(0),
 	mtuSetting_(CEcfg::instance()->getOrAddInt(cfgKey("MTU"), MTU_)),
+	reservedHeadroom_(0),
+	reservedHeadroomSetting_(CEcfg::instance()->getOrAddInt(channelKey() + ".reservedHeadroom", 0)),
+	reservedTailroom_(0),
+	reservedTailroomSetting_(CEcfg::instance()->getOrAddInt(channelKey() + ".reservedTailroom", 0)),
 	lowWaterMarkSetting_(CEcfg::instance()->getOrAddInt(cfgKey("lowWaterMark"), defaultLowWaterMark)),
 	highWaterMarkSetting_(CEcfg::instance()->getOrAddInt(cfgKey("highWaterMark"), defaultHighWaterMark)),
+	ringQueueSlotsSetting_(CEcfg::instance()->getOrAddInt(cfgKey("ringQueueSlots"),
+		static_cast<int>(CEcfg::instance()->getOrAddInt(channelKey() + ".ringQueueSlots", 0)))),
+	maxBatchUnits_(defaultMaxBatchUnits),
+	maxBatchUnitsSetting_(CEcfg::instance()->getOrAddInt(cfgKey("maxBatchUnits"), defaultMaxBatchUnits)),
+	cpuAffinitySetting_(CEcfg::instance()->getOrAddString(cfgKey("cpuAffinity"),
+		static_cast<const char*>(CEcfg::instance()->getOrAddString(channelKey() + ".cpuAffinity", "")))),
+	schedPolicySetting_(CEcfg::instance()->getOrAddString(cfgKey("schedPolicy"),
+		static_cast<const char*>(CEcfg::instance()->getOrAddString(channelKey() + ".schedPolicy", "other")))),
+	schedPrioritySetting_(CEcfg::instance()->getOrAddInt(cfgKey("schedPriority"),
+		static_cast<int>(CEcfg::instance()->getOrAddInt(channelKey() + ".schedPriority", 0)))),
+	numaNodeSetting_(CEcfg::instance()->getOrAddInt(cfgKey("numaNode"),
+		static_cast<int>(CEcfg::instance()->getOrAddInt(channelKey() + ".numaNode", -1)))),
+	runInline_(false),
+	runInlineSetting_(CEcfg::instance()->getOrAddBool(cfgKey("runInline"), runInline_)),
+	useWorkerPool_(false),
+	useWorkerPoolSetting_(CEcfg::instance()->getOrAddBool(cfgKey("useWorkerPool"),
+		static_cast<bool>(CEcfg::instance()->getOrAddBool(channelKey() + ".useWorkerPool", false)))),
+	execMode_(OwnThread),
+	poolRequests_(0),
 	dumpToLog_(false),
 	dumpToLogSetting_(CEcfg::instance()->getOrAddBool(cfgKey("dumpToLog"), dumpToLog_)),
 	ptrDLL_(const_cast<CE_DLL*>(newDLLPtr)),
@@ -47,13 +71,44 @@ BaseTrafficHandler::BaseTrafficHandler(const std::string& newName,
 
 	MRU_ = static_cast<int>(mruSetting_);
 	MTU_ = static_cast<int>(mtuSetting_);
+	NetworkDataPool::instance()->addSizeClass(MRU_);
+	NetworkDataPool::instance()->addSizeClass(MTU_);
+	reservedHeadroom_ = static_cast<int>(reservedHeadroomSetting_);
+	reservedTailroom_ = static_cast<int>(reservedTailroomSetting_);
+	runInline_ = runInlineSetting_;
+	useWorkerPool_ = useWorkerPoolSetting_;
 	dumpToLog_ = dumpToLogSetting_;
 
+	try { setMaxBatchUnits(static_cast<int>(maxBatchUnitsSetting_)); }
+	catch (const ValueOutOfRange& e) { setMaxBatchUnits(defaultMaxBatchUnits); }
+
+	// A bad placement setting is reported but shouldn't keep the segment from loading,
+	// or keep the other placement settings from taking effect.
+	try { placement_.setCpuList(static_cast<const char*>(cpuAffinitySetting_)); }
+	catch (const nd_error& e) {
+		MOD_WARNING("Ignoring the CPU affinity setting: %s", e.what());
+	}
+
+	try {
+		placement_.setPolicy(static_cast<const char*>(schedPolicySetting_));
+		placement_.setPriority(static_cast<int>(schedPrioritySetting_));
+	}
+	catch (const nd_error& e) {
+		MOD_WARNING("Ignoring part of the scheduling settings: %s", e.what());
+	}
+
+	try { placement_.setNumaNode(static_cast<int>(numaNodeSetting_)); }
+	catch (const nd_error& e) {
+		MOD_WARNING("Ignoring the NUMA node setting: %s", e.what());
+	}
+
 	if (ptrDLL_) ptrDLL_->incReference();
 
 	msg_queue()->low_water_mark(static_cast<int>(lowWaterMarkSetting_));
 	msg_queue()->high_water_mark(static_cast<int>(highWaterMarkSetting_));
 
+	if ( static_cast<int>(ringQueueSlotsSetting_) > 0 ) useRingQueue_(true);
+
 	#ifdef DEFINE_DEBUG
 	Setting& debugSetting = CEcfg::instance()->getOrAddBool(cfgKey("debug"), globalCfg.debug);
 	setDebugging(debugSetting);
@@ -87,6 +142,180 @@ int BaseTrafficHandler::svc() {
 	return svcEnd_();
 }
 
+int BaseTrafficHandler::open(void* args /* = 0 */) {
+	// A running service thread keeps going until the next stopTraffic().
+	if ( ! svcDone_ ) return BaseTask::open(args);
+
+	if ( runInline_ && supportsInline() ) execMode_ = Inline;
+	else if ( useWorkerPool_ && supportsWorkerPool() ) execMode_ = Pooled;
+	else execMode_ = OwnThread;
+
+	if ( execMode_ == OwnThread ) return BaseTask::open(args);
+
+	shutdown_ = false;
+	svcThreadID_ = 0; // Nothing for stopTraffic() to join.
+
+	if ( msg_queue()->deactivated() )
+		msg_queue()->open(msg_queue()->high_water_mark(), msg_queue()->low_water_mark());
+
+	if ( execMode_ == Pooled ) {
+		MOD_INFO("Processing primary input on the %d-thread worker pool.",
+			WorkerPool::instance()->getThreadCount());
+
+		if ( ! msg_queue()->is_empty() ) schedulePoolTask_();
+		return 0;
+	}
+
+	MOD_INFO("Processing primary input inline on the sender's thread.");
+
+	// Pass on anything that was queued before the switch; nothing else will drain it.
+	std::vector<NetworkData*> batch;
+	ACE_Time_Value noWait(ACE_Time_Value::zero);
+
+	while ( ! msg_queue()->is_empty() &&
+		getDataBatch_(batch, maxBatchUnitsLimit, HandlerLink::PrimaryInput, &noWait) >= 0 ) {
+		transformBatch_(batch);
+	}
+
+	return 0;
+}
+
+void BaseTrafficHandler::stopTraffic(bool shutdown /* = true */) {
+	BaseTask::stopTraffic(shutdown);
+
+	// Wait until the pool task is neither queued nor running. A running task
+	// finishes on its own once it sees the closed queue; a queued one is withdrawn.
+	while ( poolRequests_ ) {
+		if ( WorkerPool::instance()->cancel(this) ) {
+			// Nothing can submit the task again while the count is nonzero, so clear it.
+			long requests;
+			while ( (requests = poolRequests_) && __sync_sub_and_fetch(&poolRequests_, requests) );
+			break;
+		}
+
+		if ( ! WorkerPool::onWorkerThread() || ! WorkerPool::instance()->runOne() ) {
+			ACE_OS::thr_yield();
+		}
+	}
+}
+
+std::string BaseTrafficHandler::getExecutionModeStr() const {
+	switch (execMode_) {
+		case Inline: return "inline";
+		case Pooled: return "pool";
+		default: break;
+	}
+
+	return "thread";
+}
+
+void BaseTrafficHandler::runPoolTask() {
+	const long requests = poolRequests_;
+	ACE_Time_Value noWait(ACE_Time_Value::zero);
+
+	try {
+		for ( int round = 0; round < poolBatchesPerRun && acceptingData(); ++round ) {
+			if ( getDataBatch_(poolBatch_, getMaxBatchUnits(), HandlerLink::PrimaryInput, &noWait) < 0 ) break;
+			transformBatch_(poolBatch_);
+		}
+	}
+	catch (const HandlerLink::DisconnectedLink& e) {
+		MOD_NOTICE("Dropping %d units: %s", poolBatch_.size(), e.what());
+	}
+	catch (const std::exception& e) {
+		MOD_ERROR("Dropping %d units after a processing error: %s", poolBatch_.size(), e.what());
+	}
+
+	// Only units still owned by the segment are left after an exception.
+	releaseBatch_(poolBatch_);
+
+	// Stay scheduled if there's more to do, e.g. after using up poolBatchesPerRun.
+	if ( acceptingData() && ! msg_queue()->is_empty() ) {
+		WorkerPool::instance()->submit(this);
+		return;
+	}
+
+	// Units queued while running were counted in poolRequests_ and need another run.
+	// Otherwise this is the last access to the segment, which stopTraffic() may be waiting to delete.
+	if ( __sync_sub_and_fetch(&poolRequests_, requests) > 0 ) WorkerPool::instance()->submit(this);
+}
+
+void BaseTrafficHandler::schedulePoolTask_() {
+	if ( __sync_fetch_and_add(&poolRequests_, 1) == 0 ) WorkerPool::instance()->submit(this);
+}
+
+int BaseTrafficHandler::putPooled_(ACE_Message_Block* mblk) {
+	int ret;
+
+	if ( WorkerPool::onWorkerThread() ) {
+		// Blocking on a full queue could tie up every worker, including the one
+		// that would drain it, so run other tasks until there's room.
+		ACE_Time_Value noWait(ACE_Time_Value::zero);
+
+		while ( (ret = putq(mblk, &noWait)) < 0 && errno == EWOULDBLOCK && acceptingData() ) {
+			if ( ! WorkerPool::instance()->runOne() ) ACE_OS::thr_yield();
+		}
+	}
+	else ret = putq(mblk);
+
+	if ( ret >= 0 ) schedulePoolTask_();
+
+	return ret;
+}
+
+int BaseTrafficHandler::transformBatch_(std::vector<NetworkData*>& batch) {
+	if ( ! links_[PrimaryOutputLink] ) {
+		MOD_NOTICE("No output target defined yet, dropping %d units.", batch.size());
+		releaseBatch_(batch);
+		return -1;
+	}
+
+	size_t kept = 0, idx = 0;
+
+	try {
+		for ( ; idx < batch.size(); ++idx ) {
+			NetworkData* result = transformUnit_(batch[idx]);
+			if ( result ) batch[kept++] = result;
+		}
+	}
+	catch (...) {
+		// Leave only what's still ours: the results so far and the untouched units.
+		// The unit that was being transformed may already have been released.
+		batch.erase(batch.begin() + kept, batch.begin() + idx + 1);
+		throw;
+	}
+
+	batch.resize(kept);
+
+	if ( batch.empty() ) return -1;
+
+	MOD_DEBUG("Sending %d units via primary output link.", batch.size());
+	return links_[PrimaryOutputLink]->sendBatch(batch);
+}
+
+int BaseTrafficHandler::transformLoop_() {
+	svcStart_();
+	std::vector<NetworkData*> batch;
+
+	while ( continueService() ) {
+		const int queued = getDataBatch_(batch, getMaxBatchUnits());
+
+		if ( msg_queue()->deactivated() ) {
+			releaseBatch_(batch);
+			break;
+		}
+
+		if ( queued < 0 ) {
+			MOD_ERROR("getDataBatch_() call failed.");
+			continue;
+		}
+
+		transformBatch_(batch);
+	}
+
+	return svcEnd_();
+}
+
 bool BaseTrafficHandler::isCircularConnection(BaseTrafficHandler* testTarget) {
 	// Don't output directly to ourselves!
 	if (testTarget == this) return true;
@@ -167,6 +396,27 @@ int BaseTrafficHandler::putData(NetworkData* data,
 		return -1;
 	}
 
+	if ( data->getNextPart() && ! acceptsChainedUnits() ) data->flatten();
+
+	if ( inputRank == HandlerLink::PrimaryInput && execMode_ == Pooled ) return putPooled_(mblk);
+
+	if ( inputRank == HandlerLink::PrimaryInput && execMode_ == Inline ) {
+		// Same ownership rule as a closed queue: the caller keeps the unit.
+		if ( ! acceptingData() ) return -1;
+
+		incReceivedUnitCount(1);
+		incReceivedOctetCount(data->getTotalUnitLength());
+
+		if ( ! links_[PrimaryOutputLink] ) {
+			MOD_NOTICE("No output target defined yet, dropping data.");
+			ndSafeRelease(data);
+			return 0;
+		}
+
+		NetworkData* result = transformUnit_(data);
+		return ( result )? links_[PrimaryOutputLink]->send(result) : 0;
+	}
+
 	switch (inputRank) {
 		case HandlerLink::PrimaryInput:
 			return putq(mblk);
@@ -179,6 +429,70 @@ int BaseTrafficHandler::putData(NetworkData* data,
 	return -1;
 }
 
+int BaseTrafficHandler::putDataBatch(std::vector<NetworkData*>& batch,
+	const HandlerLink::InputRank inputRank /* = HandlerLink::PrimaryInput */ ) {
+
+	if ( ! acceptsChainedUnits() ) {
+		for ( size_t idx = 0; idx < batch.size(); ++idx )
+			if ( batch[idx]->getNextPart() ) batch[idx]->flatten();
+	}
+
+	if ( inputRank == HandlerLink::PrimaryInput && execMode_ == Inline ) {
+		if ( ! acceptingData() ) {
+			releaseBatch_(batch);
+			return -1;
+		}
+
+		size_t octets = 0;
+		for ( size_t idx = 0; idx < batch.size(); ++idx ) octets += batch[idx]->getTotalUnitLength();
+
+		incReceivedUnitCount(batch.size());
+		incReceivedOctetCount(octets);
+
+		return transformBatch_(batch);
+	}
+
+	int queued = 0;
+	size_t idx = 0;
+
+	// Pooled segments go unit by unit through putData() so a worker never blocks.
+	RingMessageQueue* ring = ( inputRank == HandlerLink::PrimaryInput && execMode_ != Pooled )?
+		dynamic_cast<RingMessageQueue*>(msg_queue()) : 0;
+
+	if ( ring ) {
+		// NetworkData derives from ACE_Message_Block alone, so the pointers convert in place.
+		ACE_Message_Block* mblks[maxBatchUnitsLimit];
+
+		while ( idx < batch.size() ) {
+			size_t count = 0;
+			for ( ; count < maxBatchUnitsLimit && idx + count < batch.size(); ++count )
+				mblks[count] = batch[idx + count];
+
+			const int added = ring->enqueueBatch(mblks, count);
+			if ( added < 0 ) break;
+
+			queued += added;
+			idx += added;
+			if ( static_cast<size_t>(added) < count ) break;
+		}
+	}
+	else {
+		for ( ; idx < batch.size(); ++idx ) {
+			if ( putData(batch[idx], inputRank) < 0 ) break;
+			++queued;
+		}
+	}
+
+	if ( idx < batch.size() ) {
+		MOD_WARNING("Unable to queue %d of %d units in batch, dropping them.", batch.size() - idx, batch.size());
+		for ( ; idx < batch.size(); ++idx ) ndSafeRelease(batch[idx]);
+	}
+
+	batch.clear();
+
+	return ( queued )? queued : -1;
+}
+
 void BaseTrafficHandler::setReceivedUnitCount(const ACE_UINT32& newVal,
 	const HandlerLink::InputRank inputRank /* = HandlerLink::PrimaryInput */ ) {
 	receivedUnitCount_[inputRank] = newVal;
@@ -244,12 +558,95 @@ std::pair<NetworkData*, int> BaseTrafficHandler::getData_(
 
 	if (data) {
 		incReceivedUnitCount(1, inputRank);
-		incReceivedOctetCount(data->getUnitLength(), inputRank);
+		incReceivedOctetCount(data->getTotalUnitLength(), inputRank);
 	}
 
 	return std::make_pair(data, messages);
 }
 
+int BaseTrafficHandler::getDataBatch_(std::vector<NetworkData*>& batch, const size_t maxUnits,
+	const HandlerLink::InputRank inputRank /* = HandlerLink::PrimaryInput */,
+	ACE_Time_Value* timeout /* = 0 */) {
+
+	batch.clear();
+
+	ACE_Message_Queue<ACE_MT_SYNCH>* msgq =
+		( inputRank == HandlerLink::PrimaryInput )? msg_queue() : getAuxQueue();
+
+	const size_t limit = ( maxUnits < 1 )? 1 : ( maxUnits > maxBatchUnitsLimit )? maxBatchUnitsLimit : maxUnits;
+	ACE_Message_Block* mblks[maxBatchUnitsLimit];
+	size_t count = 0;
+	int remaining = 0;
+
+	RingMessageQueue* ring = dynamic_cast<RingMessageQueue*>(msgq);
+
+	if ( ring ) {
+		const int removed = ring->dequeueBatch(mblks, limit, timeout);
+		if ( removed < 0 ) return -1;
+
+		count = removed;
+		remaining = static_cast<int>(ring->message_count());
+	}
+	else {
+		// Only the first dequeue may sleep; the rest take what's already there.
+		if ( (remaining = msgq->dequeue_head(mblks[0], timeout)) < 0 ) return -1;
+		count = 1;
+
+		ACE_Time_Value noWait(ACE_Time_Value::zero);
+
+		while ( remaining > 0 && count < limit ) {
+			if ( (remaining = msgq->dequeue_head(mblks[count], &noWait)) < 0 ) {
+				remaining = 0;
+				break;
+			}
+			++count;
+		}
+	}
+
+	size_t octets = 0;
+
+	for ( size_t idx = 0; idx < count; ++idx ) {
+		NetworkData* data = dynamic_cast<NetworkData*>(mblks[idx]);
+
+		if ( data ) {
+			batch.push_back(data);
+			octets += data->getTotalUnitLength();
+		}
+		else {
+			MOD_ERROR("Dequeued a message block that is not NetworkData, releasing it.");
+			mblks[idx]->release();
+		}
+	}
+
+	incReceivedUnitCount(batch.size(), inputRank);
+	incReceivedOctetCount(octets, inputRank);
+
+	return remaining;
+}
+
+void BaseTrafficHandler::useRingQueue_(const bool enable) {
+	const bool usingRing = ( dynamic_cast<RingMessageQueue*>(msg_queue()) != 0 );
+	if ( enable == usingRing ) return;
+
+	const size_t hwm = msg_queue()->high_water_mark();
+	const size_t lwm = msg_queue()->low_water_mark();
+
+	ACE_Message_Queue<ACE_MT_SYNCH>* newQueue = 0;
+
+	if ( enable ) {
+		MOD_DEBUG("Using a %d-slot ring queue for primary input.", static_cast<int>(ringQueueSlotsSetting_));
+		newQueue = new RingMessageQueue(static_cast<int>(ringQueueSlotsSetting_), hwm, lwm);
+	}
+	else {
+		MOD_DEBUG("Using a standard message queue for primary input.");
+		newQueue = new ACE_Message_Queue<ACE_MT_SYNCH>(hwm, lwm);
+	}
+
+	// ACE_Task deletes the old queue if it owned it; make it own the new one too.
+	msg_queue(newQueue);
+	delete_msg_queue_ = true;
+}
+
 void BaseTrafficHandler::deleteLink_(const LinkType linkType, HandlerLink*) {
 	if ( links_[linkType] ) {
 		delete links_[linkType];
@@ -19,7 +19,11 @@
 #include "CE_Device.hpp"
 #include "CE_DLL.hpp"
 #include "HandlerLink.hpp"
+#include "ClockService.hpp"
+#include "NetworkDataPool.hpp"
+#include "RingMessageQueue.hpp"
 #include "SettingsManager.hpp"
+#include "WorkerPool.hpp"
 
 #include <string>
 #include <ace/Message_Queue_T.h>
@@ -34,15 +38,34 @@ using namespace nasaCE;
  * @brief Provides the basic methods that modules will need to communicate.
  *
  * Most modules will override these methods with functions that actually move data.
+ *
+ * A segment that implements transformUnit_() does not need a thread of its own:
+ * it can run inline on its sender's thread, or as a task on the shared WorkerPool.
  */
 //=============================================================================
-class BaseTrafficHandler: public BaseTask {
+class BaseTrafficHandler: public BaseTask, public WorkerPool::Task {
 
 public:
 
 	static const int defaultLowWaterMark;
 	static const int defaultHighWaterMark;
 
+	/// The default for maxBatchUnits_.
+	static const int defaultMaxBatchUnits;
+
+	/// The largest allowed value of maxBatchUnits_.
+	static const size_t maxBatchUnitsLimit = 256;
+
+	/// The most batches a pooled segment processes before yielding its worker.
+	static const int poolBatchesPerRun = 4;
+
+	/// How the segment's primary input is being processed.
+	enum ExecutionMode {
+		OwnThread, ///< By the segment's own svc() thread.
+		Inline,    ///< On the sender's thread, as each unit arrives.
+		Pooled     ///< By whichever WorkerPool thread picks up the segment's task.
+	};
+
 	enum LinkType {
 		PrimaryInputLink,
 		AuxInputLink,
@@ -69,6 +92,18 @@ public:
     /// The functional loop that makes this an active object.
     int svc();
 
+	/// @brief Activate the object.
+	/// If runInline_ or useWorkerPool_ is set and the segment supports it, only the
+	/// input queue is opened and no thread is started.
+	int open(void* = 0);
+
+	/// Shut down the message queue and wait for processing, including any pooled task, to stop.
+	/// @param shutdown True indicates the whole system is coming down; false means it may come back.
+	void stopTraffic(bool shutdown = true);
+
+	/// Process queued units on a WorkerPool thread; only used in Pooled mode.
+	void runPoolTask();
+
 	// ----- Traffic flow management -----
 
 	/// Test for a possible circular connection anywhere in the chain.
@@ -91,7 +126,9 @@ public:
     virtual unsigned decRefCount() { return ((refCount_)? --refCount_: 0); }
 
 	/// Write-only accessor to MRU_ and mruSetting_, the Maximum Receive Unit.
+	/// Also registers the size with the NetworkData buffer pool.
 	virtual void setMRU(const size_t newVal) {
+		NetworkDataPool::instance()->addSizeClass(newVal);
 		MRU_ = newVal;
 		mruSetting_ = static_cast<int>(MRU_);
 	}
@@ -100,7 +137,9 @@ public:
 	virtual size_t getMRU() const { return MRU_; }
 
 	/// Write-only accessor to MTU_ and mtuSetting_, the Maximum Transmit Unit.
+	/// Also registers the size with the NetworkData buffer pool.
 	virtual void setMTU(const size_t newVal) {
+		NetworkDataPool::instance()->addSizeClass(newVal);
 		MTU_ = newVal;
 		mtuSetting_ = static_cast<int>(MTU_);
 	}
@@ -112,6 +151,28 @@ public:
 	/// can update our MTU if it's important to the target.
 	virtual void updateMTU(const size_t newMTU) { }
 
+	/// Write-only accessor to reservedHeadroom_ and reservedHeadroomSetting_.
+	/// Shared by all segments in the channel, but only the segment it's called on
+	/// notices the change before the channel is reloaded.
+	void setReservedHeadroom(const size_t newVal) {
+		reservedHeadroom_ = newVal;
+		reservedHeadroomSetting_ = static_cast<int>(newVal);
+	}
+
+	/// Read-only accessor to reservedHeadroom_, the free space to leave in front
+	/// of new units for encapsulating layers further down the channel.
+	size_t getReservedHeadroom() const { return reservedHeadroom_; }
+
+	/// Write-only accessor to reservedTailroom_ and reservedTailroomSetting_.
+	void setReservedTailroom(const size_t newVal) {
+		reservedTailroom_ = newVal;
+		reservedTailroomSetting_ = static_cast<int>(newVal);
+	}
+
+	/// Read-only accessor to reservedTailroom_, the free space to leave after
+	/// new units for trailers (e.g. R-S parity) added further down the channel.
+	size_t getReservedTailroom() const { return reservedTailroom_; }
+
 	/// Read-only accessor to the message queue low water mark.
 	size_t getLowWaterMark() { return msg_queue()->low_water_mark(); }
 
@@ -130,6 +191,106 @@ public:
 		highWaterMarkSetting_ = static_cast<int>(newVal);
 	}
 
+	/// @brief The number of slots in the primary input's ring queue.
+	/// @return Zero if the primary input uses a standard ACE_Message_Queue.
+	size_t getRingQueueSlots() {
+		RingMessageQueue* ring = dynamic_cast<RingMessageQueue*>(msg_queue());
+		return ( ring )? ring->getSlotCount() : 0;
+	}
+
+	/// Read-only accessor to maxBatchUnits_.
+	size_t getMaxBatchUnits() const { return maxBatchUnits_; }
+
+	/// Write-only accessor to maxBatchUnits_ and maxBatchUnitsSetting_.
+	/// @throw ValueOutOfRange If newVal is zero or above maxBatchUnitsLimit.
+	void setMaxBatchUnits(const size_t newVal) {
+		if ( newVal < 1 || newVal > maxBatchUnitsLimit )
+			throw ValueOutOfRange(ValueOutOfRange::msg("Max batch units", newVal, 1, maxBatchUnitsLimit));
+
+		maxBatchUnits_ = newVal;
+		maxBatchUnitsSetting_ = static_cast<int>(newVal);
+	}
+
+	/// @brief Whether the segment can handle units made of several parts linked with
+	/// NetworkData::setNextPart(). Units sent to any other segment are flattened first.
+	virtual bool acceptsChainedUnits() const { return false; }
+
+	/// @brief Whether the segment can process units on the sender's thread.
+	/// True for segments that implement transformUnit_() and keep no state between units.
+	virtual bool supportsInline() const { return false; }
+
+	/// Write-only accessor to runInline_ and runInlineSetting_.
+	/// Takes effect the next time the segment is opened.
+	void setRunInline(const bool newVal) { runInline_ = newVal; runInlineSetting_ = newVal; }
+
+	/// Read-only accessor to runInline_.
+	bool getRunInline() const { return runInline_; }
+
+	/// True if primary input is currently being processed on the sender's thread.
+	bool isInline() const { return execMode_ == Inline; }
+
+	/// @brief Whether the segment can run as a WorkerPool task instead of with its own thread.
+	/// Any segment that supportsInline() can, since its work is done by transformUnit_().
+	virtual bool supportsWorkerPool() const { return supportsInline(); }
+
+	/// Write-only accessor to useWorkerPool_ and useWorkerPoolSetting_.
+	/// Takes effect the next time the segment is opened.
+	void setUseWorkerPool(const bool newVal) { useWorkerPool_ = newVal; useWorkerPoolSetting_ = newVal; }
+
+	/// Read-only accessor to useWorkerPool_.
+	bool getUseWorkerPool() const { return useWorkerPool_; }
+
+	/// Read-only accessor to execMode_.
+	ExecutionMode getExecutionMode() const { return static_cast<ExecutionMode>(execMode_); }
+
+	/// Return "thread", "inline", or "pool" according to execMode_.
+	std::string getExecutionModeStr() const;
+
+	/// @brief Set the CPUs the svc() thread may run on; takes effect when the thread next starts.
+	/// @param newVal A list such as "0-3,8", or empty for any CPU.
+	/// @throw BadValue If the list is malformed or names a nonexistent CPU.
+	void setCpuAffinity(const std::string& newVal) {
+		placement_.setCpuList(newVal);
+		cpuAffinitySetting_ = placement_.getCpuList();
+	}
+
+	/// Return the requested CPU list, empty if any CPU is allowed.
+	std::string getCpuAffinity() const { return placement_.getCpuList(); }
+
+	/// @brief Set the svc() thread's scheduling policy; takes effect when the thread next starts.
+	/// @param newVal One of "other", "fifo", or "rr".
+	/// @throw BadValue If the policy is not recognized.
+	void setSchedPolicy(const std::string& newVal) {
+		placement_.setPolicy(newVal);
+		schedPolicySetting_ = placement_.getPolicyStr();
+		schedPrioritySetting_ = placement_.getPriority();
+	}
+
+	/// Return the name of the requested scheduling policy.
+	std::string getSchedPolicy() const { return placement_.getPolicyStr(); }
+
+	/// @brief Set the real-time priority of the svc() thread; takes effect when the thread next starts.
+	/// @param newVal The priority; 0 with the fifo or rr policy selects its lowest priority.
+	/// @throw ValueOutOfRange If the priority is not valid for the current policy.
+	void setSchedPriority(const int newVal) {
+		placement_.setPriority(newVal);
+		schedPrioritySetting_ = newVal;
+	}
+
+	/// Return the requested scheduling priority.
+	int getSchedPriority() const { return placement_.getPriority(); }
+
+	/// @brief Set the NUMA node for the svc() thread; takes effect when the thread next starts.
+	/// @param newVal The node number, or -1 for no preference.
+	/// @throw BadValue If the node does not exist.
+	void setNumaNode(const int newVal) {
+		placement_.setNumaNode(newVal);
+		numaNodeSetting_ = placement_.getNumaNode();
+	}
+
+	/// Return the requested NUMA node, or -1.
+	int getNumaNode() const { return placement_.getNumaNode(); }
+
 	/// Write-only accessor to dumpToLog_ and dumpToLogSetting_;
 	void setDumpToLog(bool newVal) { dumpToLog_ = newVal; dumpToLogSetting_ = newVal; }
 
@@ -173,10 +334,19 @@ public:
 	std::string handlerKey() const { return channelKey() + "." + name_; }
 	std::string cfgKey(const std::string& key) { return handlerKey() + "." + key; }
 
-	/// Insert a message block into the specified message queue.
+	/// @brief Insert a message block into the specified message queue.
+	/// When running inline, primary input is instead processed and sent on immediately.
 	/// @param data The message to insert.
 	virtual int putData(NetworkData* data, const HandlerLink::InputRank inputRank = HandlerLink::PrimaryInput);
 
+	/// @brief Insert several message blocks into the specified message queue.
+	/// A ring queue takes the whole batch with one lock and one wakeup; otherwise
+	/// each unit goes through putData(). Units that could not be queued are released.
+	/// @param batch The messages to insert, in order; emptied on return.
+	/// @return The number of units queued, or -1 if none were.
+	virtual int putDataBatch(std::vector<NetworkData*>& batch,
+		const HandlerLink::InputRank inputRank = HandlerLink::PrimaryInput);
+
 	/// Write-only accessor to receivedUnitCount_.
 	void setReceivedUnitCount(const ACE_UINT32& newVal,
 		const HandlerLink::InputRank inputRank = HandlerLink::PrimaryInput);
@@ -241,12 +411,78 @@ protected:
 	/// Configuration file reference to MTU_;
 	Setting& mtuSetting_;
 
+	/// Octets to reserve before the unit when this segment creates new data.
+	size_t reservedHeadroom_;
+
+	/// Channel-wide configuration file reference to reservedHeadroom_.
+	Setting& reservedHeadroomSetting_;
+
+	/// Octets to reserve after the unit when this segment creates new data.
+	size_t reservedTailroom_;
+
+	/// Channel-wide configuration file reference to reservedTailroom_.
+	Setting& reservedTailroomSetting_;
+
 	/// Configuration file reference to the message queue low water mark.
 	Setting& lowWaterMarkSetting_;
 
 	/// Configuration file reference to the message queue high water mark.
 	Setting& highWaterMarkSetting_;
 
+	/// @brief Configuration file reference to the primary input's ring queue size.
+	/// Zero selects a standard ACE_Message_Queue; defaults to the channel's ringQueueSlots.
+	/// Only read when the segment is created.
+	Setting& ringQueueSlotsSetting_;
+
+	/// The most units getDataBatch_() callers should ask for at once.
+	size_t maxBatchUnits_;
+
+	/// Configuration file reference to maxBatchUnits_.
+	Setting& maxBatchUnitsSetting_;
+
+	/// @brief Configuration file reference to the svc() thread's CPU list.
+	/// Defaults to the channel's cpuAffinity.
+	Setting& cpuAffinitySetting_;
+
+	/// Configuration file reference to the scheduling policy; defaults to the channel's schedPolicy.
+	Setting& schedPolicySetting_;
+
+	/// Configuration file reference to the scheduling priority; defaults to the channel's schedPriority.
+	Setting& schedPrioritySetting_;
+
+	/// Configuration file reference to the NUMA node; defaults to the channel's numaNode.
+	Setting& numaNodeSetting_;
+
+	/// If true, process primary input on the sender's thread when supportsInline() allows.
+	bool runInline_;
+
+	/// Configuration file reference to runInline_.
+	Setting& runInlineSetting_;
+
+	/// If true, run as a WorkerPool task when supportsWorkerPool() allows and not inline.
+	bool useWorkerPool_;
+
+	/// Configuration file reference to useWorkerPool_; defaults to the channel's useWorkerPool.
+	Setting& useWorkerPoolSetting_;
+
+	/// One of the ExecutionMode values, chosen by open().
+	volatile int execMode_;
+
+	/// @brief The number of times new work was signaled since the pool task last caught up.
+	/// Nonzero exactly while the segment's task is queued in or running on the WorkerPool;
+	/// the task's final access to the segment is bringing it back to zero.
+	volatile long poolRequests_;
+
+	/// Units being processed by runPoolTask(); only one worker runs the task at a time.
+	std::vector<NetworkData*> poolBatch_;
+
+	/// Note new work, and submit the segment to the WorkerPool unless it's already scheduled.
+	void schedulePoolTask_();
+
+	/// Enqueue a unit for a pooled segment and make sure its task will run.
+	/// A WorkerPool thread runs other tasks rather than block while the queue is full.
+	int putPooled_(ACE_Message_Block* mblk);
+
 	/// If true, hex dump every received unit to the log file.
 	bool dumpToLog_;
 
@@ -265,6 +501,42 @@ protected:
 		const HandlerLink::InputRank inputRank = HandlerLink::PrimaryInput,
 		ACE_Time_Value* timeout = 0);
 
+	/// @brief Retrieve several messages from an input queue at once.
+	/// Waits only until the first message is available, then takes whatever
+	/// else is already queued, up to maxUnits. The received counters are updated
+	/// once for the whole batch.
+	/// @param batch Receives the messages, in order; cleared first.
+	/// @param maxUnits The most messages to take; clamped to maxBatchUnitsLimit.
+	/// @param inputRank Whether to dequeue from the primary or auxiliary queue.
+	/// @param timeout The absolute time to stop waiting for the first message.
+	/// @return The number of messages left in the queue, or -1 if nothing was dequeued.
+	virtual int getDataBatch_(std::vector<NetworkData*>& batch, const size_t maxUnits,
+		const HandlerLink::InputRank inputRank = HandlerLink::PrimaryInput,
+		ACE_Time_Value* timeout = 0);
+
+	/// Release every unit in the batch and empty it.
+	void releaseBatch_(std::vector<NetworkData*>& batch) {
+		for ( size_t idx = 0; idx < batch.size(); ++idx ) ndSafeRelease(batch[idx]);
+		batch.clear();
+	}
+
+	/// @brief Process a single unit for a segment that supportsInline().
+	/// Called either from transformLoop_() or directly on the sender's thread,
+	/// so it must not depend on which thread calls it.
+	/// @param data The received unit, now owned by the callee.
+	/// @return The unit to send to the primary output, or null if it was consumed.
+	virtual NetworkData* transformUnit_(NetworkData* data) { return data; }
+
+	/// Run transformUnit_() on every unit in the batch and send the results
+	/// to the primary output. The batch is emptied on return.
+	/// If an exception escapes, the batch holds only the units still owned by the caller.
+	/// @return The number of units sent on, or -1 if none were.
+	int transformBatch_(std::vector<NetworkData*>& batch);
+
+	/// A complete svc() loop for segments that implement transformUnit_(),
+	/// used when they are not running inline.
+	int transformLoop_();
+
 	/// @brief Retrieve a message from the auxiliary input queue.
 	/// @param timeout The amount of time to wait for a message.
 	/// @return A std::pair, where .first is a pointer to the message data and
@@ -273,6 +545,12 @@ protected:
 		return getData_(HandlerLink::AuxInput, timeout);
 	}
 
+	/// @brief Replace the primary input queue with a RingMessageQueue or a standard one.
+	/// Only safe before any links are connected, i.e. from a constructor. Segments that
+	/// rely on priority or deadline ordering call this with false to opt out.
+	/// @param enable True to switch to a ring of ringQueueSlotsSetting_ slots.
+	void useRingQueue_(const bool enable);
+
 	/// A auxiliary queue managed as necessary by a derived class.
 	AuxMessageQueue* auxInputQueue_;
 
@@ -120,3 +120,17 @@ int HandlerLink::send(NetworkData* data) {
 
 	return _target->putData(data, _targetInputRank);
 }
+
+int HandlerLink::sendBatch(std::vector<NetworkData*>& batch) {
+	if ( batch.empty() ) return 0;
+
+	if ( exit_requested ) {
+		for ( size_t idx = 0; idx < batch.size(); ++idx ) ndSafeRelease(batch[idx]);
+		batch.clear();
+		return -1;
+	}
+
+	if (!_target) throw DisconnectedLink("Target input is not configured.");
+
+	return _target->putDataBatch(batch, _targetInputRank);
+}
@@ -18,6 +18,8 @@
 #include "CE_Config.hpp"
 #include "NetworkData.hpp"
 
+#include <vector>
+
 using namespace nasaCE;
 
 class BaseTrafficHandler;
@@ -95,6 +97,14 @@ public:
 	/// @param data The information to pass from the source to the target.
 	/// @throw DisconnectedLink If the connection has not been initialized.
 	virtual int send(NetworkData* data);
+
+	/// @brief Pass several units to the target at once.
+	/// The target may queue them with a single lock and wakeup; see
+	/// BaseTrafficHandler::putDataBatch(). Units that could not be queued are released.
+	/// @param batch The units to send, in order; emptied on return.
+	/// @return The number of units queued, or -1 if none were.
+	/// @throw DisconnectedLink If the connection has not been initialized.
+	virtual int sendBatch(std::vector<NetworkData*>& batch);
 	
 private:
 	BaseTrafficHandler* _source;
@@ -105,4 +115,69 @@ private:
 
 }; // class HandlerLink
 
+//=============================================================================
+/**
+ * @class HandlerLinkBatch
+ * @brief Gathers consecutive units bound for the same link and sends them together.
+ *
+ * For segments like demultiplexers that choose an output per unit: as long as
+ * successive units go to the same link they accumulate, and the run is sent
+ * with HandlerLink::sendBatch() when the link changes or flush() is called.
+ */
+//=============================================================================
+class HandlerLinkBatch {
+public:
+	HandlerLinkBatch(): _link(0) { }
+
+	/// @brief Sends anything still pending. Errors are only logged, since a destructor
+	/// must not throw; callers that need to see them should call flush() first.
+	~HandlerLinkBatch() {
+		try { flush(); }
+		catch (const HandlerLink::DisconnectedLink& e) {
+			ND_WARNING("HandlerLinkBatch: Dropped pending units: %s\n", e.what());
+		}
+		catch (const std::exception& e) {
+			ND_ERROR("HandlerLinkBatch: Failed to send pending units: %s\n", e.what());
+		}
+		catch (...) {
+			ND_ERROR("HandlerLinkBatch: Failed to send pending units: unknown exception.\n");
+		}
+	}
+
+	/// Add a unit to the batch for the specified link, sending the previous run first
+	/// if it was for a different link.
+	/// @throw DisconnectedLink If the previous run couldn't be sent; data is released too.
+	void add(HandlerLink* link, NetworkData* data) {
+		if ( link != _link ) {
+			try { flush(); }
+			catch (...) { ndSafeRelease(data); throw; }
+		}
+		_link = link;
+		_units.push_back(data);
+	}
+
+	/// @brief Send the pending run, if any.
+	/// An inline target processes the run on this thread, so its exceptions pass through here too.
+	/// @throw DisconnectedLink If the link has not been initialized; the run is released first.
+	void flush() {
+		HandlerLink* link = _link;
+		_link = 0;
+
+		if ( link && ! _units.empty() ) {
+			try { link->sendBatch(_units); }
+			catch (...) {
+				for ( size_t idx = 0; idx < _units.size(); ++idx ) ndSafeRelease(_units[idx]);
+				_units.clear();
+				throw;
+			}
+		}
+
+		_units.clear();
+	}
+
+private:
+	HandlerLink* _link;
+	std::vector<NetworkData*> _units;
+};
+
 #endif // _HANDLERLINK_HPP_
@@ -13,6 +13,7 @@
 //=============================================================================
 
 #include "PeriodicTransmitter.hpp"
+#include "ClockService.hpp"
 #include <ace/Event.h>
 #include <ace/High_Res_Timer.h>
 
@@ -48,7 +49,7 @@ int PeriodicTransmitter::svc() {
 	ACE_Message_Block* mblk = 0;
 	NetworkData* data = 0;
 
-	ACE_Time_Value sendTime(ACE_High_Res_Timer::gettimeofday_hr());
+	ACE_Time_Value sendTime(ClockService::instance()->preciseNow());
 	timespec waitLen;
 	// ACE_Event waiter;
 	int queueItems;
@@ -84,8 +85,9 @@ int PeriodicTransmitter::svc() {
 			}
 			else data = dynamic_cast<NetworkData*>(mblk);
 
-			if ( sendTime > ACE_High_Res_Timer::gettimeofday_hr() ) {
-				waitLen = sendTime - ACE_High_Res_Timer::gettimeofday_hr();
+			const ACE_Time_Value now(ClockService::instance()->preciseNow());
+			if ( sendTime > now ) {
+				waitLen = sendTime - now;
 				ACE_OS::nanosleep(&waitLen, 0);
 			}
 			// waitTime = sendTime - ACE_High_Res_Timer::gettimeofday_hr();
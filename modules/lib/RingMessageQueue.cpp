@@ -0,0 +1,425 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   RingMessageQueue.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "RingMessageQueue.hpp"
+#include "nd_macros.hpp"
+
+#include <ace/Guard_T.h>
+#include <ace/Message_Block.h>
+
+namespace nasaCE {
+
+RingMessageQueue::RingMessageQueue(const size_t slotCount, const size_t hwm, const size_t lwm):
+	baseType(hwm, lwm),
+	slots_(0),
+	slotMask_(0),
+	head_(0),
+	tail_(0),
+	bytes_(0),
+	length_(0),
+	highWaterMark_(hwm),
+	lowWaterMark_(lwm),
+	state_(ACE_Message_Queue_Base::ACTIVATED),
+	consumerWaiting_(0),
+	producerWaiting_(0),
+	notEmpty_(waitLock_),
+	notFull_(waitLock_) {
+
+	size_t slots = 2;
+	while ( slots < slotCount ) slots <<= 1;
+
+	slots_ = new ACE_Message_Block*[slots];
+	slotMask_ = slots - 1;
+}
+
+RingMessageQueue::~RingMessageQueue() {
+	flush();
+	delete[] slots_;
+}
+
+int RingMessageQueue::open(size_t hwm /* = ACE_Message_Queue_Base::DEFAULT_HWM */,
+	size_t lwm /* = ACE_Message_Queue_Base::DEFAULT_LWM */,
+	ACE_Notification_Strategy* ns /* = 0 */) {
+
+	baseType::open(hwm, lwm, ns);
+
+	highWaterMark_ = hwm;
+	lowWaterMark_ = lwm;
+	state_ = ACE_Message_Queue_Base::ACTIVATED;
+
+	return 0;
+}
+
+int RingMessageQueue::close() {
+	deactivate();
+	return flush();
+}
+
+int RingMessageQueue::flush() {
+	ACE_GUARD_RETURN(AtomicSpinLock, consumerGuard, consumerLock_, -1);
+
+	int released = 0;
+
+	while ( head_ != tail_ ) {
+		ACE_Message_Block* mb = slots_[head_ & slotMask_];
+		__sync_fetch_and_sub(&bytes_, mb->total_size());
+		__sync_fetch_and_sub(&length_, mb->total_length());
+		__sync_synchronize();
+		head_ = head_ + 1;
+
+		mb->release();
+		++released;
+	}
+
+	wakeAll_();
+
+	return released;
+}
+
+int RingMessageQueue::enqueue_tail(ACE_Message_Block* new_item, ACE_Time_Value* timeout /* = 0 */) {
+	if ( ! new_item ) return -1;
+
+	const size_t itemSize = new_item->total_size();
+	const size_t itemLength = new_item->total_length();
+
+	while ( true ) {
+		if ( state_ == ACE_Message_Queue_Base::DEACTIVATED ) {
+			errno = ESHUTDOWN;
+			return -1;
+		}
+
+		int count = -1;
+
+		{
+			ACE_GUARD_RETURN(AtomicSpinLock, producerGuard, producerLock_, -1);
+
+			if ( ! isFull_() ) {
+				const size_t tail = tail_;
+				slots_[tail & slotMask_] = new_item;
+				__sync_fetch_and_add(&bytes_, itemSize);
+				__sync_fetch_and_add(&length_, itemLength);
+
+				// Publish the slot, then look for a sleeping consumer.
+				__sync_synchronize();
+				tail_ = tail + 1;
+				__sync_synchronize();
+
+				count = static_cast<int>(tail + 1 - head_);
+			}
+		}
+
+		if ( count >= 0 ) {
+			if ( consumerWaiting_ ) {
+				ACE_GUARD_RETURN(ACE_Thread_Mutex, waitGuard, waitLock_, count);
+				notEmpty_.signal();
+			}
+
+			return count;
+		}
+
+		if ( waitNotFull_(timeout) == -1 ) return -1;
+	}
+}
+
+int RingMessageQueue::dequeue_head(ACE_Message_Block*& first_item, ACE_Time_Value* timeout /* = 0 */) {
+	first_item = 0;
+
+	while ( true ) {
+		if ( state_ == ACE_Message_Queue_Base::DEACTIVATED ) {
+			errno = ESHUTDOWN;
+			return -1;
+		}
+
+		int remaining = -1;
+
+		{
+			ACE_GUARD_RETURN(AtomicSpinLock, consumerGuard, consumerLock_, -1);
+
+			const size_t head = head_;
+
+			if ( head != tail_ ) {
+				__sync_synchronize();
+				first_item = slots_[head & slotMask_];
+				__sync_fetch_and_sub(&bytes_, first_item->total_size());
+				__sync_fetch_and_sub(&length_, first_item->total_length());
+
+				// Free the slot, then look for a sleeping producer.
+				__sync_synchronize();
+				head_ = head + 1;
+				__sync_synchronize();
+
+				remaining = static_cast<int>(tail_ - head_);
+			}
+		}
+
+		if ( first_item ) {
+			if ( producerWaiting_ && bytes_ <= lowWaterMark_ ) {
+				ACE_GUARD_RETURN(ACE_Thread_Mutex, waitGuard, waitLock_, remaining);
+				notFull_.broadcast();
+			}
+
+			return remaining;
+		}
+
+		if ( waitNotEmpty_(timeout) == -1 ) return -1;
+	}
+}
+
+int RingMessageQueue::peek_dequeue_head(ACE_Message_Block*& first_item, ACE_Time_Value* timeout /* = 0 */) {
+	first_item = 0;
+
+	while ( true ) {
+		if ( state_ == ACE_Message_Queue_Base::DEACTIVATED ) {
+			errno = ESHUTDOWN;
+			return -1;
+		}
+
+		{
+			ACE_GUARD_RETURN(AtomicSpinLock, consumerGuard, consumerLock_, -1);
+
+			if ( head_ != tail_ ) {
+				__sync_synchronize();
+				first_item = slots_[head_ & slotMask_];
+				return static_cast<int>(tail_ - head_);
+			}
+		}
+
+		if ( waitNotEmpty_(timeout) == -1 ) return -1;
+	}
+}
+
+int RingMessageQueue::enqueueBatch(ACE_Message_Block** items, const size_t itemCount,
+	ACE_Time_Value* timeout /* = 0 */) {
+
+	size_t added = 0;
+
+	while ( added < itemCount ) {
+		if ( state_ == ACE_Message_Queue_Base::DEACTIVATED ) {
+			errno = ESHUTDOWN;
+			break;
+		}
+
+		size_t addedNow = 0;
+
+		{
+			ACE_GUARD_RETURN(AtomicSpinLock, producerGuard, producerLock_, -1);
+
+			size_t tail = tail_;
+
+			while ( added + addedNow < itemCount && ! isFull_() ) {
+				ACE_Message_Block* item = items[added + addedNow];
+				slots_[tail & slotMask_] = item;
+				__sync_fetch_and_add(&bytes_, item->total_size());
+				__sync_fetch_and_add(&length_, item->total_length());
+
+				// Publish each slot as it's filled so the consumer can start early.
+				__sync_synchronize();
+				tail_ = ++tail;
+				++addedNow;
+			}
+
+			__sync_synchronize();
+		}
+
+		if ( addedNow ) {
+			added += addedNow;
+
+			if ( consumerWaiting_ ) {
+				ACE_GUARD_RETURN(ACE_Thread_Mutex, waitGuard, waitLock_, static_cast<int>(added));
+				notEmpty_.signal();
+			}
+		}
+
+		if ( added < itemCount && waitNotFull_(timeout) == -1 ) break;
+	}
+
+	return ( added )? static_cast<int>(added) : -1;
+}
+
+int RingMessageQueue::dequeueBatch(ACE_Message_Block** items, const size_t maxItems,
+	ACE_Time_Value* timeout /* = 0 */) {
+
+	while ( true ) {
+		if ( state_ == ACE_Message_Queue_Base::DEACTIVATED ) {
+			errno = ESHUTDOWN;
+			return -1;
+		}
+
+		size_t removed = 0;
+
+		{
+			ACE_GUARD_RETURN(AtomicSpinLock, consumerGuard, consumerLock_, -1);
+
+			size_t head = head_;
+			const size_t tail = tail_;
+			__sync_synchronize();
+
+			while ( removed < maxItems && head != tail ) {
+				ACE_Message_Block* item = slots_[head & slotMask_];
+				__sync_fetch_and_sub(&bytes_, item->total_size());
+				__sync_fetch_and_sub(&length_, item->total_length());
+				items[removed++] = item;
+				++head;
+			}
+
+			// Free all the slots at once, then look for a sleeping producer.
+			__sync_synchronize();
+			head_ = head;
+			__sync_synchronize();
+		}
+
+		if ( removed ) {
+			if ( producerWaiting_ && bytes_ <= lowWaterMark_ ) {
+				ACE_GUARD_RETURN(ACE_Thread_Mutex, waitGuard, waitLock_, static_cast<int>(removed));
+				notFull_.broadcast();
+			}
+
+			return static_cast<int>(removed);
+		}
+
+		if ( waitNotEmpty_(timeout) == -1 ) return -1;
+	}
+}
+
+int RingMessageQueue::enqueue(ACE_Message_Block*, ACE_Time_Value*) { return unsupported_("enqueue"); }
+
+int RingMessageQueue::enqueue_prio(ACE_Message_Block*, ACE_Time_Value*) { return unsupported_("enqueue_prio"); }
+
+int RingMessageQueue::enqueue_head(ACE_Message_Block*, ACE_Time_Value*) { return unsupported_("enqueue_head"); }
+
+int RingMessageQueue::enqueue_deadline(ACE_Message_Block*, ACE_Time_Value*) {
+	return unsupported_("enqueue_deadline");
+}
+
+int RingMessageQueue::dequeue_prio(ACE_Message_Block*&, ACE_Time_Value*) { return unsupported_("dequeue_prio"); }
+
+int RingMessageQueue::dequeue_tail(ACE_Message_Block*&, ACE_Time_Value*) { return unsupported_("dequeue_tail"); }
+
+int RingMessageQueue::dequeue_deadline(ACE_Message_Block*&, ACE_Time_Value*) {
+	return unsupported_("dequeue_deadline");
+}
+
+void RingMessageQueue::high_water_mark(size_t hwm) {
+	baseType::high_water_mark(hwm);
+	highWaterMark_ = hwm;
+	wakeAll_();
+}
+
+void RingMessageQueue::low_water_mark(size_t lwm) {
+	baseType::low_water_mark(lwm);
+	lowWaterMark_ = lwm;
+}
+
+int RingMessageQueue::deactivate() {
+	const int previous = state_;
+	state_ = ACE_Message_Queue_Base::DEACTIVATED;
+	wakeAll_();
+	return previous;
+}
+
+int RingMessageQueue::activate() {
+	const int previous = state_;
+	state_ = ACE_Message_Queue_Base::ACTIVATED;
+	return previous;
+}
+
+int RingMessageQueue::pulse() {
+	const int previous = state_;
+	state_ = ACE_Message_Queue_Base::PULSED;
+	wakeAll_();
+	return previous;
+}
+
+int RingMessageQueue::waitNotEmpty_(ACE_Time_Value* timeout) {
+	ACE_GUARD_RETURN(ACE_Thread_Mutex, waitGuard, waitLock_, -1);
+
+	// Announce the wait before the final check so a producer that publishes
+	// in between is guaranteed to see the flag and signal.
+	++consumerWaiting_;
+	__sync_synchronize();
+
+	int result = 0;
+
+	while ( tail_ == head_ ) {
+		// A deactivation that raced ahead of taking waitLock_ would otherwise be missed.
+		if ( state_ == ACE_Message_Queue_Base::DEACTIVATED ) {
+			errno = ESHUTDOWN;
+			result = -1;
+			break;
+		}
+
+		if ( notEmpty_.wait(timeout) == -1 ) {
+			if ( errno == ETIME ) errno = EWOULDBLOCK;
+			result = -1;
+			break;
+		}
+
+		if ( state_ != ACE_Message_Queue_Base::ACTIVATED ) {
+			errno = ( state_ == ACE_Message_Queue_Base::DEACTIVATED )? ESHUTDOWN : EWOULDBLOCK;
+			result = -1;
+			break;
+		}
+	}
+
+	--consumerWaiting_;
+	return result;
+}
+
+int RingMessageQueue::waitNotFull_(ACE_Time_Value* timeout) {
+	ACE_GUARD_RETURN(ACE_Thread_Mutex, waitGuard, waitLock_, -1);
+
+	++producerWaiting_;
+	__sync_synchronize();
+
+	int result = 0;
+
+	while ( isFull_() ) {
+		// A deactivation that raced ahead of taking waitLock_ would otherwise be missed.
+		if ( state_ == ACE_Message_Queue_Base::DEACTIVATED ) {
+			errno = ESHUTDOWN;
+			result = -1;
+			break;
+		}
+
+		if ( notFull_.wait(timeout) == -1 ) {
+			if ( errno == ETIME ) errno = EWOULDBLOCK;
+			result = -1;
+			break;
+		}
+
+		if ( state_ != ACE_Message_Queue_Base::ACTIVATED ) {
+			errno = ( state_ == ACE_Message_Queue_Base::DEACTIVATED )? ESHUTDOWN : EWOULDBLOCK;
+			result = -1;
+			break;
+		}
+	}
+
+	--producerWaiting_;
+	return result;
+}
+
+void RingMessageQueue::wakeAll_() {
+	ACE_GUARD(ACE_Thread_Mutex, waitGuard, waitLock_);
+	notEmpty_.broadcast();
+	notFull_.broadcast();
+}
+
+int RingMessageQueue::unsupported_(const char* opName) {
+	ND_ERROR("RingMessageQueue::%s() is not supported; the segment must use a standard message queue.\n",
+		opName);
+	errno = ENOTSUP;
+	return -1;
+}
+
+} // namespace nasaCE
@@ -0,0 +1,212 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   RingMessageQueue.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _NASA_RING_MESSAGE_QUEUE_HPP_
+#define _NASA_RING_MESSAGE_QUEUE_HPP_
+
+#include "AtomicSpinLock.hpp"
+
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Message_Queue_T.h>
+#include <ace/Thread_Mutex.h>
+
+namespace nasaCE {
+
+//=============================================================================
+/**
+ * @class RingMessageQueue
+ * @brief A bounded, FIFO-only message queue built on a lock-free ring.
+ *
+ * A drop-in replacement for a segment's ACE_Message_Queue when its primary
+ * input is fed by a single upstream segment. Units are handed across through
+ * a power-of-two array of slots; neither side takes a mutex or signals a
+ * condition unless the other side is actually asleep waiting on it.
+ *
+ * The high and low water marks behave as they do in ACE_Message_Queue: a
+ * producer blocks once the queued octets reach the high water mark, and is
+ * woken when the consumer drains them down to the low water mark. The queue
+ * is also full when every slot is occupied.
+ *
+ * Producers and consumers are each serialized by an uncontended spin lock,
+ * so a stray second writer (or a flush() from the control thread) is safe,
+ * just slower. Priority and deadline ordering are not supported; those
+ * calls fail with errno set to ENOTSUP.
+ */
+//=============================================================================
+class RingMessageQueue: public ACE_Message_Queue<ACE_MT_SYNCH> {
+public:
+	typedef ACE_Message_Queue<ACE_MT_SYNCH> baseType;
+
+	/// Primary constructor.
+	/// @param slotCount The most units the ring can hold; rounded up to a power of two.
+	/// @param hwm The high water mark, in octets.
+	/// @param lwm The low water mark, in octets.
+	RingMessageQueue(const size_t slotCount, const size_t hwm, const size_t lwm);
+
+	/// Destructor. Releases any units still queued.
+	virtual ~RingMessageQueue();
+
+	/// The number of slots in the ring.
+	size_t getSlotCount() const { return slotMask_ + 1; }
+
+	virtual int open(size_t hwm = ACE_Message_Queue_Base::DEFAULT_HWM,
+		size_t lwm = ACE_Message_Queue_Base::DEFAULT_LWM,
+		ACE_Notification_Strategy* ns = 0);
+
+	virtual int close();
+
+	virtual int flush();
+
+	virtual int enqueue_tail(ACE_Message_Block* new_item, ACE_Time_Value* timeout = 0);
+
+	virtual int dequeue_head(ACE_Message_Block*& first_item, ACE_Time_Value* timeout = 0);
+
+	virtual int dequeue(ACE_Message_Block*& first_item, ACE_Time_Value* timeout = 0) {
+		return dequeue_head(first_item, timeout);
+	}
+
+	virtual int peek_dequeue_head(ACE_Message_Block*& first_item, ACE_Time_Value* timeout = 0);
+
+	/// @brief Add several units with a single wakeup of the consumer.
+	/// Blocks like enqueue_tail() whenever the ring fills part way through.
+	/// @param items The units to add, in order.
+	/// @param itemCount The number of entries in items.
+	/// @param timeout Absolute time to give up waiting for room.
+	/// @return The number of units added (the rest are untouched), or -1 if none were.
+	int enqueueBatch(ACE_Message_Block** items, const size_t itemCount, ACE_Time_Value* timeout = 0);
+
+	/// @brief Remove up to maxItems units in one pass over the ring.
+	/// Blocks like dequeue_head() only while the ring is empty.
+	/// @param items Receives the units, in order.
+	/// @param maxItems The capacity of items.
+	/// @param timeout Absolute time to give up waiting for the first unit.
+	/// @return The number of units removed, or -1 if none were.
+	int dequeueBatch(ACE_Message_Block** items, const size_t maxItems, ACE_Time_Value* timeout = 0);
+
+	/// @name Unsupported ordering
+	/// These always fail with errno set to ENOTSUP.
+	//@{
+	virtual int enqueue(ACE_Message_Block* new_item, ACE_Time_Value* timeout = 0);
+	virtual int enqueue_prio(ACE_Message_Block* new_item, ACE_Time_Value* timeout = 0);
+	virtual int enqueue_head(ACE_Message_Block* new_item, ACE_Time_Value* timeout = 0);
+	virtual int enqueue_deadline(ACE_Message_Block* new_item, ACE_Time_Value* timeout = 0);
+	virtual int dequeue_prio(ACE_Message_Block*& first_item, ACE_Time_Value* timeout = 0);
+	virtual int dequeue_tail(ACE_Message_Block*& dequeued, ACE_Time_Value* timeout = 0);
+	virtual int dequeue_deadline(ACE_Message_Block*& dequeued, ACE_Time_Value* timeout = 0);
+	//@}
+
+	virtual bool is_full() { return isFull_(); }
+
+	virtual bool is_empty() { return tail_ == head_; }
+
+	virtual size_t message_bytes() { return bytes_; }
+
+	virtual size_t message_length() { return length_; }
+
+	virtual size_t message_count() { return tail_ - head_; }
+
+	virtual size_t high_water_mark() { return highWaterMark_; }
+
+	virtual void high_water_mark(size_t hwm);
+
+	virtual size_t low_water_mark() { return lowWaterMark_; }
+
+	virtual void low_water_mark(size_t lwm);
+
+	virtual int deactivate();
+
+	virtual int activate();
+
+	virtual int pulse();
+
+	virtual int state() { return state_; }
+
+	virtual bool deactivated() { return state_ == ACE_Message_Queue_Base::DEACTIVATED; }
+
+private:
+	/// The ring itself.
+	ACE_Message_Block** slots_;
+
+	/// One less than the number of slots, for masking indices.
+	size_t slotMask_;
+
+	/// Index of the next slot to read; only advanced by the consumer.
+	volatile size_t head_;
+
+	/// Keep head_ and tail_ on separate cache lines.
+	char headPad_[64 - sizeof(size_t)];
+
+	/// Index of the next slot to write; only advanced by the producer.
+	volatile size_t tail_;
+
+	/// Keep tail_ away from the fields below.
+	char tailPad_[64 - sizeof(size_t)];
+
+	/// Total of total_size() for all queued units, compared against the water marks.
+	volatile size_t bytes_;
+
+	/// Total of total_length() for all queued units.
+	volatile size_t length_;
+
+	/// Cached copy of the high water mark.
+	volatile size_t highWaterMark_;
+
+	/// Cached copy of the low water mark.
+	volatile size_t lowWaterMark_;
+
+	/// ACTIVATED, DEACTIVATED, or PULSED.
+	volatile int state_;
+
+	/// The number of consumers blocked waiting for a unit; only changed under waitLock_.
+	volatile int consumerWaiting_;
+
+	/// The number of producers blocked waiting for room; only changed under waitLock_.
+	volatile int producerWaiting_;
+
+	/// Serializes producers.
+	AtomicSpinLock producerLock_;
+
+	/// Serializes consumers.
+	AtomicSpinLock consumerLock_;
+
+	/// Only taken to sleep or to wake a sleeper.
+	ACE_Thread_Mutex waitLock_;
+
+	/// Signaled when a unit is added to an empty ring with a waiting consumer.
+	ACE_Condition_Thread_Mutex notEmpty_;
+
+	/// Signaled when the ring drains to the low water mark with a waiting producer.
+	ACE_Condition_Thread_Mutex notFull_;
+
+	/// True if either the slots or the high water mark are exhausted.
+	bool isFull_() const { return ( tail_ - head_ > slotMask_ ) || ( bytes_ >= highWaterMark_ ); }
+
+	/// Block until the ring has a unit, the timeout passes, or the state changes.
+	/// @return 0 if a unit may be available, -1 with errno set otherwise.
+	int waitNotEmpty_(ACE_Time_Value* timeout);
+
+	/// Block until the ring has room, the timeout passes, or the state changes.
+	/// @return 0 if there may be room, -1 with errno set otherwise.
+	int waitNotFull_(ACE_Time_Value* timeout);
+
+	/// Wake every sleeping producer and consumer.
+	void wakeAll_();
+
+	/// Set errno for an unsupported operation and return -1.
+	int unsupported_(const char* opName);
+};
+
+} // namespace nasaCE
+
+#endif // _NASA_RING_MESSAGE_QUEUE_HPP_
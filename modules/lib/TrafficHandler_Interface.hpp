@@ -242,6 +242,15 @@ public:
 
 	GENERATE_INT_ACCESSORS(mru, setMRU, getMRU);
 	GENERATE_INT_ACCESSORS(mtu, setMTU, getMTU);
+	GENERATE_INT_ACCESSORS(reserved_headroom, setReservedHeadroom, getReservedHeadroom);
+	GENERATE_INT_ACCESSORS(reserved_tailroom, setReservedTailroom, getReservedTailroom);
+	GENERATE_INT_ACCESSORS(max_batch_units, setMaxBatchUnits, getMaxBatchUnits);
+	GENERATE_BOOL_ACCESSORS(run_inline, setRunInline, getRunInline);
+	GENERATE_BOOL_ACCESSORS(use_worker_pool, setUseWorkerPool, getUseWorkerPool);
+	GENERATE_STRING_ACCESSORS(cpu_affinity, setCpuAffinity, getCpuAffinity);
+	GENERATE_STRING_ACCESSORS(sched_policy, setSchedPolicy, getSchedPolicy);
+	GENERATE_INT_ACCESSORS(sched_priority, setSchedPriority, getSchedPriority);
+	GENERATE_INT_ACCESSORS(numa_node, setNumaNode, getNumaNode);
 
 	virtual void get_low_water_mark(xmlrpc_c::paramList const& paramList, xmlrpc_c::value* retvalP) {
 		ACE_TRACE("TrafficHandler_Interface::get_low_water_mark");
@@ -377,6 +386,9 @@ protected:
 		counters["receivedOctets"] = xmlrpc_c::value_i8(handler->getReceivedOctetCount());
 		counters["queuedUnits"] = xmlrpc_c::value_int(handler->getQueuedUnitCount());
 		counters["queuedOctets"] = xmlrpc_c::value_int(handler->getQueuedOctetCount());
+		// The buffer pool is shared by every segment in the process.
+		counters["globalBufferPoolHits"] = xmlrpc_c::value_i8(NetworkDataPool::instance()->getHitCount());
+		counters["globalBufferPoolMisses"] = xmlrpc_c::value_i8(NetworkDataPool::instance()->getMissCount());
 
 		if (handler->getAuxQueue()) {
 			counters["auxReceivedUnits"] =
@@ -397,6 +409,21 @@ protected:
 		settings["lowWaterMark"] = xmlrpc_c::value_int(handler->msg_queue()->low_water_mark());
 		settings["MRU"] = xmlrpc_c::value_int(handler->getMRU());
 		settings["MTU"] = xmlrpc_c::value_int(handler->getMTU());
+		settings["reservedHeadroom"] = xmlrpc_c::value_int(handler->getReservedHeadroom());
+		settings["reservedTailroom"] = xmlrpc_c::value_int(handler->getReservedTailroom());
+		settings["ringQueueSlots"] = xmlrpc_c::value_int(handler->getRingQueueSlots());
+		settings["maxBatchUnits"] = xmlrpc_c::value_int(handler->getMaxBatchUnits());
+		settings["runInline"] = xmlrpc_c::value_boolean(handler->getRunInline());
+		settings["processingInline"] = xmlrpc_c::value_boolean(handler->isInline());
+		settings["useWorkerPool"] = xmlrpc_c::value_boolean(handler->getUseWorkerPool());
+		settings["executionMode"] = xmlrpc_c::value_string(handler->getExecutionModeStr());
+		settings["cpuAffinity"] = xmlrpc_c::value_string(handler->getCpuAffinity());
+		settings["schedPolicy"] = xmlrpc_c::value_string(handler->getSchedPolicy());
+		settings["schedPriority"] = xmlrpc_c::value_int(handler->getSchedPriority());
+		settings["numaNode"] = xmlrpc_c::value_int(handler->getNumaNode());
+		settings["effectiveCpuAffinity"] = xmlrpc_c::value_string(handler->getEffectivePlacement().getCpuList());
+		settings["effectiveSchedPolicy"] = xmlrpc_c::value_string(handler->getEffectivePlacement().getPolicyStr());
+		settings["effectiveSchedPriority"] = xmlrpc_c::value_int(handler->getEffectivePlacement().getPriority());
 		settings["processing"] = xmlrpc_c::value_boolean(handler->continueService());
 	}
 
@@ -510,6 +537,78 @@ METHOD_CLASS2(derived_type, set_mtu , "n:ssi",\
 	"Set the the maximum receive unit (MTU) value.",\
 	pointer_name) \
 \
+METHOD_CLASS2(derived_type, get_reserved_headroom , "i:ss",\
+	"Get the number of octets reserved in front of new units for later headers.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, set_reserved_headroom , "n:ssi",\
+	"Set the number of octets reserved in front of new units for later headers.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, get_reserved_tailroom , "i:ss",\
+	"Get the number of octets reserved after new units for later trailers.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, set_reserved_tailroom , "n:ssi",\
+	"Set the number of octets reserved after new units for later trailers.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, get_max_batch_units , "i:ss",\
+	"Get the most units the segment takes from its queue at once.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, set_max_batch_units , "n:ssi",\
+	"Set the most units the segment takes from its queue at once.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, get_run_inline , "b:ss",\
+	"Get whether the segment processes units on the sender's thread when opened.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, set_run_inline , "n:ssb",\
+	"Set whether the segment processes units on the sender's thread when next opened.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, get_use_worker_pool , "b:ss",\
+	"Get whether the segment runs as a task on the shared worker pool when opened.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, set_use_worker_pool , "n:ssb",\
+	"Set whether the segment runs as a task on the shared worker pool when next opened.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, get_cpu_affinity , "s:ss",\
+	"Get the list of CPUs the segment's thread may run on.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, set_cpu_affinity , "n:sss",\
+	"Set the list of CPUs the segment's thread may run on, e.g. 0-3,8.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, get_sched_policy , "s:ss",\
+	"Get the scheduling policy of the segment's thread (other, fifo, or rr).",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, set_sched_policy , "n:sss",\
+	"Set the scheduling policy of the segment's thread (other, fifo, or rr).",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, get_sched_priority , "i:ss",\
+	"Get the real-time priority of the segment's thread.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, set_sched_priority , "n:ssi",\
+	"Set the real-time priority of the segment's thread.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, get_numa_node , "i:ss",\
+	"Get the NUMA node the segment's thread runs on, or -1.",\
+	pointer_name) \
+\
+METHOD_CLASS2(derived_type, set_numa_node , "n:ssi",\
+	"Set the NUMA node the segment's thread runs on, or -1 for none.",\
+	pointer_name) \
+\
 METHOD_CLASS2(derived_type, get_low_water_mark , "i:ss",\
 	"Get the point at which the handler accepts new data again after hitting the high water mark.",\
 	pointer_name) \
@@ -612,6 +711,24 @@ extern "C" void deactivate() {\
 	REGISTER_METHOD(derived_type##_set_mru , #prefix ".setMRU");\
 	REGISTER_METHOD(derived_type##_get_mtu , #prefix ".getMTU");\
 	REGISTER_METHOD(derived_type##_set_mtu , #prefix ".setMTU");\
+	REGISTER_METHOD(derived_type##_get_reserved_headroom , #prefix ".getReservedHeadroom");\
+	REGISTER_METHOD(derived_type##_set_reserved_headroom , #prefix ".setReservedHeadroom");\
+	REGISTER_METHOD(derived_type##_get_reserved_tailroom , #prefix ".getReservedTailroom");\
+	REGISTER_METHOD(derived_type##_set_reserved_tailroom , #prefix ".setReservedTailroom");\
+	REGISTER_METHOD(derived_type##_get_max_batch_units , #prefix ".getMaxBatchUnits");\
+	REGISTER_METHOD(derived_type##_set_max_batch_units , #prefix ".setMaxBatchUnits");\
+	REGISTER_METHOD(derived_type##_get_run_inline , #prefix ".getRunInline");\
+	REGISTER_METHOD(derived_type##_set_run_inline , #prefix ".setRunInline");\
+	REGISTER_METHOD(derived_type##_get_use_worker_pool , #prefix ".getUseWorkerPool");\
+	REGISTER_METHOD(derived_type##_set_use_worker_pool , #prefix ".setUseWorkerPool");\
+	REGISTER_METHOD(derived_type##_get_cpu_affinity , #prefix ".getCpuAffinity");\
+	REGISTER_METHOD(derived_type##_set_cpu_affinity , #prefix ".setCpuAffinity");\
+	REGISTER_METHOD(derived_type##_get_sched_policy , #prefix ".getSchedPolicy");\
+	REGISTER_METHOD(derived_type##_set_sched_policy , #prefix ".setSchedPolicy");\
+	REGISTER_METHOD(derived_type##_get_sched_priority , #prefix ".getSchedPriority");\
+	REGISTER_METHOD(derived_type##_set_sched_priority , #prefix ".setSchedPriority");\
+	REGISTER_METHOD(derived_type##_get_numa_node , #prefix ".getNumaNode");\
+	REGISTER_METHOD(derived_type##_set_numa_node , #prefix ".setNumaNode");\
 	REGISTER_METHOD(derived_type##_get_low_water_mark , #prefix ".getLowWaterMark");\
 	REGISTER_METHOD(derived_type##_set_low_water_mark , #prefix ".setLowWaterMark");\
 	REGISTER_METHOD(derived_type##_get_high_water_mark , #prefix ".getHighWaterMark");\
@@ -0,0 +1,214 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   WorkerPool.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#include "WorkerPool.hpp"
+#include "CE_Config.hpp"
+#include "ClockService.hpp"
+#include "SettingsManager.hpp"
+
+#include <ace/Guard_T.h>
+#include <ace/OS_NS_unistd.h>
+#include <ace/Thread_Manager.h>
+
+namespace nasaCE {
+
+/// The index of the calling thread's deque, or -1 outside the pool.
+static __thread int workerIndex_ = -1;
+
+/// Passed to each new worker thread.
+struct WorkerStart {
+	WorkerPool* pool;
+	int index;
+};
+
+WorkerPool::WorkerPool(const size_t threadCount):
+	pending_(0),
+	sleepers_(0),
+	nextWorker_(0),
+	executedCount_(0),
+	stolenCount_(0),
+	wakeup_(sleepLock_) {
+
+	for ( size_t idx = 0; idx < threadCount; ++idx ) workers_.push_back(new Worker);
+
+	for ( size_t idx = 0; idx < threadCount; ++idx ) {
+		WorkerStart* start = new WorkerStart;
+		start->pool = this;
+		start->index = static_cast<int>(idx);
+
+		if ( ACE_Thread_Manager::instance()->spawn(workerLoop_, start, THR_JOINABLE | THR_SCOPE_SYSTEM) == -1 ) {
+			ND_ERROR("[WorkerPool] Unable to spawn worker thread %d.\n", idx);
+			delete start;
+		}
+	}
+
+	ND_INFO("[WorkerPool] Started %d worker threads.\n", threadCount);
+}
+
+WorkerPool* WorkerPool::instance() {
+	// Deliberately leaked; it has to outlive every segment that submits to it.
+	static WorkerPool* volatile pool = 0;
+	static ACE_Thread_Mutex startLock;
+
+	if ( ! pool ) {
+		ACE_Guard<ACE_Thread_Mutex> guard(startLock);
+
+		if ( ! pool ) {
+			int threads = 0;
+
+			if ( CEcfg::instance()->existsSrv("workerThreads") )
+				threads = CEcfg::instance()->getSrv("workerThreads");
+
+			if ( threads < 1 ) threads = ACE_OS::num_processors();
+			if ( threads < 1 ) threads = 1;
+
+			WorkerPool* newPool = new WorkerPool(threads);
+			__sync_synchronize();
+			pool = newPool;
+		}
+	}
+
+	return pool;
+}
+
+void WorkerPool::submit(Task* task) {
+	const size_t idx = ( workerIndex_ >= 0 )? static_cast<size_t>(workerIndex_) :
+		__sync_fetch_and_add(&nextWorker_, 1) % workers_.size();
+
+	Worker* worker = workers_[idx];
+
+	worker->lock.acquire();
+	worker->tasks.push_back(task);
+	worker->lock.release();
+
+	__sync_fetch_and_add(&pending_, 1);
+
+	// Pairs with the barrier in workerLoop_() so a worker going to sleep
+	// either sees the new task or is seen as a sleeper here.
+	__sync_synchronize();
+
+	if ( sleepers_ > 0 ) {
+		ACE_Guard<ACE_Thread_Mutex> guard(sleepLock_);
+		wakeup_.signal();
+	}
+}
+
+bool WorkerPool::cancel(Task* task) {
+	long removed = 0;
+
+	for ( size_t idx = 0; idx < workers_.size(); ++idx ) {
+		Worker* worker = workers_[idx];
+
+		worker->lock.acquire();
+		for ( std::deque<Task*>::iterator pos = worker->tasks.begin(); pos != worker->tasks.end(); ) {
+			if ( *pos == task ) {
+				pos = worker->tasks.erase(pos);
+				++removed;
+			}
+			else ++pos;
+		}
+		worker->lock.release();
+	}
+
+	if ( removed ) __sync_fetch_and_sub(&pending_, removed);
+
+	return ( removed > 0 );
+}
+
+bool WorkerPool::runOne() {
+	if ( workerIndex_ < 0 ) return false;
+
+	Task* task = take_(workerIndex_);
+	if ( ! task ) return false;
+
+	run_(task);
+	return true;
+}
+
+bool WorkerPool::onWorkerThread() {
+	return ( workerIndex_ >= 0 );
+}
+
+WorkerPool::Task* WorkerPool::take_(const size_t self) {
+	if ( pending_ <= 0 ) return 0;
+
+	Task* task = 0;
+	Worker* own = workers_[self];
+
+	own->lock.acquire();
+	if ( ! own->tasks.empty() ) {
+		task = own->tasks.front();
+		own->tasks.pop_front();
+	}
+	own->lock.release();
+
+	for ( size_t offset = 1; ! task && offset < workers_.size(); ++offset ) {
+		Worker* victim = workers_[(self + offset) % workers_.size()];
+
+		if ( victim->lock.tryacquire() == -1 ) continue;
+
+		if ( ! victim->tasks.empty() ) {
+			task = victim->tasks.back();
+			victim->tasks.pop_back();
+			__sync_fetch_and_add(&stolenCount_, 1);
+		}
+
+		victim->lock.release();
+	}
+
+	if ( task ) __sync_fetch_and_sub(&pending_, 1);
+
+	return task;
+}
+
+void WorkerPool::run_(Task* task) {
+	task->runPoolTask();
+	__sync_fetch_and_add(&executedCount_, 1);
+}
+
+ACE_THR_FUNC_RETURN WorkerPool::workerLoop_(void* arg) {
+	WorkerStart* start = static_cast<WorkerStart*>(arg);
+	WorkerPool* pool = start->pool;
+	const size_t self = start->index;
+	delete start;
+
+	workerIndex_ = static_cast<int>(self);
+
+	// Wake up periodically regardless, to notice exit_requested.
+	const ACE_Time_Value idleWait(0, 100000);
+
+	while ( ! exit_requested ) {
+		Task* task = pool->take_(self);
+
+		if ( task ) {
+			pool->run_(task);
+			continue;
+		}
+
+		ACE_Guard<ACE_Thread_Mutex> guard(pool->sleepLock_);
+		++pool->sleepers_;
+		__sync_synchronize();
+
+		if ( pool->pending_ <= 0 ) {
+			ACE_Time_Value deadline(ClockService::instance()->preciseNow() + idleWait);
+			pool->wakeup_.wait(&deadline);
+		}
+
+		--pool->sleepers_;
+	}
+
+	return 0;
+}
+
+} // namespace nasaCE
@@ -0,0 +1,136 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   WorkerPool.hpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+#ifndef _NASA_WORKER_POOL_HPP_
+#define _NASA_WORKER_POOL_HPP_
+
+#include "AtomicSpinLock.hpp"
+
+#include <ace/Basic_Types.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Thread_Mutex.h>
+#include <deque>
+#include <vector>
+
+namespace nasaCE {
+
+//=============================================================================
+/**
+ * @class WorkerPool
+ * @brief A fixed set of threads that run short tasks for many segments.
+ *
+ * Each worker has its own task deque. A task submitted from a worker goes on
+ * that worker's deque, otherwise the deques are filled round-robin. A worker
+ * takes from the front of its own deque, and when that is empty it steals
+ * from the back of another's before going to sleep.
+ *
+ * The pool makes no promise about which worker runs a task. A task must
+ * therefore not be submitted again until its previous run has started; see
+ * BaseTrafficHandler for how segments guarantee that. A task that is about
+ * to be destroyed can be withdrawn with cancel() if it is still queued.
+ *
+ * Workers exit once exit_requested is set.
+ */
+//=============================================================================
+class WorkerPool {
+public:
+	/// @class Task
+	/// @brief Something the pool can run. Must return promptly rather than block.
+	class Task {
+	public:
+		virtual ~Task() { }
+
+		/// Do one bounded slice of work.
+		virtual void runPoolTask() = 0;
+	};
+
+	/// @brief The process-wide pool, started on first use.
+	/// Sized by the workerThreads server setting, or the number of CPUs if unset.
+	/// Never destroyed, since segments may be unloaded in any order.
+	static WorkerPool* instance();
+
+	/// Queue a task to be run by some worker.
+	void submit(Task* task);
+
+	/// @brief Withdraw a task that has been submitted but not yet taken by a worker.
+	/// @return True if the task was found and removed.
+	bool cancel(Task* task);
+
+	/// @brief Run one queued task on the calling thread, if there is one.
+	/// Lets a worker that would otherwise block on a full queue help drain it.
+	/// @return True if a task was run.
+	bool runOne();
+
+	/// True if the calling thread is one of the pool's workers.
+	static bool onWorkerThread();
+
+	/// The number of worker threads.
+	size_t getThreadCount() const { return workers_.size(); }
+
+	/// The total number of tasks run.
+	ACE_UINT64 getExecutedCount() const { return executedCount_; }
+
+	/// The number of tasks a worker took from another worker's deque.
+	ACE_UINT64 getStolenCount() const { return stolenCount_; }
+
+private:
+	/// Spawn threadCount workers.
+	explicit WorkerPool(const size_t threadCount);
+
+	/// One worker's deque, kept apart from its neighbors' cache lines.
+	struct Worker {
+		AtomicSpinLock lock;
+		std::deque<Task*> tasks;
+		char pad[64];
+	};
+
+	/// One per thread.
+	std::vector<Worker*> workers_;
+
+	/// The number of tasks waiting in all deques.
+	volatile long pending_;
+
+	/// The number of workers asleep on wakeup_; only changed under sleepLock_.
+	volatile int sleepers_;
+
+	/// Selects the deque for submissions from outside the pool.
+	volatile unsigned long nextWorker_;
+
+	/// Total of tasks run.
+	volatile ACE_UINT64 executedCount_;
+
+	/// Total of tasks stolen.
+	volatile ACE_UINT64 stolenCount_;
+
+	/// Only taken to sleep or to wake a sleeper.
+	ACE_Thread_Mutex sleepLock_;
+
+	/// Signaled when a task is submitted while a worker sleeps.
+	ACE_Condition_Thread_Mutex wakeup_;
+
+	/// Take a task from worker self's deque, or steal one from another.
+	/// @param self The index of the caller's deque.
+	/// @return A task, or null if every deque is empty.
+	Task* take_(const size_t self);
+
+	/// Run a task and count it.
+	void run_(Task* task);
+
+	/// The main loop of each worker thread.
+	static ACE_THR_FUNC_RETURN workerLoop_(void* arg);
+};
+
+} // namespace nasaCE
+
+#endif // _NASA_WORKER_POOL_HPP_
@@ -128,8 +128,47 @@ void Channel::activate() {
 
 	HandlerMap::iterator pos;
 
+	// Start inline segments first, so that no upstream thread queues units
+	// for them that nothing would ever dequeue.
 	for ( pos = _handlers.begin(); pos != _handlers.end(); ++pos ) {
-		pos->second->open();
+		if ( pos->second->getRunInline() ) pos->second->open();
+	}
+
+	for ( pos = _handlers.begin(); pos != _handlers.end(); ++pos ) {
+		if ( ! pos->second->getRunInline() ) pos->second->open();
+	}
+
+	std::vector<std::string> runs;
+	getInlineRuns(runs);
+
+	for ( size_t idx = 0; idx < runs.size(); ++idx ) {
+		ND_INFO("[%s] Running on one thread: %s.\n", getName().c_str(), runs[idx].c_str());
+	}
+}
+
+void Channel::getInlineRuns(std::vector<std::string>& runs) {
+	runs.clear();
+
+	HandlerMap::iterator pos;
+
+	for ( pos = _handlers.begin(); pos != _handlers.end(); ++pos ) {
+		BaseTrafficHandler* source = pos->second;
+		if ( source->isInline() ) continue;
+
+		const BaseTrafficHandler::LinkType outputs[] = {
+			BaseTrafficHandler::PrimaryOutputLink, BaseTrafficHandler::AuxOutputLink };
+
+		for ( int out = 0; out < 2; ++out ) {
+			std::string run;
+			HandlerLink* link = source->getLink(outputs[out]);
+
+			while ( link && link->targetInputIsPrimary() && link->getTarget()->isInline() ) {
+				run += " -> " + link->getTarget()->getName();
+				link = link->getTarget()->getLink(BaseTrafficHandler::PrimaryOutputLink);
+			}
+
+			if ( ! run.empty() ) runs.push_back(source->getName() + run);
+		}
 	}
 }
 
@@ -22,6 +22,7 @@
 #include "XML_RPC_Server.hpp"
 #include <string>
 #include <map>
+#include <vector>
 
 namespace nasaCE {
 
@@ -182,6 +183,13 @@ public:
 	/// Does <b>not</b> affect the hardware devices.
 	void activate();
 
+	/// @brief Describe each chain of segments that run inline on another segment's thread.
+	///
+	/// Each entry looks like "source -> inline1 -> inline2", where source owns the thread.
+	/// Only primary and auxiliary outputs are followed.
+	/// @param runs Cleared, then filled with one entry per chain.
+	void getInlineRuns(std::vector<std::string>& runs);
+
 	/// @brief Iterate through the map of handlers and stop traffic in each one.
 	///
 	/// Order is random, so each handler must detect whether its target is unavailable.
@@ -16,6 +16,8 @@
 #include "XML_RPC_Server.hpp"
 #include "ChannelRegistry.hpp"
 #include "SettingsManager.hpp"
+#include "ClockService.hpp"
+#include "ThreadPlacement.hpp"
 
 #include <ace/Arg_Shifter.h>
 #include <ace/Local_Memory_Pool.h>
@@ -272,6 +274,19 @@ int parseCommandLine(int argc, ACE_TCHAR* argv[]) {
 		CEcfg::instance()->setSaveFlag(static_cast<bool>(CEcfg::instance()->getSrv("saveCfgAtExit")));
 	}
 
+	if ( CEcfg::instance()->existsSrv("clockPrecision") ) {
+		const std::string precision(CEcfg::instance()->getSrv("clockPrecision").c_str());
+
+		try {
+			ClockService::instance()->setPrecision(precision);
+			ND_INFO("[Main] Using %s clock for time stamps.\n", precision.c_str());
+		}
+		catch (const BadValue& e) {
+			ACE_ERROR((LM_WARNING, "[Main] %s Keeping %s clock.\n", e.what(),
+				ClockService::instance()->getPrecisionStr().c_str()));
+		}
+	}
+
 	// If protected interfaces were not specified on the command line, check the server config file.
 	if ( ! cl_protect && CEcfg::instance()->existsSrv("protectedEthInterfaces")) {
 		Setting& protIfaces = CEcfg::instance()->getSrv("protectedEthInterfaces");
@@ -377,9 +392,49 @@ void savePid(std::string& pidFileName) {
 
 using namespace nasaCE;
 
+/// CPU, scheduling, and NUMA placement for the reactor threads.
+static ThreadPlacement reactorPlacement;
+
+/// Fill reactorPlacement from the reactor* server settings.
+static void readReactorPlacement() {
+	// Each setting is tried on its own so one bad value doesn't discard the rest.
+	try {
+		if ( CEcfg::instance()->existsSrv("reactorCpuAffinity") )
+			reactorPlacement.setCpuList(CEcfg::instance()->getSrv("reactorCpuAffinity").c_str());
+	}
+	catch (const nd_error& e) {
+		ACE_ERROR((LM_WARNING, "[Main] Ignoring the reactor CPU affinity: %s\n", e.what()));
+	}
+
+	try {
+		if ( CEcfg::instance()->existsSrv("reactorSchedPolicy") )
+			reactorPlacement.setPolicy(CEcfg::instance()->getSrv("reactorSchedPolicy").c_str());
+
+		if ( CEcfg::instance()->existsSrv("reactorSchedPriority") )
+			reactorPlacement.setPriority(CEcfg::instance()->getSrv("reactorSchedPriority"));
+	}
+	catch (const nd_error& e) {
+		ACE_ERROR((LM_WARNING, "[Main] Ignoring part of the reactor scheduling settings: %s\n", e.what()));
+	}
+
+	try {
+		if ( CEcfg::instance()->existsSrv("reactorNumaNode") )
+			reactorPlacement.setNumaNode(CEcfg::instance()->getSrv("reactorNumaNode"));
+	}
+	catch (const nd_error& e) {
+		ACE_ERROR((LM_WARNING, "[Main] Ignoring the reactor NUMA node: %s\n", e.what()));
+	}
+}
+
 static ACE_THR_FUNC_RETURN eventLoop(void* arg) {
 	ACE_Reactor *reactor = static_cast<ACE_Reactor *>(arg);
 
+	if ( ! reactorPlacement.isDefault() ) {
+		std::string problems;
+		if ( ! reactorPlacement.applyToSelf(problems) )
+			ACE_ERROR((LM_WARNING, "[Main] Reactor thread placement was only partly applied: %s\n", problems.c_str()));
+	}
+
 	reactor->owner(ACE_OS::thr_self());
 	reactor->run_reactor_event_loop();
 	return 0;
@@ -428,6 +483,8 @@ int ACE_TMAIN(int argc, ACE_TCHAR* argv[]) {
 		reactorThreads = CEcfg::instance()->getSrv("reactorThreads");
 	}
 
+	readReactorPlacement();
+
 	ND_INFO("[Main] Spawning %d threads to handle reactor events.\n", reactorThreads);
 	ACE_Thread_Manager::instance()->spawn_n(reactorThreads, eventLoop, ACE_Reactor::instance());
 
@@ -0,0 +1,276 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   asm_correlator_test.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+// Checks AsmCorrelator against bit-by-bit reference results. Exits non-zero
+// if any check fails.
+
+#include "AsmCorrelator.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace nasaCE;
+using namespace std;
+
+typedef vector<ACE_UINT8> Octets;
+
+const ACE_UINT8 ccsdsAsm[] = { 0x1A, 0xCF, 0xFC, 0x1D };
+const size_t asmBits = sizeof(ccsdsAsm) * 8;
+
+int failures = 0;
+
+void check(const bool ok, const string& what) {
+	if ( ok ) return;
+	++failures;
+	cout << "FAIL: " << what << endl;
+}
+
+string describe(const string& what, const size_t value) {
+	ostringstream os;
+	os << what << " " << value;
+	return os.str();
+}
+
+Octets randomOctets(const size_t len) {
+	Octets buf(len);
+	for ( size_t i = 0; i < len; ++i ) buf[i] = lrand48() & 0xff;
+	return buf;
+}
+
+bool getBit(const Octets& buf, const size_t pos) {
+	return ( buf[pos / 8] >> (7 - pos % 8) ) & 1;
+}
+
+void setBit(Octets& buf, const size_t pos, const bool val) {
+	const ACE_UINT8 mask = 1 << (7 - pos % 8);
+	if ( val ) buf[pos / 8] |= mask;
+	else buf[pos / 8] &= ~mask;
+}
+
+/// Write the marker into buf starting at a bit position, optionally complemented.
+void placeMarker(Octets& buf, const size_t bitPos, const bool inverted) {
+	for ( size_t k = 0; k < asmBits; ++k ) {
+		const bool bit = ( ccsdsAsm[k / 8] >> (7 - k % 8) ) & 1;
+		setBit(buf, bitPos + k, bit != inverted);
+	}
+}
+
+/// A stream of random octets with no chance match of the marker or its complement.
+Octets quietStream(const size_t len) {
+	AsmCorrelator probe;
+	probe.setPattern(ccsdsAsm, sizeof(ccsdsAsm));
+	probe.setAllowedBitErrors(4);
+	probe.setAcceptInverted(true);
+
+	Octets buf;
+	AsmCorrelator::Match match;
+
+	do {
+		buf = randomOctets(len);
+		probe.reset();
+	} while ( probe.search(&buf[0], buf.size(), match) );
+
+	return buf;
+}
+
+AsmCorrelator::Match runSearch(const Octets& buf, const unsigned allowed, const bool acceptInverted, bool& found) {
+	AsmCorrelator correlator;
+	correlator.setPattern(ccsdsAsm, sizeof(ccsdsAsm));
+	correlator.setAllowedBitErrors(allowed);
+	correlator.setAcceptInverted(acceptInverted);
+
+	AsmCorrelator::Match match;
+	found = correlator.search(&buf[0], buf.size(), match);
+	return match;
+}
+
+// -- SEARCH ------------------------------------------------------------------
+
+void testBitOffsets() {
+	for ( size_t offset = 0; offset < 8; ++offset ) {
+		Octets buf = quietStream(64);
+		const size_t start = 10 * 8 + offset;
+		placeMarker(buf, start, false);
+
+		bool found;
+		const AsmCorrelator::Match match = runSearch(buf, 0, false, found);
+		const string name = describe("bit offset", offset);
+
+		check(found, name + ": marker not found");
+		if ( ! found ) continue;
+
+		check(match.endOctet == (start + asmBits - 1) / 8, name + ": wrong end octet");
+		check(match.shift == (start + asmBits) % 8, name + ": wrong shift");
+		check(! match.inverted, name + ": reported as inverted");
+		check(match.bitErrors == 0, name + ": reported bit errors");
+	}
+}
+
+void testSplitBuffers() {
+	for ( size_t offset = 0; offset < 8; ++offset ) {
+		Octets buf = quietStream(64);
+		const size_t start = 30 * 8 + offset;
+		placeMarker(buf, start, false);
+
+		AsmCorrelator correlator;
+		correlator.setPattern(ccsdsAsm, sizeof(ccsdsAsm));
+
+		// Split the stream in the middle of the marker.
+		const size_t split = 32;
+		AsmCorrelator::Match match;
+		const string name = describe("split at bit offset", offset);
+
+		check(! correlator.search(&buf[0], split, match), name + ": found in the first part");
+		check(correlator.search(&buf[split], buf.size() - split, match), name + ": not found in the second part");
+		check(split + match.endOctet == (start + asmBits - 1) / 8, name + ": wrong end octet");
+	}
+}
+
+void testInverted() {
+	for ( size_t offset = 0; offset < 8; ++offset ) {
+		Octets buf = quietStream(64);
+		placeMarker(buf, 20 * 8 + offset, true);
+		const string name = describe("inverted marker at bit offset", offset);
+
+		bool found;
+		runSearch(buf, 0, false, found);
+		check(! found, name + ": found while inverted markers are off");
+
+		const AsmCorrelator::Match match = runSearch(buf, 0, true, found);
+		check(found, name + ": not found while inverted markers are on");
+		check(found && match.inverted, name + ": not reported as inverted");
+		check(found && match.shift == (20 * 8 + offset + asmBits) % 8, name + ": wrong shift");
+	}
+}
+
+void testErrorThresholds() {
+	for ( unsigned errs = 1; errs <= 6; ++errs ) {
+		Octets buf = quietStream(64);
+		const size_t start = 12 * 8 + errs % 8;
+		placeMarker(buf, start, false);
+
+		// Flip errs distinct marker bits.
+		vector<bool> flipped(asmBits, false);
+		for ( unsigned e = 0; e < errs; ) {
+			const size_t k = lrand48() % asmBits;
+			if ( flipped[k] ) continue;
+			flipped[k] = true;
+			setBit(buf, start + k, ! getBit(buf, start + k));
+			++e;
+		}
+
+		const string name = describe("marker with bit errors:", errs);
+		bool found;
+
+		const AsmCorrelator::Match match = runSearch(buf, errs, false, found);
+		check(found, name + ": not found at the threshold");
+		check(found && match.bitErrors == errs, name + ": wrong error count");
+
+		runSearch(buf, errs - 1, false, found);
+		check(! found, name + ": found below the threshold");
+
+		AsmCorrelator correlator;
+		correlator.setPattern(ccsdsAsm, sizeof(ccsdsAsm));
+		check(correlator.bitErrorsAt(&buf[0], buf.size(), start, false) == errs, name + ": bitErrorsAt() disagrees");
+		check(correlator.bitErrorsAt(&buf[0], buf.size(), start, true) == asmBits - errs,
+			name + ": inverted bitErrorsAt() disagrees");
+	}
+}
+
+// -- REALIGNMENT -------------------------------------------------------------
+
+/// Bit-by-bit realign(): output bit k is stream bit k + shift, counting the carry octet first.
+Octets refRealign(const Octets& src, const unsigned shift, const bool invert, const ACE_UINT8 carry) {
+	Octets stream(1, carry);
+	stream.insert(stream.end(), src.begin(), src.end());
+
+	Octets out(src.size(), 0);
+	const size_t skip = ( shift == 0 )? 8 : shift;
+
+	for ( size_t k = 0; k < src.size() * 8; ++k ) setBit(out, k, getBit(stream, k + skip) != invert);
+
+	return out;
+}
+
+void testRealign() {
+	const bool haveAVX2 = AsmCorrelator::getUseAVX2();
+	const size_t lengths[] = { 0, 1, 7, 8, 9, 31, 32, 33, 63, 64, 65, 100, 1115 };
+
+	cout << "realign() AVX2 path: " << ( haveAVX2? "available" : "not available" ) << endl;
+
+	for ( size_t idx = 0; idx < sizeof(lengths) / sizeof(size_t); ++idx ) {
+		const size_t len = lengths[idx];
+
+		for ( unsigned shift = 0; shift < 8; ++shift ) {
+			for ( int invert = 0; invert <= 1; ++invert ) {
+				const Octets src = randomOctets(len);
+				const ACE_UINT8 carryIn = lrand48() & 0xff;
+				const Octets ref = refRealign(src, shift, invert, carryIn);
+				const ACE_UINT8 refCarry = len? src[len - 1] : carryIn;
+
+				ostringstream os;
+				os << "realign len " << len << " shift " << shift << ( invert? " inverted" : "" );
+				const string name = os.str();
+
+				Octets scalar(len + 1), simd(len + 1), inPlace(src);
+				ACE_UINT8 scalarCarry = carryIn, simdCarry = carryIn, inPlaceCarry = carryIn;
+
+				AsmCorrelator::setUseAVX2(false);
+				AsmCorrelator::realign(&scalar[0], len? &src[0] : 0, len, shift, invert, scalarCarry);
+				scalar.resize(len);
+
+				AsmCorrelator::setUseAVX2(haveAVX2);
+				AsmCorrelator::realign(&simd[0], len? &src[0] : 0, len, shift, invert, simdCarry);
+				simd.resize(len);
+
+				if ( len ) AsmCorrelator::realign(&inPlace[0], &inPlace[0], len, shift, invert, inPlaceCarry);
+
+				check(scalar == ref, name + ": portable output differs from reference");
+				check(scalarCarry == refCarry, name + ": portable carry differs from reference");
+				check(simd == scalar, name + ": AVX2 output differs from portable");
+				check(simdCarry == scalarCarry, name + ": AVX2 carry differs from portable");
+				check(inPlace == ref, name + ": in-place output differs from reference");
+			}
+		}
+	}
+
+	// Successive calls must continue the same bit stream.
+	const Octets src = randomOctets(200);
+	const Octets ref = refRealign(src, 3, false, 0);
+	Octets out(src.size());
+	ACE_UINT8 carry = 0;
+
+	AsmCorrelator::realign(&out[0], &src[0], 77, 3, false, carry);
+	AsmCorrelator::realign(&out[77], &src[77], src.size() - 77, 3, false, carry);
+	check(out == ref, "realign in two calls differs from one");
+}
+
+int main(int argc, char** argv) {
+	long seed = ( argc > 1 )? atol(argv[1]) : 1;
+	srand48(seed);
+	cout << "Random seed: " << seed << endl;
+
+	testBitOffsets();
+	testSplitBuffers();
+	testInverted();
+	testErrorThresholds();
+	testRealign();
+
+	cout << "AsmCorrelator: " << (failures? "FAILED" : "passed") << " (" << failures << " failures)" << endl;
+
+	return ( failures > 0 )? 1 : 0;
+}
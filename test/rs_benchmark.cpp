@@ -0,0 +1,435 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ * @file   rs_benchmark.cpp
+ * @author Tad Kollar
+ *
+ * $Id$
+ * Copyright (c) 2014.
+ *      NASA Glenn Research Center.  All rights reserved.
+ *      See COPYING file that comes with this distribution.
+ */
+//=============================================================================
+
+// Conformance checks and throughput measurements for RSEncoder/RSDecoder
+// with the CCSDS 131.0-B codes. Exits non-zero if any check fails.
+//
+// Usage: rs_benchmark [-n iterations] [-c] [-s seed] [-v vector_file]
+//   -n  Messages per timed case (default 2000).
+//   -c  Conformance checks only, no timing.
+//   -s  Seed for the random messages and errors (default: the time).
+//       The seed in use is printed so a failing run can be repeated.
+//   -v  Also check against reference vectors. Each non-blank line not
+//       starting with # holds: E I basis message_hex parity_hex
+//       where basis is "dual" or "conv" and the message is the full
+//       interleaved data field as transmitted.
+
+#include "RSEncoder.hpp"
+#include "RSDecoder.hpp"
+
+#include <ace/High_Res_Timer.h>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace nasaCE;
+using namespace std;
+
+const int ccsdsPoly = 0x187;
+const Sym ccsdsRootIdx = 11;
+const size_t codeLength = 255;
+
+int iterations = 2000;
+int failures = 0;
+
+/// First consecutive root for E=8 or E=16.
+Sym firstRoot(const size_t E) { return ( E == 8 )? 120 : 112; }
+
+// -- INDEPENDENT REFERENCE ---------------------------------------------------
+// Computed bit by bit from the field polynomial, without the coder's tables.
+
+Sym refMul(Sym a, Sym b) {
+	unsigned prod = 0, x = a;
+
+	for ( ; b; b >>= 1 ) {
+		if ( b & 1 ) prod ^= x;
+		x <<= 1;
+		if ( x & 0x100 ) x ^= ccsdsPoly;
+	}
+
+	return static_cast<Sym>(prod);
+}
+
+Sym refPow(Sym a, unsigned n) {
+	Sym r = 1;
+	while ( n-- ) r = refMul(r, a);
+	return r;
+}
+
+/// The generator polynomial, highest degree first.
+SymVec refGenerator(const size_t E) {
+	const Sym beta = refPow(2, ccsdsRootIdx);
+	SymVec gen(1, 1);
+
+	for ( size_t j = 0; j < 2 * E; ++j ) {
+		const Sym root = refPow(beta, firstRoot(E) + j);
+		SymVec next(gen.size() + 1, 0);
+
+		for ( size_t k = 0; k < gen.size(); ++k ) {
+			next[k] ^= gen[k];
+			next[k + 1] ^= refMul(gen[k], root);
+		}
+
+		gen = next;
+	}
+
+	return gen;
+}
+
+/// The CCSDS conventional-to-dual basis transformation matrix,
+/// expanded into lookup tables in both directions.
+struct RefDualBasis {
+	Sym toDual[256], toConv[256];
+
+	RefDualBasis() {
+		const Sym tal[] = { 0x8d, 0xef, 0xec, 0x86, 0xfa, 0x99, 0xaf, 0x7b };
+
+		for ( unsigned i = 0; i < 256; ++i ) {
+			Sym dual = 0;
+
+			for ( unsigned row = 0; row < 8; ++row )
+				if ( i & (1 << row) ) dual ^= tal[7 - row];
+
+			toDual[i] = dual;
+			toConv[dual] = i;
+		}
+	}
+};
+
+const RefDualBasis refBasis;
+
+/// Parity for an interleaved message by long division, one codeword at a time.
+/// Symbols are dealt out to the codewords from the end of the message, so a
+/// shortened message's virtual fill is at the front of each codeword.
+SymVec refParity(const SymVec& msg, const size_t E, const size_t depth, const bool dual) {
+	const SymVec gen = refGenerator(E);
+	const size_t dataPerWord = codeLength - 2 * E;
+	vector<SymVec> words(depth, SymVec(codeLength, 0));
+	SymVec parity(2 * E * depth, 0);
+
+	for ( size_t t = 0; t < msg.size(); ++t ) {
+		const Sym sym = msg[msg.size() - 1 - t];
+		words[depth - 1 - t % depth][dataPerWord - 1 - t / depth] = dual? refBasis.toConv[sym] : sym;
+	}
+
+	for ( size_t row = 0; row < depth; ++row ) {
+		SymVec& rem = words[row];
+
+		for ( size_t i = 0; i < dataPerWord; ++i ) {
+			const Sym coef = rem[i];
+			if ( coef ) for ( size_t k = 0; k < gen.size(); ++k ) rem[i + k] ^= refMul(gen[k], coef);
+		}
+
+		for ( size_t p = 0; p < 2 * E; ++p ) {
+			const Sym sym = rem[dataPerWord + p];
+			parity[p * depth + row] = dual? refBasis.toDual[sym] : sym;
+		}
+	}
+
+	return parity;
+}
+
+// -- KNOWN ANSWERS -----------------------------------------------------------
+
+/// The E=16 CCSDS generator polynomial as powers of alpha, highest degree first,
+/// as tabulated with the CCSDS encoder in Phil Karn's libfec (ccsds_tab.c).
+const unsigned ccsdsGenLogE16[] = {
+	0, 249,  59,  66,   4,  43, 126, 251,  97,  30,   3, 213,  50,  66, 170,   5,
+	24,   5, 170,  66,  50, 213,   3,  30,  97, 251, 126,  43,   4,  66,  59, 249,
+	0
+};
+
+/// Parity of the E=16, I=1, dual basis frame whose 223 message octets are 0, 1, ... 222.
+const Sym knownParityE16I1Dual[] = {
+	0x4f, 0xfb, 0x92, 0xdd, 0x55, 0x7e, 0xc6, 0x7f, 0x27, 0xfb, 0x89, 0x82, 0xcf, 0x58, 0xf8, 0xfd,
+	0x02, 0x8a, 0xd1, 0x17, 0xfc, 0xef, 0x6b, 0x27, 0x93, 0xd0, 0x41, 0x88, 0x26, 0x57, 0x86, 0x51
+};
+
+/// Parity of the E=8, I=2, conventional basis frame whose 478 message octets are 0, 1, ... 255, 0, 1, ...
+const Sym knownParityE8I2Conv[] = {
+	0xc1, 0xc0, 0x9f, 0x9e, 0x5f, 0x5e, 0x10, 0x11, 0x37, 0x36, 0xed, 0xec, 0xbf, 0xbe, 0xc5, 0xc4,
+	0x6d, 0x6c, 0x7a, 0x7b, 0xbc, 0xbd, 0x1b, 0x1a, 0x36, 0x37, 0x3a, 0x3b, 0x3b, 0x3a, 0x9c, 0x9d
+};
+
+// -- HELPERS -----------------------------------------------------------------
+
+void check(const bool ok, const string& what) {
+	if ( ok ) return;
+	++failures;
+	cout << "FAIL: " << what << endl;
+}
+
+string caseName(const size_t E, const size_t depth, const bool dual) {
+	ostringstream os;
+	os << "E=" << E << " I=" << depth << " " << (dual? "dual" : "conv");
+	return os.str();
+}
+
+SymVec randomMessage(const size_t len) {
+	SymVec msg(len);
+	for ( size_t i = 0; i < len; ++i ) msg[i] = lrand48() & 0xff;
+	return msg;
+}
+
+/// Corrupt errs distinct symbols in each codeword of an interleaved frame.
+void addErrors(Sym* frame, const size_t frameLen, const size_t depth, const size_t errs) {
+	for ( size_t row = 0; row < depth; ++row ) {
+		vector<bool> hit(frameLen / depth, false);
+
+		for ( size_t e = 0; e < errs; ) {
+			const size_t col = lrand48() % hit.size();
+			if ( hit[col] ) continue;
+			hit[col] = true;
+			frame[col * depth + row] ^= 1 + lrand48() % 255;
+			++e;
+		}
+	}
+}
+
+double elapsedSecs(const ACE_Time_Value& start) {
+	ACE_Time_Value elapsed = ACE_High_Res_Timer::gettimeofday_hr() - start;
+	ACE_UINT64 usec;
+	elapsed.to_usec(usec);
+	return ( usec > 0 )? usec / 1000000.0 : 0.000001;
+}
+
+// -- CONFORMANCE -------------------------------------------------------------
+
+void conformGenerator(const size_t E) {
+	RSEncoder encoder(ccsdsPoly, 2 * E, codeLength, 8, ccsdsRootIdx, firstRoot(E), 1, true);
+	const SymVec gen = encoder.getGeneratorPoly(), ref = refGenerator(E);
+
+	check(gen == ref, caseName(E, 1, true) + ": generator polynomial differs from reference");
+
+	// The CCSDS roots are symmetric about 128, which makes the generator palindromic.
+	bool symmetric = true;
+	for ( size_t k = 0; k < gen.size(); ++k ) symmetric = symmetric && ( gen[k] == gen[gen.size() - 1 - k] );
+	check(symmetric, caseName(E, 1, true) + ": generator polynomial is not symmetric");
+}
+
+void conformCase(const size_t E, const size_t depth, const bool dual) {
+	RSEncoder encoder(ccsdsPoly, 2 * E, codeLength, 8, ccsdsRootIdx, firstRoot(E), depth, dual);
+	RSDecoder decoder(ccsdsPoly, 2 * E, codeLength, 8, ccsdsRootIdx, firstRoot(E), depth, dual);
+	const string name = caseName(E, depth, dual);
+	const size_t maxMsg = encoder.getMaxMessageLength();
+
+	for ( int trial = 0; trial < 20; ++trial ) {
+		// Full frames, and shortened ones with virtual fill.
+		const size_t msgLen = ( trial < 10 )? maxMsg : 1 + lrand48() % maxMsg;
+		const SymVec msg = randomMessage(msgLen);
+		const SymVec ref = refParity(msg, E, depth, dual);
+
+		for ( int level = RSBase::SimdNone; level <= RSBase::detectSimdLevel(); ++level ) {
+			encoder.setSimdLevel(static_cast<RSBase::SimdLevel>(level));
+			check(encoder.encode(msg) == ref, name + ": parity differs from reference with " +
+				RSBase::simdLevelToStr(encoder.getSimdLevel()) + " kernels");
+		}
+
+		SymVec frame = msg;
+		frame.insert(frame.end(), ref.begin(), ref.end());
+
+		for ( int level = RSBase::SimdNone; level <= RSBase::detectSimdLevel(); ++level ) {
+			decoder.setSimdLevel(static_cast<RSBase::SimdLevel>(level));
+
+			SymVec clean = frame;
+			check(decoder.syndromesClear(&clean[0], clean.size()), name + ": clean frame has syndromes with " +
+				RSBase::simdLevelToStr(decoder.getSimdLevel()) + " kernels");
+
+			// Up to T errors in every codeword must be corrected exactly.
+			const size_t errs = lrand48() % (E + 1);
+			SymVec noisy = frame;
+			addErrors(&noisy[0], noisy.size(), depth, errs);
+
+			try {
+				if ( ! decoder.syndromesClear(&noisy[0], noisy.size()) )
+					decoder.correctInPlace(&noisy[0], noisy.size());
+				check(noisy == frame, name + ": correctable errors were not all corrected");
+			}
+			catch (std::exception& e) {
+				check(false, name + ": correctable frame rejected: " + e.what());
+			}
+		}
+
+		// The SymVec interface must agree with the in-place one.
+		try {
+			check(decoder.decode(frame) == msg, name + ": decode() did not return the message");
+		}
+		catch (std::exception& e) {
+			check(false, name + ": decode() rejected a clean frame: " + e.what());
+		}
+	}
+}
+
+void checkKnownParity(const size_t E, const size_t depth, const bool dual, const Sym* known) {
+	RSEncoder encoder(ccsdsPoly, 2 * E, codeLength, 8, ccsdsRootIdx, firstRoot(E), depth, dual);
+	const string name = caseName(E, depth, dual);
+	const SymVec expected(known, 2 * E * depth);
+	SymVec msg(encoder.getMaxMessageLength());
+
+	for ( size_t i = 0; i < msg.size(); ++i ) msg[i] = i & 0xff;
+
+	check(refParity(msg, E, depth, dual) == expected, name + ": reference parity differs from known answer");
+
+	for ( int level = RSBase::SimdNone; level <= RSBase::detectSimdLevel(); ++level ) {
+		encoder.setSimdLevel(static_cast<RSBase::SimdLevel>(level));
+		check(encoder.encode(msg) == expected, name + ": parity differs from known answer with " +
+			RSBase::simdLevelToStr(encoder.getSimdLevel()) + " kernels");
+	}
+}
+
+void conformKnownAnswers() {
+	SymVec known;
+	for ( size_t k = 0; k < sizeof(ccsdsGenLogE16) / sizeof(unsigned); ++k )
+		known.push_back(refPow(2, ccsdsGenLogE16[k]));
+
+	RSEncoder encoder(ccsdsPoly, 32, codeLength, 8, ccsdsRootIdx, firstRoot(16), 1, true);
+	check(refGenerator(16) == known, "E=16: reference generator polynomial differs from the published one");
+	check(encoder.getGeneratorPoly() == known, "E=16: generator polynomial differs from the published one");
+
+	checkKnownParity(16, 1, true, knownParityE16I1Dual);
+	checkKnownParity(8, 2, false, knownParityE8I2Conv);
+}
+
+void conformVectors(const char* path) {
+	ifstream in(path);
+	if ( ! in ) {
+		check(false, string("cannot read reference vectors from ") + path);
+		return;
+	}
+
+	string line;
+	int count = 0;
+
+	while ( getline(in, line) ) {
+		if ( line.empty() || line[0] == '#' ) continue;
+
+		istringstream is(line);
+		size_t E, depth;
+		string basis, msgHex, parityHex;
+
+		if ( ! (is >> E >> depth >> basis >> msgHex >> parityHex) || ( E != 8 && E != 16 ) ) {
+			check(false, "malformed reference vector: " + line);
+			continue;
+		}
+
+		SymVec msg, parity;
+		for ( size_t i = 0; i + 1 < msgHex.size(); i += 2 ) msg.push_back(strtol(msgHex.substr(i, 2).c_str(), 0, 16));
+		for ( size_t i = 0; i + 1 < parityHex.size(); i += 2 ) parity.push_back(strtol(parityHex.substr(i, 2).c_str(), 0, 16));
+
+		RSEncoder encoder(ccsdsPoly, 2 * E, codeLength, 8, ccsdsRootIdx, firstRoot(E), depth, basis == "dual");
+		check(encoder.encode(msg) == parity, caseName(E, depth, basis == "dual") + ": reference vector mismatch");
+		++count;
+	}
+
+	cout << "Checked " << count << " reference vectors from " << path << "." << endl;
+}
+
+// -- THROUGHPUT --------------------------------------------------------------
+
+void report(const string& what, const size_t octets, const size_t codewords, const double secs) {
+	cout << left << setw(40) << what << right << fixed << setprecision(1)
+		<< setw(10) << octets / secs / 1000000.0 << " MB/s"
+		<< setw(12) << setprecision(0) << codewords / secs << " codewords/s" << endl;
+}
+
+void benchCase(const size_t E, const size_t depth, const bool dual) {
+	RSEncoder encoder(ccsdsPoly, 2 * E, codeLength, 8, ccsdsRootIdx, firstRoot(E), depth, dual);
+	RSDecoder decoder(ccsdsPoly, 2 * E, codeLength, 8, ccsdsRootIdx, firstRoot(E), depth, dual);
+	const string name = caseName(E, depth, dual);
+	const size_t msgLen = encoder.getMaxMessageLength();
+	const size_t frameLen = msgLen + encoder.getTotalParityLength();
+
+	SymVec frame = randomMessage(msgLen);
+	frame.resize(frameLen);
+
+	ACE_Time_Value start = ACE_High_Res_Timer::gettimeofday_hr();
+	for ( int i = 0; i < iterations; ++i ) encoder.encodeInPlace(&frame[0], msgLen, &frame[msgLen]);
+	report(name + " encode", msgLen * iterations, depth * iterations, elapsedSecs(start));
+
+	const size_t errSteps[] = { 0, 1, E / 4, E / 2, (3 * E) / 4, E };
+	SymVec noisy(frameLen);
+
+	for ( size_t step = 0; step < sizeof(errSteps) / sizeof(size_t); ++step ) {
+		const size_t errs = errSteps[step];
+		if ( step > 0 && errs == errSteps[step - 1] ) continue;
+
+		// Fewer iterations with errors; correction is far slower than checking.
+		const int runs = ( errs == 0 )? iterations : std::max(1, iterations / 10);
+		double secs = 0;
+
+		for ( int i = 0; i < runs; ++i ) {
+			noisy = frame;
+			addErrors(&noisy[0], frameLen, depth, errs);
+
+			start = ACE_High_Res_Timer::gettimeofday_hr();
+			if ( ! decoder.syndromesClear(&noisy[0], frameLen) ) decoder.correctInPlace(&noisy[0], frameLen);
+			secs += elapsedSecs(start);
+		}
+
+		ostringstream what;
+		what << name << " decode, " << errs << " err/cw";
+		report(what.str(), msgLen * runs, depth * runs, secs);
+	}
+}
+
+int main(int argc, char** argv) {
+	bool conformOnly = false;
+	const char* vectorPath = 0;
+	long seed = time(0);
+
+	for ( int i = 1; i < argc; ++i ) {
+		const string arg(argv[i]);
+		if ( arg == "-n" && i + 1 < argc ) iterations = atoi(argv[++i]);
+		else if ( arg == "-c" ) conformOnly = true;
+		else if ( arg == "-s" && i + 1 < argc ) seed = atol(argv[++i]);
+		else if ( arg == "-v" && i + 1 < argc ) vectorPath = argv[++i];
+		else {
+			cerr << "Usage: " << argv[0] << " [-n iterations] [-c] [-s seed] [-v vector_file]" << endl;
+			return 2;
+		}
+	}
+
+	if ( iterations < 1 ) iterations = 1;
+
+	srand48(seed);
+
+	cout << "Random seed: " << seed << " (repeat with -s " << seed << ")" << endl;
+	cout << "GF kernels available: " << RSBase::simdLevelToStr(RSBase::detectSimdLevel()) << endl;
+
+	conformKnownAnswers();
+
+	for ( size_t E = 8; E <= 16; E += 8 ) {
+		conformGenerator(E);
+		for ( size_t depth = 1; depth <= 8; ++depth ) {
+			conformCase(E, depth, true);
+			conformCase(E, depth, false);
+		}
+	}
+
+	if ( vectorPath ) conformVectors(vectorPath);
+
+	cout << "Conformance: " << (failures? "FAILED" : "passed") << " (" << failures << " failures)" << endl;
+
+	if ( ! conformOnly ) {
+		for ( size_t E = 8; E <= 16; E += 8 )
+			for ( size_t depth = 1; depth <= 8; ++depth )
+				for ( int dual = 1; dual >= 0; --dual )
+					benchCase(E, depth, dual);
+	}
+
+	return ( failures > 0 )? 1 : 0;
+}